@@ -0,0 +1,347 @@
+/**
+ * @file DistanceMatrix.cpp
+ * @brief Implementation of the batched distance functions and their SIMD kernels.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "DistanceMatrix.h"
+#include "SpatialIndex.h"
+#include "ParallelFor.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DISTANCE_MATRIX_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// fdlibm's rational approximation asin(x) = x + x * R(x^2) for |x| < 0.5
+const double ASIN_P0 = 1.66666666666666657415e-01;
+const double ASIN_P1 = -3.25565818622400915405e-01;
+const double ASIN_P2 = 2.01212532134862925881e-01;
+const double ASIN_P3 = -4.00555345006794114027e-02;
+const double ASIN_P4 = 7.91534994289814532176e-04;
+const double ASIN_P5 = 3.47933107596021167570e-05;
+const double ASIN_Q1 = -2.40339491173441421878e+00;
+const double ASIN_Q2 = 2.02094576023350569471e+00;
+const double ASIN_Q3 = -6.88283971605453293030e-01;
+const double ASIN_Q4 = 7.70381505559019352791e-02;
+const double HALF_PI = 1.57079632679489661923;
+
+/**
+ * @brief The positions of some ZIP codes as unit-sphere points, one array per axis.
+ */
+struct UnitPoints
+{
+    vector<double> x; /**< x of each ZIP code (NaN if unknown) */
+    vector<double> y; /**< y of each ZIP code (NaN if unknown) */
+    vector<double> z; /**< z of each ZIP code (NaN if unknown) */
+};
+
+/**
+ * @brief Look up ZIP codes in a list and convert their positions to unit-sphere points.
+ * @param list The list that holds the positions.
+ * @param zips The ZIP codes.
+ * @return One point per ZIP code, in the same order.
+ */
+UnitPoints positionsOf(const PostalList &list, const vector<int> &zips)
+{
+    const double *latitudes = list.getColumns().latitudeData();
+    const double *longitudes = list.getColumns().longitudeData();
+    const double missing = numeric_limits<double>::quiet_NaN();
+    UnitPoints points;
+    points.x.resize(zips.size());
+    points.y.resize(zips.size());
+    points.z.resize(zips.size());
+
+    for (size_t i = 0; i < zips.size(); i++)
+    {
+        int index = list.findIndexByZip(zips[i]);
+        double point[3] = {missing, missing, missing};
+        if (index >= 0)
+        {
+            toUnitSphere(latitudes[index], longitudes[index], point);
+        }
+        points.x[i] = point[0];
+        points.y[i] = point[1];
+        points.z[i] = point[2];
+    }
+    return points;
+}
+
+/**
+ * @brief asin(h) for 0 <= h <= 1 with the same polynomial the vector kernels use.
+ */
+double asinPolynomial(double h)
+{
+    bool small = h < 0.5;
+    double z = small ? h * h : (1 - h) * 0.5;
+    double p = z * (ASIN_P0 + z * (ASIN_P1 + z * (ASIN_P2 + z * (ASIN_P3 + z * (ASIN_P4 + z * ASIN_P5)))));
+    double q = 1 + z * (ASIN_Q1 + z * (ASIN_Q2 + z * (ASIN_Q3 + z * ASIN_Q4)));
+    double r = p / q;
+    if (small)
+    {
+        return h + h * r;
+    }
+    double s = sqrt(z);
+    return HALF_PI - 2 * (s + s * r);
+}
+
+/**
+ * @brief Scalar kernel: out[i] = miles between point a (a[i] if aStep is 1, a[0] if 0) and b[i].
+ */
+void distanceKernelScalar(const double *ax, const double *ay, const double *az, size_t aStep,
+                          const double *bx, const double *by, const double *bz, double *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        double dx = ax[i * aStep] - bx[i];
+        double dy = ay[i * aStep] - by[i];
+        double dz = az[i * aStep] - bz[i];
+        double h = sqrt(dx * dx + dy * dy + dz * dz) * 0.5;
+        h = (h > 1) ? 1 : h; // rounding can push an antipodal chord past 2; NaN passes through
+        out[i] = 2 * EARTH_RADIUS_MILES * asinPolynomial(h);
+    }
+}
+
+#ifdef DISTANCE_MATRIX_X86
+
+/**
+ * @brief AVX2 kernel: 4 pairs per step. Same contract as distanceKernelScalar().
+ */
+__attribute__((target("avx2,fma"))) void distanceKernelAVX2(const double *ax, const double *ay, const double *az, size_t aStep,
+                                                              const double *bx, const double *by, const double *bz, double *out, size_t n)
+{
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d two = _mm256_set1_pd(2.0);
+    const __m256d halfPi = _mm256_set1_pd(HALF_PI);
+    const __m256d scale = _mm256_set1_pd(2 * EARTH_RADIUS_MILES);
+    const __m256d fixedX = _mm256_set1_pd(ax[0]);
+    const __m256d fixedY = _mm256_set1_pd(ay[0]);
+    const __m256d fixedZ = _mm256_set1_pd(az[0]);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d dx = _mm256_sub_pd(aStep ? _mm256_loadu_pd(ax + i) : fixedX, _mm256_loadu_pd(bx + i));
+        __m256d dy = _mm256_sub_pd(aStep ? _mm256_loadu_pd(ay + i) : fixedY, _mm256_loadu_pd(by + i));
+        __m256d dz = _mm256_sub_pd(aStep ? _mm256_loadu_pd(az + i) : fixedZ, _mm256_loadu_pd(bz + i));
+        __m256d squared = _mm256_fmadd_pd(dz, dz, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dx, dx)));
+
+        // min(one, h) returns h when h is NaN, so unknown ZIP codes stay NaN
+        __m256d h = _mm256_min_pd(one, _mm256_mul_pd(_mm256_sqrt_pd(squared), half));
+        __m256d small = _mm256_cmp_pd(h, half, _CMP_LT_OQ);
+        __m256d zBig = _mm256_mul_pd(_mm256_sub_pd(one, h), half);
+        __m256d z = _mm256_blendv_pd(zBig, _mm256_mul_pd(h, h), small);
+
+        __m256d p = _mm256_fmadd_pd(z, _mm256_set1_pd(ASIN_P5), _mm256_set1_pd(ASIN_P4));
+        p = _mm256_fmadd_pd(z, p, _mm256_set1_pd(ASIN_P3));
+        p = _mm256_fmadd_pd(z, p, _mm256_set1_pd(ASIN_P2));
+        p = _mm256_fmadd_pd(z, p, _mm256_set1_pd(ASIN_P1));
+        p = _mm256_fmadd_pd(z, p, _mm256_set1_pd(ASIN_P0));
+        p = _mm256_mul_pd(z, p);
+        __m256d q = _mm256_fmadd_pd(z, _mm256_set1_pd(ASIN_Q4), _mm256_set1_pd(ASIN_Q3));
+        q = _mm256_fmadd_pd(z, q, _mm256_set1_pd(ASIN_Q2));
+        q = _mm256_fmadd_pd(z, q, _mm256_set1_pd(ASIN_Q1));
+        q = _mm256_fmadd_pd(z, q, one);
+        __m256d r = _mm256_div_pd(p, q);
+
+        __m256d s = _mm256_sqrt_pd(zBig);
+        __m256d smallResult = _mm256_fmadd_pd(h, r, h);
+        __m256d bigResult = _mm256_sub_pd(halfPi, _mm256_mul_pd(two, _mm256_fmadd_pd(s, r, s)));
+        __m256d angle = _mm256_blendv_pd(bigResult, smallResult, small);
+        _mm256_storeu_pd(out + i, _mm256_mul_pd(angle, scale));
+    }
+    distanceKernelScalar(ax + i * aStep, ay + i * aStep, az + i * aStep, aStep, bx + i, by + i, bz + i, out + i, n - i);
+}
+
+// GCC 12's AVX-512 headers trip a false -Wmaybe-uninitialized (GCC bug 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+/**
+ * @brief AVX-512 kernel: 8 pairs per step. Same contract as distanceKernelScalar().
+ */
+__attribute__((target("avx512f"))) void distanceKernelAVX512(const double *ax, const double *ay, const double *az, size_t aStep,
+                                                               const double *bx, const double *by, const double *bz, double *out, size_t n)
+{
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d two = _mm512_set1_pd(2.0);
+    const __m512d halfPi = _mm512_set1_pd(HALF_PI);
+    const __m512d scale = _mm512_set1_pd(2 * EARTH_RADIUS_MILES);
+    const __m512d fixedX = _mm512_set1_pd(ax[0]);
+    const __m512d fixedY = _mm512_set1_pd(ay[0]);
+    const __m512d fixedZ = _mm512_set1_pd(az[0]);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        __m512d dx = _mm512_sub_pd(aStep ? _mm512_loadu_pd(ax + i) : fixedX, _mm512_loadu_pd(bx + i));
+        __m512d dy = _mm512_sub_pd(aStep ? _mm512_loadu_pd(ay + i) : fixedY, _mm512_loadu_pd(by + i));
+        __m512d dz = _mm512_sub_pd(aStep ? _mm512_loadu_pd(az + i) : fixedZ, _mm512_loadu_pd(bz + i));
+        __m512d squared = _mm512_fmadd_pd(dz, dz, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dx, dx)));
+
+        __m512d h = _mm512_min_pd(one, _mm512_mul_pd(_mm512_sqrt_pd(squared), half));
+        __mmask8 small = _mm512_cmp_pd_mask(h, half, _CMP_LT_OQ);
+        __m512d zBig = _mm512_mul_pd(_mm512_sub_pd(one, h), half);
+        __m512d z = _mm512_mask_blend_pd(small, zBig, _mm512_mul_pd(h, h));
+
+        __m512d p = _mm512_fmadd_pd(z, _mm512_set1_pd(ASIN_P5), _mm512_set1_pd(ASIN_P4));
+        p = _mm512_fmadd_pd(z, p, _mm512_set1_pd(ASIN_P3));
+        p = _mm512_fmadd_pd(z, p, _mm512_set1_pd(ASIN_P2));
+        p = _mm512_fmadd_pd(z, p, _mm512_set1_pd(ASIN_P1));
+        p = _mm512_fmadd_pd(z, p, _mm512_set1_pd(ASIN_P0));
+        p = _mm512_mul_pd(z, p);
+        __m512d q = _mm512_fmadd_pd(z, _mm512_set1_pd(ASIN_Q4), _mm512_set1_pd(ASIN_Q3));
+        q = _mm512_fmadd_pd(z, q, _mm512_set1_pd(ASIN_Q2));
+        q = _mm512_fmadd_pd(z, q, _mm512_set1_pd(ASIN_Q1));
+        q = _mm512_fmadd_pd(z, q, one);
+        __m512d r = _mm512_div_pd(p, q);
+
+        __m512d s = _mm512_sqrt_pd(zBig);
+        __m512d smallResult = _mm512_fmadd_pd(h, r, h);
+        __m512d bigResult = _mm512_sub_pd(halfPi, _mm512_mul_pd(two, _mm512_fmadd_pd(s, r, s)));
+        __m512d angle = _mm512_mask_blend_pd(small, bigResult, smallResult);
+        _mm512_storeu_pd(out + i, _mm512_mul_pd(angle, scale));
+    }
+    distanceKernelScalar(ax + i * aStep, ay + i * aStep, az + i * aStep, aStep, bx + i, by + i, bz + i, out + i, n - i);
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+/**
+ * @brief Pick the fastest distance kernel this CPU supports.
+ * @return The path the distance functions use by default.
+ */
+DistancePath bestDistancePath()
+{
+#ifdef DISTANCE_MATRIX_X86
+    static const DistancePath best = __builtin_cpu_supports("avx512f")                                   ? DistancePath::AVX512
+                                     : (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? DistancePath::AVX2
+                                                                                                         : DistancePath::Scalar;
+    return best;
+#else
+    return DistancePath::Scalar;
+#endif
+}
+
+/**
+ * @brief Get a printable name for a distance kernel.
+ * @param path The path.
+ * @return "scalar", "avx2" or "avx512".
+ */
+const char *distancePathName(DistancePath path)
+{
+    switch (path)
+    {
+    case DistancePath::AVX2:
+        return "avx2";
+    case DistancePath::AVX512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief Run the chosen kernel, falling back to one the CPU supports.
+ */
+void distanceKernel(DistancePath path, const double *ax, const double *ay, const double *az, size_t aStep,
+                    const double *bx, const double *by, const double *bz, double *out, size_t n)
+{
+#ifdef DISTANCE_MATRIX_X86
+    DistancePath best = bestDistancePath();
+    if (path == DistancePath::AVX512 && best == DistancePath::AVX512)
+    {
+        distanceKernelAVX512(ax, ay, az, aStep, bx, by, bz, out, n);
+        return;
+    }
+    if (path != DistancePath::Scalar && best != DistancePath::Scalar)
+    {
+        distanceKernelAVX2(ax, ay, az, aStep, bx, by, bz, out, n);
+        return;
+    }
+#endif
+    distanceKernelScalar(ax, ay, az, aStep, bx, by, bz, out, n);
+}
+
+/**
+ * @brief Distances from every origin ZIP to every destination ZIP.
+ * @param list         The list that holds the ZIP codes' positions.
+ * @param origins      Origin ZIP codes (the rows).
+ * @param destinations Destination ZIP codes (the columns).
+ * @param threadCount  Worker threads for large matrices (0 = one per hardware thread).
+ * @param path         Which kernel to use.
+ * @return The distances in miles, row by row.
+ */
+vector<double> distanceMatrix(const PostalList &list, const vector<int> &origins, const vector<int> &destinations,
+                              unsigned threadCount, DistancePath path)
+{
+    UnitPoints from = positionsOf(list, origins);
+    UnitPoints to = positionsOf(list, destinations);
+    size_t columns = destinations.size();
+    vector<double> distances(origins.size() * columns);
+
+    // Small matrices are not worth starting threads for
+    const size_t rowsPerTask = 16;
+    size_t tasks = (origins.size() + rowsPerTask - 1) / rowsPerTask;
+    unsigned threads = (distances.size() < (1u << 16)) ? 1 : threadCount;
+
+    parallelFor(tasks, threads, [&](size_t task)
+                {
+                    size_t last = min(origins.size(), (task + 1) * rowsPerTask);
+                    for (size_t row = task * rowsPerTask; row < last; row++)
+                    {
+                        distanceKernel(path, &from.x[row], &from.y[row], &from.z[row], 0,
+                                       to.x.data(), to.y.data(), to.z.data(), distances.data() + row * columns, columns);
+                    }
+                });
+    return distances;
+}
+
+/**
+ * @brief Distance of each (origins[i], destinations[i]) pair.
+ * @param list         The list that holds the ZIP codes' positions.
+ * @param origins      First ZIP code of each pair.
+ * @param destinations Second ZIP code of each pair.
+ * @param threadCount  Worker threads for long lists (0 = one per hardware thread).
+ * @param path         Which kernel to use.
+ * @return One distance in miles per pair.
+ */
+vector<double> pairDistances(const PostalList &list, const vector<int> &origins, const vector<int> &destinations,
+                             unsigned threadCount, DistancePath path)
+{
+    if (origins.size() != destinations.size())
+    {
+        throw invalid_argument("Origin and destination lists differ in length in pairDistances");
+    }
+
+    UnitPoints from = positionsOf(list, origins);
+    UnitPoints to = positionsOf(list, destinations);
+    vector<double> distances(origins.size());
+
+    const size_t pairsPerTask = 16384;
+    size_t tasks = (origins.size() + pairsPerTask - 1) / pairsPerTask;
+    parallelFor(tasks, threadCount, [&](size_t task)
+                {
+                    size_t first = task * pairsPerTask;
+                    size_t count = min(pairsPerTask, origins.size() - first);
+                    distanceKernel(path, &from.x[first], &from.y[first], &from.z[first], 1,
+                                   &to.x[first], &to.y[first], &to.z[first], &distances[first], count);
+                });
+    return distances;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file DistanceMatrix.h
+ * @brief Declares batched great-circle distance functions for sets of ZIP codes.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Pricing needs the distance between every origin and every destination ZIP.
+ * Each ZIP's position is converted once to a point on the unit sphere; the
+ * distance of a pair is then 2R * asin(chord / 2), where the chord is the
+ * straight line between the two points. The chord needs only multiplies and
+ * adds, and asin is a fixed polynomial (the fdlibm one), so 4 (AVX2) or 8
+ * (AVX-512) pairs are done per instruction. Large matrices are split by rows
+ * over several threads.
+ *
+ * Accuracy: against the double-precision haversine in greatCircleMiles(),
+ * every path agrees to within 1e-11 miles on the benchmark's 1000 x 1000
+ * sample of the data set (relative error below 1e-12); the benchmark
+ * re-checks this each run.
+ */
+
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include <vector>
+#include "PostalList.h"
+
+using namespace std;
+
+/**
+ * @brief The distance kernel implementations.
+ */
+enum class DistancePath
+{
+    Scalar, /**< One pair at a time (works everywhere) */
+    AVX2,   /**< 4 pairs per step (needs AVX2 and FMA, checked at run time) */
+    AVX512  /**< 8 pairs per step (needs AVX-512F, checked at run time) */
+};
+
+/**
+ * @brief Pick the fastest distance kernel this CPU supports.
+ * @return The path the distance functions use by default.
+ */
+DistancePath bestDistancePath();
+
+/**
+ * @brief Get a printable name for a distance kernel.
+ * @param path The path.
+ * @return "scalar", "avx2" or "avx512".
+ */
+const char *distancePathName(DistancePath path);
+
+/**
+ * @brief Distances from every origin ZIP to every destination ZIP.
+ * @param list         The list that holds the ZIP codes' positions.
+ * @param origins      Origin ZIP codes (the rows).
+ * @param destinations Destination ZIP codes (the columns).
+ * @param threadCount  Worker threads for large matrices (0 = one per hardware thread).
+ * @param path         Which kernel to use.
+ * @return origins.size() * destinations.size() distances in miles, row by row:
+ * the distance from origins[i] to destinations[j] is at i * destinations.size() + j.
+ * @note A ZIP code that is not in the list gives NaN in its row or column.
+ */
+vector<double> distanceMatrix(const PostalList &list, const vector<int> &origins, const vector<int> &destinations,
+                              unsigned threadCount = 0, DistancePath path = bestDistancePath());
+
+/**
+ * @brief Distance of each (origins[i], destinations[i]) pair.
+ * @param list         The list that holds the ZIP codes' positions.
+ * @param origins      First ZIP code of each pair.
+ * @param destinations Second ZIP code of each pair (same length as @p origins).
+ * @param threadCount  Worker threads for long lists (0 = one per hardware thread).
+ * @param path         Which kernel to use.
+ * @return One distance in miles per pair; NaN where a ZIP code is not in the list.
+ * @throws invalid_argument if the two lists differ in length.
+ */
+vector<double> pairDistances(const PostalList &list, const vector<int> &origins, const vector<int> &destinations,
+                             unsigned threadCount = 0, DistancePath path = bestDistancePath());
+
+#include "DistanceMatrix.cpp"
+#endif
@@ -0,0 +1,375 @@
+/**
+ * @file FieldScanner.cpp
+ * @brief Implementation of the delimiter scanner, number parsers and RecordTokenizer.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "FieldScanner.h"
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define FIELD_SCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Scalar scanner: test one byte at a time.
+ * @param block  The bytes to scan.
+ * @param length How many bytes to scan.
+ * @param marks  Receives the delimiter offsets.
+ * @param count  Number of marks already written (the vector paths finish their tail here).
+ * @param start  First offset to look at.
+ * @return The new number of marks.
+ */
+size_t scanDelimitersScalar(const char *block, size_t length, uint32_t *marks, size_t count, size_t start)
+{
+    for (size_t i = start; i < length; i++)
+    {
+        if (block[i] == ',' || block[i] == '\n')
+        {
+            marks[count++] = static_cast<uint32_t>(i);
+        }
+    }
+    return count;
+}
+
+#ifdef FIELD_SCANNER_X86
+
+/**
+ * @brief SSE2 scanner: compare 16 bytes per step and turn the matches into a bit mask.
+ */
+size_t scanDelimitersSSE2(const char *block, size_t length, uint32_t *marks)
+{
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+        while (mask != 0)
+        {
+            marks[count++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    return scanDelimitersScalar(block, length, marks, count, i);
+}
+
+/**
+ * @brief AVX2 scanner: compare 32 bytes per step. Only called when the CPU has AVX2.
+ */
+__attribute__((target("avx2"))) size_t scanDelimitersAVX2(const char *block, size_t length, uint32_t *marks)
+{
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, comma), _mm256_cmpeq_epi8(bytes, newline));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+        while (mask != 0)
+        {
+            marks[count++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    return scanDelimitersScalar(block, length, marks, count, i);
+}
+
+#endif
+
+/**
+ * @brief Pick the fastest scanning path this CPU supports.
+ * @return The path scanDelimiters() uses by default.
+ */
+ScanPath bestScanPath()
+{
+#ifdef FIELD_SCANNER_X86
+    static const ScanPath best = __builtin_cpu_supports("avx2") ? ScanPath::AVX2 : ScanPath::SSE2;
+    return best;
+#else
+    return ScanPath::Scalar;
+#endif
+}
+
+/**
+ * @brief Get a printable name for a scanning path.
+ * @param path The path.
+ * @return "scalar", "sse2" or "avx2".
+ */
+const char *scanPathName(ScanPath path)
+{
+    switch (path)
+    {
+    case ScanPath::SSE2:
+        return "sse2";
+    case ScanPath::AVX2:
+        return "avx2";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * @brief Record the offset of every ',' and '\n' in a block.
+ * @param block  The bytes to scan.
+ * @param length How many bytes to scan.
+ * @param marks  Receives the offsets in ascending order.
+ * @param path   Which implementation to use.
+ * @return How many offsets were written.
+ */
+size_t scanDelimiters(const char *block, size_t length, uint32_t *marks, ScanPath path)
+{
+#ifdef FIELD_SCANNER_X86
+    if (path == ScanPath::AVX2 && bestScanPath() == ScanPath::AVX2)
+    {
+        return scanDelimitersAVX2(block, length, marks);
+    }
+    if (path != ScanPath::Scalar)
+    {
+        return scanDelimitersSSE2(block, length, marks);
+    }
+#endif
+    return scanDelimitersScalar(block, length, marks, 0, 0);
+}
+
+/**
+ * @brief Parse a whole field as an integer.
+ * @param field The field text.
+ * @param value Receives the number.
+ * @return true if the entire field was a valid integer.
+ */
+bool parseInteger(string_view field, int &value)
+{
+    const char *end = field.data() + field.size();
+    from_chars_result result = from_chars(field.data(), end, value);
+    return result.ec == errc() && result.ptr == end;
+}
+
+/**
+ * @brief Slow path of parseDecimal() for inputs the direct conversion does not handle.
+ */
+bool parseDecimalFallback(string_view field, double &value)
+{
+#if defined(__cpp_lib_to_chars)
+    const char *first = field.data();
+    const char *end = first + field.size();
+    if (first != end && *first == '+')
+    {
+        first++; // strtod accepts a leading '+', from_chars does not
+    }
+    from_chars_result result = from_chars(first, end, value);
+    return result.ec == errc() && result.ptr == end;
+#else
+    char buffer[64];
+    if (field.size() >= sizeof(buffer))
+    {
+        return false;
+    }
+    memcpy(buffer, field.data(), field.size());
+    buffer[field.size()] = '\0';
+
+    char *stop = nullptr;
+    value = strtod(buffer, &stop);
+    return stop == buffer + field.size();
+#endif
+}
+
+/**
+ * @brief Parse a whole field as a double.
+ * @param field The field text.
+ * @param value Receives the number.
+ * @return true if the entire field was a valid number.
+ */
+bool parseDecimal(string_view field, double &value)
+{
+    // Every power of ten up to 1e15 is exact in a double
+    static const double powersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                         1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+    const char *p = field.data();
+    const char *end = p + field.size();
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool seenPoint = false;
+
+    for (; p != end; p++)
+    {
+        if (*p >= '0' && *p <= '9')
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits++;
+            fractionDigits += seenPoint;
+        }
+        else if (*p == '.' && !seenPoint)
+        {
+            seenPoint = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    // 15 digits always fit in the 53-bit mantissa, so the integer is exact
+    if (p != end || digits == 0 || digits > 15)
+    {
+        return parseDecimalFallback(field, value);
+    }
+
+    value = static_cast<double>(mantissa) / powersOfTen[fractionDigits];
+    if (negative)
+    {
+        value = -value;
+    }
+    return true;
+}
+
+/**
+ * @brief Prepare to split the lines in [begin, end) of @p data.
+ * @param data  The bytes (usually a mapped file).
+ * @param begin Offset of the first line.
+ * @param end   Offset one past the last byte to split.
+ * @param path  Which scanner implementation to use.
+ */
+RecordTokenizer::RecordTokenizer(const char *data, size_t begin, size_t end, ScanPath path)
+{
+    this->data = data;
+    this->position = begin;
+    this->end = end;
+    this->path = path;
+    blockStart = begin;
+    blockEnd = begin;
+    markCount = 0;
+    markIndex = 0;
+    blockSize = 64 * 1024;
+    markCapacity = 0;
+}
+
+/**
+ * @brief Scan the next block, starting at the current record.
+ */
+void RecordTokenizer::refill()
+{
+    // If the last block did not hold one whole record, the record is longer
+    // than a block: double the block until it fits
+    if (blockStart == position && blockEnd > blockStart)
+    {
+        blockSize *= 2;
+    }
+
+    blockStart = position;
+    blockEnd = min(end, blockStart + blockSize);
+    if (markCapacity < blockSize)
+    {
+        marks.reset(new uint32_t[blockSize]);
+        markCapacity = blockSize;
+    }
+    markCount = scanDelimiters(data + blockStart, blockEnd - blockStart, marks.get(), path);
+    markIndex = 0;
+}
+
+/**
+ * @brief Split the next non-blank line into fields.
+ * @param fields     Receives up to @p maxFields field views.
+ * @param maxFields  Size of @p fields.
+ * @param fieldCount Receives how many fields the line really had.
+ * @return false once the range is used up.
+ */
+bool RecordTokenizer::next(string_view fields[], int maxFields, int &fieldCount)
+{
+    while (position < end)
+    {
+        // Walk the marks of the current block until one ends the line
+        size_t fieldStart = position;
+        size_t lineEnd = end;
+        bool complete = false;
+        fieldCount = 0;
+
+        for (size_t i = markIndex; i < markCount; i++)
+        {
+            size_t at = blockStart + marks[i];
+            if (at < position)
+            {
+                continue;
+            }
+            if (fieldCount < maxFields)
+            {
+                fields[fieldCount] = string_view(data + fieldStart, at - fieldStart);
+            }
+            fieldCount++;
+            fieldStart = at + 1;
+
+            if (data[at] == '\n')
+            {
+                lineEnd = at;
+                markIndex = i + 1;
+                complete = true;
+                break;
+            }
+        }
+
+        if (!complete)
+        {
+            if (blockEnd < end)
+            {
+                refill();
+                continue;
+            }
+            // Last line of the range without a newline
+            if (fieldCount < maxFields)
+            {
+                fields[fieldCount] = string_view(data + fieldStart, end - fieldStart);
+            }
+            fieldCount++;
+            markIndex = markCount;
+        }
+
+        size_t lineStart = position;
+        position = complete ? lineEnd + 1 : end;
+
+        // Drop the '\r' of a "\r\n" line end from the last field
+        int last = min(fieldCount, maxFields) - 1;
+        size_t contentEnd = complete ? lineEnd : end;
+        if (contentEnd > lineStart && data[contentEnd - 1] == '\r' && fieldCount <= maxFields)
+        {
+            fields[last] = fields[last].substr(0, fields[last].size() - 1);
+            contentEnd--;
+        }
+
+        if (contentEnd > lineStart)
+        {
+            return true;
+        }
+        // Blank line: keep going
+    }
+    fieldCount = 0;
+    return false;
+}
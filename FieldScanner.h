@@ -0,0 +1,133 @@
+/**
+ * @file FieldScanner.h
+ * @brief Declares the vectorized delimiter scanner and the record tokenizer.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The CSV loader and the index builder both split lines at commas. Instead of
+ * searching for one comma at a time, scanDelimiters() compares 16 (SSE2) or
+ * 32 (AVX2) bytes at once and records the offset of every comma and newline
+ * in the block. RecordTokenizer walks those offsets to hand out one record's
+ * fields at a time. The number parsers replace stoi/stod, which need a
+ * temporary string and consult the locale.
+ */
+
+#ifndef FIELD_SCANNER_H
+#define FIELD_SCANNER_H
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+/**
+ * @brief The delimiter scanning implementations.
+ */
+enum class ScanPath
+{
+    Scalar, /**< One byte at a time (works everywhere) */
+    SSE2,   /**< 16 bytes per step (any x86-64 CPU) */
+    AVX2    /**< 32 bytes per step (checked at run time) */
+};
+
+/**
+ * @brief Pick the fastest scanning path this CPU supports.
+ * @return The path scanDelimiters() uses by default.
+ */
+ScanPath bestScanPath();
+
+/**
+ * @brief Get a printable name for a scanning path.
+ * @param path The path.
+ * @return "scalar", "sse2" or "avx2".
+ */
+const char *scanPathName(ScanPath path);
+
+/**
+ * @brief Record the offset of every ',' and '\n' in a block.
+ * @param block  The bytes to scan.
+ * @param length How many bytes to scan (at most 4 GiB).
+ * @param marks  Receives the offsets in ascending order; needs room for @p length entries.
+ * @param path   Which implementation to use. A path the CPU lacks falls back to a supported one.
+ * @return How many offsets were written.
+ */
+size_t scanDelimiters(const char *block, size_t length, uint32_t *marks, ScanPath path = bestScanPath());
+
+/**
+ * @brief Parse a whole field as an integer.
+ * @param field The field text.
+ * @param value Receives the number.
+ * @return true if the entire field was a valid integer.
+ */
+bool parseInteger(string_view field, int &value);
+
+/**
+ * @brief Parse a whole field as a double.
+ *
+ * Plain decimals such as "-73.0451" (up to 15 significant digits) are
+ * converted directly: the digits form an exact integer and dividing it by an
+ * exact power of ten rounds correctly, so the result equals strtod's.
+ * Anything else (exponents, very long mantissas) goes through from_chars, or
+ * strtod where the library has no floating-point from_chars.
+ *
+ * @param field The field text.
+ * @param value Receives the number.
+ * @return true if the entire field was a valid number.
+ */
+bool parseDecimal(string_view field, double &value);
+
+/**
+ * @brief Splits a range of lines into comma-separated fields.
+ *
+ * The range is scanned in blocks with scanDelimiters(); a record that crosses
+ * the end of a block is scanned again at the start of the next one. Fields
+ * are views into the original bytes, so they are valid as long as those are.
+ */
+class RecordTokenizer
+{
+private:
+    const char *data;             /**< Start of the bytes being split */
+    size_t position;              /**< Offset of the next record */
+    size_t end;                   /**< Offset to stop at */
+    size_t blockStart;            /**< Offset the current marks are relative to */
+    size_t blockEnd;              /**< One past the last scanned byte */
+    size_t markCount;             /**< Marks found in the current block */
+    size_t markIndex;             /**< Next unread mark */
+    size_t blockSize;             /**< Bytes scanned per block */
+    size_t markCapacity;          /**< Entries allocated in marks */
+    ScanPath path;                /**< Scanner implementation */
+    unique_ptr<uint32_t[]> marks; /**< Delimiter offsets in the current block */
+
+    /**
+     * @brief Scan the next block, starting at the current record.
+     */
+    void refill();
+
+public:
+    /**
+     * @brief Prepare to split the lines in [begin, end) of @p data.
+     * @param data  The bytes (usually a mapped file).
+     * @param begin Offset of the first line.
+     * @param end   Offset one past the last byte to split.
+     * @param path  Which scanner implementation to use.
+     */
+    RecordTokenizer(const char *data, size_t begin, size_t end, ScanPath path = bestScanPath());
+
+    /**
+     * @brief Split the next non-blank line into fields.
+     * @param fields     Receives up to @p maxFields field views (the '\r' of "\r\n" is dropped).
+     * @param maxFields  Size of @p fields.
+     * @param fieldCount Receives how many fields the line really had (may exceed @p maxFields).
+     * @return false once the range is used up.
+     * @note fields[0].data() is where the line starts in the original bytes.
+     */
+    bool next(string_view fields[], int maxFields, int &fieldCount);
+};
+
+#include "FieldScanner.cpp"
+#endif
@@ -0,0 +1,284 @@
+/**
+ * @file FuzzyIndex.cpp
+ * @brief Implementation of the FuzzyIndex class and the bounded edit distance.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "FuzzyIndex.h"
+#include "PlaceIndex.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+/**
+ * @brief Myers/Hyyrö edit distance for a pattern of 1 to 64 bytes.
+ * @param peq   Bit i of peq[c] is set when pattern[i] == c.
+ * @param m     The pattern length.
+ * @param text  The text; letters are lower-cased as they are read.
+ * @param limit The largest distance of interest.
+ * @return The distance, or limit + 1 if it is larger.
+ */
+int myersDistance(const uint64_t *peq, int m, string_view text, int limit)
+{
+    // Bit i of pv/mv says whether the table goes up/down by one from row i to
+    // row i + 1 in the current column; the last row is tracked in score
+    const int n = static_cast<int>(text.size());
+    const uint64_t last = uint64_t(1) << (m - 1);
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+    int score = m;
+    for (int j = 0; j < n; j++)
+    {
+        uint64_t eq = peq[foldByte(text[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last)
+        {
+            score++;
+        }
+        else if (mh & last)
+        {
+            score--;
+        }
+        // Shifting a 1 into ph makes row 0 count up (0, 1, 2, ...): a whole-string match
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Each remaining letter can lower the score by at most one
+        if (score - (n - j - 1) > limit)
+        {
+            return limit + 1;
+        }
+    }
+    return score <= limit ? score : limit + 1;
+}
+
+/**
+ * @brief Get the edit distance between two strings if it is small.
+ * @param pattern The first string, already lower-cased.
+ * @param text    The second string; letters are lower-cased as they are read.
+ * @param limit   The largest distance of interest.
+ * @return The Levenshtein distance, or limit + 1 if it is larger than @p limit.
+ */
+int boundedEditDistance(string_view pattern, string_view text, int limit)
+{
+    const int m = static_cast<int>(pattern.size());
+    const int n = static_cast<int>(text.size());
+    if (abs(m - n) > limit)
+    {
+        return limit + 1;
+    }
+    if (m == 0)
+    {
+        return n;
+    }
+
+    if (m <= 64)
+    {
+        uint64_t peq[256] = {};
+        for (int i = 0; i < m; i++)
+        {
+            peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+        }
+        return myersDistance(peq, m, text, limit);
+    }
+
+    // Longer patterns: the textbook table, two rows at a time
+    vector<int> previous(m + 1);
+    vector<int> current(m + 1);
+    for (int i = 0; i <= m; i++)
+    {
+        previous[i] = i;
+    }
+    for (int j = 1; j <= n; j++)
+    {
+        current[0] = j;
+        int best = j;
+        unsigned char c = foldByte(text[j - 1]);
+        for (int i = 1; i <= m; i++)
+        {
+            int change = previous[i - 1] + (static_cast<unsigned char>(pattern[i - 1]) != c);
+            current[i] = min(change, min(previous[i], current[i - 1]) + 1);
+            best = min(best, current[i]);
+        }
+        if (best > limit)
+        {
+            return limit + 1;
+        }
+        swap(previous, current);
+    }
+    return previous[m] <= limit ? previous[m] : limit + 1;
+}
+
+/**
+ * @brief Get the distinct trigrams of a lower-cased name, padded as "$name$".
+ */
+void nameTrigrams(string_view folded, vector<uint32_t> &out)
+{
+    out.clear();
+    string padded;
+    padded.reserve(folded.size() + 2);
+    padded += '$';
+    padded += folded;
+    padded += '$';
+    for (size_t i = 0; i + 3 <= padded.size(); i++)
+    {
+        out.push_back(static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16 |
+                      static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8 |
+                      static_cast<unsigned char>(padded[i + 2]));
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+/**
+ * @brief Create an empty index.
+ */
+FuzzyIndex::FuzzyIndex()
+{
+    offsets.push_back(0);
+}
+
+/**
+ * @brief Add the next name.
+ * @param name The name; it gets id size() (before the call).
+ */
+void FuzzyIndex::add(string_view name)
+{
+    uint32_t id = static_cast<uint32_t>(size());
+    size_t start = pool.size();
+    for (char c : name)
+    {
+        pool += static_cast<char>(foldByte(c));
+    }
+    offsets.push_back(static_cast<uint32_t>(pool.size()));
+
+    vector<uint32_t> trigrams;
+    nameTrigrams(string_view(pool).substr(start), trigrams);
+    uint32_t length = static_cast<uint32_t>(min<size_t>(pool.size() - start, 255)) << 24;
+    for (uint32_t gram : trigrams)
+    {
+        grams[gram | length].push_back(id);
+    }
+}
+
+/**
+ * @brief Find the names within some edits of a query.
+ * @param query       The text to look for; case does not matter.
+ * @param maxDistance The most edits allowed.
+ * @param out         Receives the matches, closest first and then by id.
+ */
+void FuzzyIndex::search(string_view query, int maxDistance, vector<FuzzyNameMatch> &out) const
+{
+    out.clear();
+    string folded;
+    folded.reserve(query.size());
+    for (char c : query)
+    {
+        folded += static_cast<char>(foldByte(c));
+    }
+    vector<uint32_t> trigrams;
+    nameTrigrams(folded, trigrams);
+    int needed = max(1, static_cast<int>(trigrams.size()) - 3 * maxDistance);
+
+    // Count shared trigrams per name; each thread keeps its own counters,
+    // zeroed again after use, so a search allocates nothing once warmed up
+    thread_local vector<uint16_t> counts;
+    thread_local vector<uint32_t> touched;
+    if (counts.size() < size())
+    {
+        counts.resize(size());
+    }
+    touched.clear();
+    int shortest = max(0, static_cast<int>(folded.size()) - maxDistance);
+    int longest = min(255, static_cast<int>(folded.size()) + maxDistance);
+    for (uint32_t gram : trigrams)
+    {
+        for (int length = shortest; length <= longest; length++)
+        {
+            auto found = grams.find(gram | static_cast<uint32_t>(length) << 24);
+            if (found == grams.end())
+            {
+                continue;
+            }
+            for (uint32_t id : found->second)
+            {
+                if (counts[id]++ == 0)
+                {
+                    touched.push_back(id);
+                }
+            }
+        }
+    }
+
+    // The query's match table is built once and shared by every candidate
+    const int m = static_cast<int>(folded.size());
+    uint64_t peq[256] = {};
+    for (int i = 0; i < m && m <= 64; i++)
+    {
+        peq[static_cast<unsigned char>(folded[i])] |= uint64_t(1) << i;
+    }
+    for (uint32_t id : touched)
+    {
+        if (counts[id] >= needed)
+        {
+            string_view name(pool.data() + offsets[id], offsets[id + 1] - offsets[id]);
+            int distance = (m >= 1 && m <= 64 && abs(m - static_cast<int>(name.size())) <= maxDistance)
+                               ? myersDistance(peq, m, name, maxDistance)
+                               : boundedEditDistance(folded, name, maxDistance);
+            if (distance <= maxDistance)
+            {
+                out.push_back({id, distance});
+            }
+        }
+        counts[id] = 0;
+    }
+    sort(out.begin(), out.end(), [](const FuzzyNameMatch &a, const FuzzyNameMatch &b)
+         { return a.distance != b.distance ? a.distance < b.distance : a.id < b.id; });
+}
+
+/**
+ * @brief Get the number of names added.
+ * @return The next id.
+ */
+size_t FuzzyIndex::size() const
+{
+    return offsets.size() - 1;
+}
+
+/**
+ * @brief Remove every name.
+ */
+void FuzzyIndex::clear()
+{
+    pool.clear();
+    offsets.assign(1, 0);
+    grams.clear();
+}
+
+/**
+ * @brief Estimate the memory the index uses.
+ * @return Bytes of heap memory for the names and trigram lists.
+ */
+size_t FuzzyIndex::memoryBytes() const
+{
+    size_t bytes = pool.capacity() + offsets.capacity() * sizeof(uint32_t);
+    bytes += grams.bucket_count() * sizeof(void *);
+    for (const auto &entry : grams)
+    {
+        bytes += sizeof(entry) + 2 * sizeof(void *) + entry.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file FuzzyIndex.h
+ * @brief Defines the FuzzyIndex class, a trigram index for typo-tolerant name search.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Each name is lower-cased, padded as "$name$" and cut into overlapping
+ * three-letter pieces (trigrams); the index lists, for every trigram, the
+ * names that contain it, split by name length. One typo changes at most
+ * three trigrams and the length by at most one, so a name
+ * within k edits of the query shares at least (query trigrams - 3k) of them.
+ * A search counts shared trigrams only over the query's lists, keeps the
+ * names that reach that bound, and checks each one with a bit-parallel edit
+ * distance (Myers) that stops as soon as the bound is out of reach.
+ */
+
+#ifndef FUZZY_INDEX_H
+#define FUZZY_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "PostalCodeItem.h"
+
+using namespace std;
+
+/**
+ * @brief One name found by FuzzyIndex::search().
+ */
+struct FuzzyNameMatch
+{
+    uint32_t id;  /**< Name id, in the order the names were added */
+    int distance; /**< Edit distance from the query, ignoring case */
+};
+
+/**
+ * @brief One item found by PostalList::fuzzySearch().
+ */
+struct FuzzyMatch
+{
+    const PostalCodeItem *item; /**< The item (valid until the list changes) */
+    uint32_t row;               /**< Its index in the list */
+    int distance;               /**< Edits between the query and the matched name */
+    double score;               /**< 1 - distance / length of the longer string; 1 is an exact match */
+    bool byCounty;              /**< true if the county name matched, false for the place name */
+};
+
+/**
+ * @brief Get the edit distance between two strings if it is small.
+ * @param pattern The first string, already lower-cased.
+ * @param text    The second string; letters are lower-cased as they are read.
+ * @param limit   The largest distance of interest.
+ * @return The Levenshtein distance, or limit + 1 if it is larger than @p limit.
+ * @note Patterns up to 64 bytes use Myers' bit-parallel algorithm (one machine
+ * word per column of the table); longer ones fall back to a two-row table.
+ * Both give up as soon as the remaining text cannot bring the distance back
+ * under the limit.
+ */
+int boundedEditDistance(string_view pattern, string_view text, int limit);
+
+class FuzzyIndex
+{
+private:
+    string pool;                                  /**< Lower-cased names back to back */
+    vector<uint32_t> offsets;                     /**< Name i is pool[offsets[i], offsets[i + 1]) */
+    unordered_map<uint32_t, vector<uint32_t>> grams; /**< (name length << 24 | trigram) -> ids of the names, ascending */
+
+public:
+    FuzzyIndex();
+
+    /**
+     * @brief Add the next name.
+     * @param name The name; it gets id size() (before the call).
+     */
+    void add(string_view name);
+
+    /**
+     * @brief Find the names within some edits of a query.
+     * @param query       The text to look for; case does not matter.
+     * @param maxDistance The most edits (insert, delete or change a letter) allowed.
+     * @param out         Receives the matches, closest first and then by id (cleared first).
+     * @note Only names that share enough trigrams with the query are compared,
+     * so the cost follows the query's trigram lists rather than the number of
+     * names. Names are never scanned in full, so a query too short to share a
+     * trigram with its match (e.g. 2 letters with 2 typos) finds nothing.
+     * Safe to call from several threads at once.
+     */
+    void search(string_view query, int maxDistance, vector<FuzzyNameMatch> &out) const;
+
+    /**
+     * @brief Get the number of names added.
+     * @return The next id.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Remove every name.
+     */
+    void clear();
+
+    /**
+     * @brief Estimate the memory the index uses.
+     * @return Bytes of heap memory for the names and trigram lists.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "FuzzyIndex.cpp"
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file ItemRange.cpp
+ * @brief Implementation of ItemRange and its iterator.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "ItemRange.h"
+
+using namespace std;
+
+ItemRange::iterator::iterator(const PostalCodeItem *items, const uint32_t *row)
+{
+    this->items = items;
+    this->row = row;
+}
+
+ItemRange::iterator::reference ItemRange::iterator::operator*() const
+{
+    return items[*row];
+}
+
+ItemRange::iterator::pointer ItemRange::iterator::operator->() const
+{
+    return &items[*row];
+}
+
+ItemRange::iterator &ItemRange::iterator::operator++()
+{
+    ++row;
+    return *this;
+}
+
+ItemRange::iterator ItemRange::iterator::operator++(int)
+{
+    iterator before = *this;
+    ++row;
+    return before;
+}
+
+ItemRange::iterator &ItemRange::iterator::operator--()
+{
+    --row;
+    return *this;
+}
+
+ItemRange::iterator &ItemRange::iterator::operator+=(difference_type n)
+{
+    row += n;
+    return *this;
+}
+
+ItemRange::iterator ItemRange::iterator::operator+(difference_type n) const
+{
+    return iterator(items, row + n);
+}
+
+ItemRange::iterator::difference_type ItemRange::iterator::operator-(const iterator &other) const
+{
+    return row - other.row;
+}
+
+ItemRange::iterator::reference ItemRange::iterator::operator[](difference_type n) const
+{
+    return items[row[n]];
+}
+
+bool ItemRange::iterator::operator==(const iterator &other) const
+{
+    return row == other.row;
+}
+
+bool ItemRange::iterator::operator!=(const iterator &other) const
+{
+    return row != other.row;
+}
+
+bool ItemRange::iterator::operator<(const iterator &other) const
+{
+    return row < other.row;
+}
+
+/**
+ * @brief Get the list index of the current item.
+ * @return The index to pass to PostalList::getItem().
+ */
+uint32_t ItemRange::iterator::index() const
+{
+    return *row;
+}
+
+/**
+ * @brief Create an empty range.
+ */
+ItemRange::ItemRange()
+{
+    items = nullptr;
+    first = nullptr;
+    last = nullptr;
+}
+
+/**
+ * @brief Create a range over some rows of a list.
+ * @param items The list's items.
+ * @param first First row number.
+ * @param last  One past the last row number.
+ */
+ItemRange::ItemRange(const PostalCodeItem *items, const uint32_t *first, const uint32_t *last)
+{
+    this->items = items;
+    this->first = first;
+    this->last = last;
+}
+
+ItemRange::iterator ItemRange::begin() const
+{
+    return iterator(items, first);
+}
+
+ItemRange::iterator ItemRange::end() const
+{
+    return iterator(items, last);
+}
+
+/**
+ * @brief Get the number of items in the range.
+ * @return The item count.
+ */
+size_t ItemRange::size() const
+{
+    return last - first;
+}
+
+/**
+ * @brief Check whether the range has no items.
+ * @return true if size() == 0.
+ */
+bool ItemRange::empty() const
+{
+    return first == last;
+}
+
+/**
+ * @brief Get the n-th item of the range.
+ * @param n Position in the range (not checked).
+ * @return The item.
+ */
+const PostalCodeItem &ItemRange::operator[](size_t n) const
+{
+    return items[first[n]];
+}
+
+/**
+ * @brief Get the list index of the n-th item.
+ * @param n Position in the range (not checked).
+ * @return The index to pass to PostalList::getItem().
+ */
+uint32_t ItemRange::indexAt(size_t n) const
+{
+    return first[n];
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ItemRange.h
+ * @brief Defines ItemRange, a read-only view of selected items of a PostalList.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Queries that return many items (a ZIP range, a sorted order) hand back an
+ * ItemRange instead of a vector of copies. It points at a run of row numbers
+ * owned by the list and at the list's items, so making one copies nothing.
+ */
+
+#ifndef ITEM_RANGE_H
+#define ITEM_RANGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "PostalCodeItem.h"
+
+using namespace std;
+
+class ItemRange
+{
+private:
+    const PostalCodeItem *items; /**< The list's items */
+    const uint32_t *first;       /**< First row number in the view */
+    const uint32_t *last;        /**< One past the last row number */
+
+public:
+    /**
+     * @brief Iterator over the items of an ItemRange.
+     */
+    class iterator
+    {
+    private:
+        const PostalCodeItem *items; /**< The list's items */
+        const uint32_t *row;         /**< Current row number */
+
+    public:
+        using iterator_category = random_access_iterator_tag;
+        using value_type = PostalCodeItem;
+        using difference_type = ptrdiff_t;
+        using pointer = const PostalCodeItem *;
+        using reference = const PostalCodeItem &;
+
+        iterator(const PostalCodeItem *items, const uint32_t *row);
+        reference operator*() const;
+        pointer operator->() const;
+        iterator &operator++();
+        iterator operator++(int);
+        iterator &operator--();
+        iterator &operator+=(difference_type n);
+        iterator operator+(difference_type n) const;
+        difference_type operator-(const iterator &other) const;
+        reference operator[](difference_type n) const;
+        bool operator==(const iterator &other) const;
+        bool operator!=(const iterator &other) const;
+        bool operator<(const iterator &other) const;
+
+        /**
+         * @brief Get the list index of the current item.
+         * @return The index to pass to PostalList::getItem().
+         */
+        uint32_t index() const;
+    };
+
+    /**
+     * @brief Create an empty range.
+     */
+    ItemRange();
+
+    /**
+     * @brief Create a range over some rows of a list.
+     * @param items The list's items.
+     * @param first First row number.
+     * @param last  One past the last row number.
+     */
+    ItemRange(const PostalCodeItem *items, const uint32_t *first, const uint32_t *last);
+
+    iterator begin() const;
+    iterator end() const;
+
+    /**
+     * @brief Get the number of items in the range.
+     * @return The item count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check whether the range has no items.
+     * @return true if size() == 0.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Get the n-th item of the range.
+     * @param n Position in the range (not checked).
+     * @return The item.
+     */
+    const PostalCodeItem &operator[](size_t n) const;
+
+    /**
+     * @brief Get the list index of the n-th item.
+     * @param n Position in the range (not checked).
+     * @return The index to pass to PostalList::getItem().
+     */
+    uint32_t indexAt(size_t n) const;
+};
+
+#include "ItemRange.cpp"
+#endif
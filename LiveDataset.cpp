@@ -0,0 +1,210 @@
+/**
+ * @file LiveDataset.cpp
+ * @brief Implementation of the LiveDataset class and its reader epochs.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "LiveDataset.h"
+#include <stdexcept>
+
+using namespace std;
+
+const uint64_t EPOCH_IDLE = UINT64_MAX; /**< Slot value of a thread that is not reading */
+
+/**
+ * @brief The epoch one reading thread is in, on its own cache line.
+ */
+struct alignas(64) ReaderSlot
+{
+    atomic<uint64_t> epoch{EPOCH_IDLE}; /**< Epoch seen when the outermost Reader started */
+    atomic<bool> taken{false};          /**< Owned by a live thread */
+};
+
+ReaderSlot readerSlots[LiveDataset::MAX_READER_THREADS]; /**< One per reading thread */
+atomic<uint64_t> globalEpoch(1);                          /**< Advanced by every publish */
+
+/**
+ * @brief A thread's slot and how many Readers it holds; gives the slot back at thread exit.
+ */
+struct ThreadReader
+{
+    ReaderSlot *slot = nullptr; /**< Claimed on the first read */
+    int depth = 0;              /**< Readers alive on this thread */
+
+    ~ThreadReader()
+    {
+        if (slot)
+        {
+            slot->epoch.store(EPOCH_IDLE);
+            slot->taken.store(false, memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadReader threadReader;
+
+/**
+ * @brief Take over a loaded list and build everything readers may touch.
+ * @param loaded  The list.
+ * @param version The version number.
+ */
+Dataset::Dataset(PostalList &&loaded, uint64_t version) : list(move(loaded)), service(list), version(version)
+{
+    vector<PlaceMatch> none;
+    vector<FuzzyMatch> noMatches;
+    list.sortedByState();
+    list.completePlace("", 0, none);
+    list.fuzzySearch("", 0, noMatches);
+}
+
+/**
+ * @brief Hold a dataset; the thread's epoch is already set.
+ */
+LiveDataset::Reader::Reader(const Dataset *data) : data(data)
+{
+}
+
+/**
+ * @brief Let go of the dataset; the outermost Reader marks the thread idle.
+ */
+LiveDataset::Reader::~Reader()
+{
+    if (--threadReader.depth == 0)
+    {
+        threadReader.slot->epoch.store(EPOCH_IDLE, memory_order_release);
+    }
+}
+
+const Dataset &LiveDataset::Reader::operator*() const
+{
+    return *data;
+}
+
+const Dataset *LiveDataset::Reader::operator->() const
+{
+    return data;
+}
+
+/**
+ * @brief Publish the first dataset.
+ * @param first The loaded list.
+ */
+LiveDataset::LiveDataset(PostalList &&first) : versions(1)
+{
+    current.store(new Dataset(move(first), 1));
+}
+
+/**
+ * @brief Free every dataset.
+ */
+LiveDataset::~LiveDataset()
+{
+    for (auto &entry : retired)
+    {
+        delete entry.second;
+    }
+    delete current.load();
+}
+
+/**
+ * @brief Get the current dataset.
+ * @return A Reader that keeps it alive.
+ */
+LiveDataset::Reader LiveDataset::read() const
+{
+    ThreadReader &me = threadReader;
+    if (me.slot == nullptr)
+    {
+        for (ReaderSlot &slot : readerSlots)
+        {
+            bool expected = false;
+            if (!slot.taken.load(memory_order_relaxed) && slot.taken.compare_exchange_strong(expected, true))
+            {
+                me.slot = &slot;
+                break;
+            }
+        }
+        if (me.slot == nullptr)
+        {
+            throw runtime_error("LiveDataset: more than MAX_READER_THREADS reading threads");
+        }
+    }
+
+    // Announce the epoch before loading the pointer (both sequentially
+    // consistent): a publish that swaps after this load retires the old
+    // dataset under a later epoch and will wait for this slot
+    if (me.depth++ == 0)
+    {
+        me.slot->epoch.store(globalEpoch.load());
+    }
+    return Reader(current.load());
+}
+
+/**
+ * @brief Replace the dataset.
+ * @param next The new list.
+ * @return The new version number.
+ */
+uint64_t LiveDataset::publish(PostalList &&next)
+{
+    uint64_t version = ++versions;
+    const Dataset *fresh = new Dataset(move(next), version);
+
+    lock_guard<mutex> guard(writerLock);
+    const Dataset *old = current.exchange(fresh);
+    retired.push_back({++globalEpoch, old});
+    reclaimLocked();
+    return version;
+}
+
+/**
+ * @brief Free retired datasets that no reader can still see.
+ * @return How many are still waiting for readers.
+ */
+size_t LiveDataset::reclaim()
+{
+    lock_guard<mutex> guard(writerLock);
+    return reclaimLocked();
+}
+
+/**
+ * @brief reclaim() with writerLock already held.
+ */
+size_t LiveDataset::reclaimLocked()
+{
+    uint64_t oldest = EPOCH_IDLE;
+    for (const ReaderSlot &slot : readerSlots)
+    {
+        oldest = min(oldest, slot.epoch.load());
+    }
+    size_t kept = 0;
+    for (auto &entry : retired)
+    {
+        if (entry.first <= oldest)
+        {
+            delete entry.second;
+        }
+        else
+        {
+            retired[kept++] = entry;
+        }
+    }
+    retired.resize(kept);
+    return kept;
+}
+
+/**
+ * @brief Get the current version number.
+ * @return The version of the dataset read() returns now.
+ */
+uint64_t LiveDataset::version() const
+{
+    return read()->version;
+}
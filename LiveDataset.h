@@ -0,0 +1,138 @@
+/**
+ * @file LiveDataset.h
+ * @brief Defines the LiveDataset class, a PostalList that can be replaced while readers use it.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Readers get the current dataset (a PostalList with every index built, plus
+ * a QueryService over it) through read(). The dataset never changes. A
+ * reload builds a whole new one off to the side and publishes it with one
+ * atomic pointer swap, so a reader sees either the old data or the new data,
+ * never a mix.
+ *
+ * Old datasets are freed with epochs, not locks. Each reading thread owns a
+ * slot. While it reads, the slot holds the global epoch it saw when it
+ * started. A swap retires the old dataset under the next epoch. The dataset
+ * is freed once every slot is idle or holds a later epoch, because a reader
+ * that started after the swap cannot have seen the old pointer. A reader
+ * does two atomic stores and two atomic loads. It never waits and never
+ * writes a shared cache line other than its own slot.
+ */
+
+#ifndef LIVE_DATASET_H
+#define LIVE_DATASET_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "PostalList.h"
+#include "QueryService.h"
+
+using namespace std;
+
+/**
+ * @brief One immutable version of the data.
+ */
+struct Dataset
+{
+    PostalList list;      /**< The records and their indexes */
+    QueryService service; /**< Answers protocol queries over list */
+    uint64_t version;     /**< 1 for the first dataset, then counts up with each publish */
+
+    /**
+     * @brief Take over a loaded list and build everything readers may touch.
+     * @param loaded  The list; it is moved in.
+     * @param version The version number.
+     * @note Builds the lazy ZIP, state, place and fuzzy indexes now, so readers
+     * never trigger a build.
+     */
+    Dataset(PostalList &&loaded, uint64_t version);
+};
+
+class LiveDataset
+{
+private:
+    atomic<const Dataset *> current;                /**< What read() returns */
+    atomic<uint64_t> versions;                      /**< Last version handed out */
+    mutex writerLock;                               /**< Serialises publish() and reclaim(); readers never take it */
+    vector<pair<uint64_t, const Dataset *>> retired; /**< Replaced datasets and the epoch they were retired in */
+
+    size_t reclaimLocked();
+
+public:
+    static const size_t MAX_READER_THREADS = 256; /**< Threads that may hold a reader slot at the same time (shared by all LiveDatasets) */
+
+    /**
+     * @brief A reader's hold on one dataset.
+     * @note The dataset stays alive until the Reader is destroyed. Keep it
+     * for one query or one batch, not for long: while it is held, datasets
+     * retired after it started cannot be freed. Readers may nest on one thread.
+     */
+    class Reader
+    {
+    private:
+        const Dataset *data; /**< The dataset held */
+
+    public:
+        explicit Reader(const Dataset *data);
+        ~Reader();
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        const Dataset &operator*() const;
+        const Dataset *operator->() const;
+    };
+
+    /**
+     * @brief Publish the first dataset.
+     * @param first The loaded list; it is moved in.
+     */
+    explicit LiveDataset(PostalList &&first);
+
+    /**
+     * @brief Free every dataset.
+     * @note No Reader may be alive.
+     */
+    ~LiveDataset();
+
+    LiveDataset(const LiveDataset &) = delete;
+    LiveDataset &operator=(const LiveDataset &) = delete;
+
+    /**
+     * @brief Get the current dataset.
+     * @return A Reader that keeps it alive.
+     * @throws runtime_error if more than MAX_READER_THREADS threads read at once.
+     * @note Lock-free and wait-free once the thread has its slot (claimed on its first read).
+     */
+    Reader read() const;
+
+    /**
+     * @brief Replace the dataset.
+     * @param next The new list; it is moved in and its indexes are built here,
+     * before anything is published.
+     * @return The new version number.
+     * @note Readers keep running on the old dataset the whole time. It is
+     * freed here or by a later publish()/reclaim() once no reader can see it.
+     */
+    uint64_t publish(PostalList &&next);
+
+    /**
+     * @brief Free retired datasets that no reader can still see.
+     * @return How many are still waiting for readers.
+     */
+    size_t reclaim();
+
+    /**
+     * @brief Get the current version number.
+     * @return The version of the dataset read() returns now.
+     */
+    uint64_t version() const;
+};
+
+#include "LiveDataset.cpp"
+#endif
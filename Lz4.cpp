@@ -0,0 +1,241 @@
+/**
+ * @file Lz4.cpp
+ * @brief Implementation of the LZ4 block compressor and decompressor.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "Lz4.h"
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+const size_t LZ4_MIN_MATCH = 4;      /**< Shortest match the format can encode */
+const size_t LZ4_LAST_LITERALS = 5;  /**< The last 5 bytes of a block are always literals */
+const size_t LZ4_MATCH_LIMIT = 12;   /**< The last match must start at least 12 bytes before the end */
+const size_t LZ4_MAX_OFFSET = 65535; /**< Offsets are 2 bytes */
+const int LZ4_HASH_BITS = 12;        /**< 4096-entry match table (16 KiB, fits in L1) */
+
+/**
+ * @brief Read 4 bytes without alignment requirements.
+ */
+uint32_t lz4Read32(const unsigned char *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Write a length of 15 or more as the format's extra bytes (255, 255, ..., rest).
+ */
+unsigned char *lz4WriteLength(unsigned char *out, size_t length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *out++ = 255;
+    }
+    *out++ = static_cast<unsigned char>(length);
+    return out;
+}
+
+/**
+ * @brief Largest compressed size of @p size bytes.
+ * @param size Input size in bytes.
+ * @return Bytes the output buffer of lz4Compress() must hold.
+ */
+size_t lz4CompressBound(size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compress one block.
+ * @param source      The input.
+ * @param size        Input size in bytes.
+ * @param destination Output buffer of at least lz4CompressBound(size) bytes.
+ * @return The compressed size.
+ */
+size_t lz4Compress(const char *source, size_t size, char *destination)
+{
+    const unsigned char *in = reinterpret_cast<const unsigned char *>(source);
+    const unsigned char *end = in + size;
+    const unsigned char *anchor = in; // first byte not yet written
+    unsigned char *out = reinterpret_cast<unsigned char *>(destination);
+
+    if (size > LZ4_MATCH_LIMIT)
+    {
+        uint32_t table[1 << LZ4_HASH_BITS] = {};
+        const unsigned char *matchLimit = end - LZ4_MATCH_LIMIT;
+        const unsigned char *ip = in;
+        while (ip < matchLimit)
+        {
+            uint32_t sequence = lz4Read32(ip);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+            const unsigned char *candidate = in + table[hash];
+            table[hash] = static_cast<uint32_t>(ip - in);
+            if (candidate >= ip || static_cast<size_t>(ip - candidate) > LZ4_MAX_OFFSET ||
+                lz4Read32(candidate) != sequence)
+            {
+                // Step faster through data that keeps missing
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            // Extend the match backwards over pending literals, then forwards
+            while (ip > anchor && candidate > in && ip[-1] == candidate[-1])
+            {
+                ip--;
+                candidate--;
+            }
+            const unsigned char *matchEnd = ip + LZ4_MIN_MATCH;
+            const unsigned char *from = candidate + LZ4_MIN_MATCH;
+            while (matchEnd < end - LZ4_LAST_LITERALS && *matchEnd == *from)
+            {
+                matchEnd++;
+                from++;
+            }
+
+            size_t literals = ip - anchor;
+            size_t matchLength = (matchEnd - ip) - LZ4_MIN_MATCH;
+            unsigned char *token = out++;
+            *token = static_cast<unsigned char>(((literals >= 15) ? 15 : literals) << 4);
+            if (literals >= 15)
+            {
+                out = lz4WriteLength(out, literals - 15);
+            }
+            memcpy(out, anchor, literals);
+            out += literals;
+
+            size_t offset = ip - candidate;
+            *out++ = static_cast<unsigned char>(offset);
+            *out++ = static_cast<unsigned char>(offset >> 8);
+            *token |= static_cast<unsigned char>((matchLength >= 15) ? 15 : matchLength);
+            if (matchLength >= 15)
+            {
+                out = lz4WriteLength(out, matchLength - 15);
+            }
+            ip = matchEnd;
+            anchor = ip;
+        }
+    }
+
+    // The rest goes out as one literal-only sequence
+    size_t literals = end - anchor;
+    *out++ = static_cast<unsigned char>(((literals >= 15) ? 15 : literals) << 4);
+    if (literals >= 15)
+    {
+        out = lz4WriteLength(out, literals - 15);
+    }
+    if (literals > 0)
+    {
+        memcpy(out, anchor, literals);
+    }
+    out += literals;
+    return out - reinterpret_cast<unsigned char *>(destination);
+}
+
+/**
+ * @brief Decompress one block whose decompressed size is known.
+ * @param source      The compressed block.
+ * @param size        Its size in bytes.
+ * @param destination Output buffer.
+ * @param outputSize  Exact decompressed size.
+ * @return true if the block decoded to exactly @p outputSize bytes.
+ */
+bool lz4Decompress(const char *source, size_t size, char *destination, size_t outputSize)
+{
+    const unsigned char *ip = reinterpret_cast<const unsigned char *>(source);
+    const unsigned char *inEnd = ip + size;
+    unsigned char *start = reinterpret_cast<unsigned char *>(destination);
+    unsigned char *op = start;
+    unsigned char *outEnd = op + outputSize;
+
+    // Reads a length that continues past its 4-bit field; false if the input ends first
+    auto readLength = [&](size_t &length)
+    {
+        unsigned char extra;
+        do
+        {
+            if (ip >= inEnd)
+            {
+                return false;
+            }
+            extra = *ip++;
+            length += extra;
+        } while (extra == 255);
+        return true;
+    };
+
+    while (ip < inEnd)
+    {
+        unsigned char token = *ip++;
+        size_t literals = token >> 4;
+        if (literals == 15 && !readLength(literals))
+        {
+            return false;
+        }
+        if (literals > static_cast<size_t>(inEnd - ip) || literals > static_cast<size_t>(outEnd - op))
+        {
+            return false;
+        }
+        if (literals <= 16 && inEnd - ip >= 16 && outEnd - op >= 16)
+        {
+            memcpy(op, ip, 16); // a fixed-size copy is a couple of instructions; the extra bytes get overwritten
+        }
+        else
+        {
+            memcpy(op, ip, literals);
+        }
+        ip += literals;
+        op += literals;
+        if (ip == inEnd)
+        {
+            break; // the last sequence has no match
+        }
+
+        if (inEnd - ip < 2)
+        {
+            return false;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !readLength(matchLength))
+        {
+            return false;
+        }
+        matchLength += LZ4_MIN_MATCH;
+        if (offset == 0 || offset > static_cast<size_t>(op - start) ||
+            matchLength > static_cast<size_t>(outEnd - op))
+        {
+            return false;
+        }
+
+        // The copy may overlap its own output (a run); 8-byte steps are safe once the source is 8 back
+        const unsigned char *from = op - offset;
+        if (offset >= 8 && static_cast<size_t>(outEnd - op) >= matchLength + 8)
+        {
+            for (size_t i = 0; i < matchLength; i += 8)
+            {
+                memcpy(op + i, from + i, 8);
+            }
+            op += matchLength;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                *op++ = from[i];
+            }
+        }
+    }
+    return op == outEnd;
+}
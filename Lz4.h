@@ -0,0 +1,54 @@
+/**
+ * @file Lz4.h
+ * @brief Declares a small LZ4 block compressor and decompressor.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The output is the standard LZ4 block format (no frame header), so blocks
+ * can also be read with the reference library. A block is a series of
+ * sequences: a token byte (literal count, match length), the literals, and
+ * a 2-byte offset back to an earlier copy of the next 4 or more bytes.
+ * The compressor finds matches with one hash table lookup per position and
+ * no search, which is why both directions run at hundreds of MB/s or more.
+ */
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief Largest compressed size of @p size bytes (incompressible input grows slightly).
+ * @param size Input size in bytes.
+ * @return Bytes the output buffer of lz4Compress() must hold.
+ */
+size_t lz4CompressBound(size_t size);
+
+/**
+ * @brief Compress one block.
+ * @param source      The input.
+ * @param size        Input size in bytes.
+ * @param destination Output buffer of at least lz4CompressBound(size) bytes.
+ * @return The compressed size.
+ */
+size_t lz4Compress(const char *source, size_t size, char *destination);
+
+/**
+ * @brief Decompress one block whose decompressed size is known.
+ * @param source      The compressed block.
+ * @param size        Its size in bytes.
+ * @param destination Output buffer.
+ * @param outputSize  Exact decompressed size.
+ * @return true if the block decoded to exactly @p outputSize bytes.
+ * @note Every length and offset is checked, so damaged input returns false
+ * instead of reading or writing out of bounds.
+ */
+bool lz4Decompress(const char *source, size_t size, char *destination, size_t outputSize);
+
+#include "Lz4.cpp"
+#endif
@@ -0,0 +1,235 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Implementation of the MappedFile class (read-only file mapping).
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+/**
+ * @brief Implementation of the MappedFile class.
+ * On POSIX systems the file is mapped with mmap() so the kernel pages it in
+ * on demand and nothing is copied. On Windows the file is read into one heap
+ * buffer instead, which keeps the same interface for the loaders.
+ * @see MappedFile.h
+ */
+
+#include "MappedFile.h"
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Read the size and modification time of a file.
+ * @param fileName The file.
+ * @param size     Receives its size in bytes.
+ * @param modified Receives its modification time (seconds since 1970).
+ * @return false if the file cannot be found.
+ */
+bool fileStamp(const string &fileName, uint64_t &size, int64_t &modified)
+{
+    struct stat info;
+    if (stat(fileName.c_str(), &info) != 0)
+    {
+        return false;
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    modified = static_cast<int64_t>(info.st_mtime);
+    return true;
+}
+
+/**
+ * @brief Write a file through a temporary file and rename it into place.
+ * @param fileName The file.
+ * @param parts    The contents, written one after another.
+ * @return true if the whole file was written and moved into place.
+ */
+bool replaceFile(const string &fileName, initializer_list<string_view> parts)
+{
+    // The process id keeps two programs writing the same file from sharing a temporary
+#ifndef _WIN32
+    string tempName = fileName + ".tmp" + to_string(getpid());
+#else
+    string tempName = fileName + ".tmp" + to_string(_getpid());
+#endif
+    bool written;
+    {
+        ofstream out(tempName, ios::binary | ios::trunc);
+        for (string_view part : parts)
+        {
+            out.write(part.data(), part.size());
+        }
+        out.close();
+        written = static_cast<bool>(out);
+    }
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    if (written)
+    {
+        remove(fileName.c_str());
+    }
+#endif
+    if (!written || rename(tempName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tempName.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Default constructor creating a closed mapping.
+ */
+MappedFile::MappedFile()
+{
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
+
+/**
+ * @brief Open and map a file in one step.
+ * @param fileName Path of the file to map.
+ * @param pattern  How the file will be read.
+ */
+MappedFile::MappedFile(const string &fileName, AccessPattern pattern) : MappedFile()
+{
+    open(fileName, pattern);
+}
+
+/**
+ * @brief Unmaps the file if it is still open.
+ */
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/**
+ * @brief Map a file read-only, closing any previous mapping first.
+ * @param fileName Path of the file to map.
+ * @param pattern  How the file will be read.
+ * @return true if the file was mapped, false if it could not be opened.
+ */
+bool MappedFile::open(const string &fileName, AccessPattern pattern)
+{
+    close();
+
+#ifdef _WIN32
+    (void)pattern;
+    ifstream in(fileName, ios::binary | ios::ate);
+    if (!in.is_open())
+    {
+        return false;
+    }
+    length = static_cast<size_t>(in.tellg());
+    if (length > 0)
+    {
+        char *buffer = new char[length];
+        in.seekg(0);
+        in.read(buffer, length);
+        bytes = buffer;
+    }
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0)
+    {
+        void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        // Loaders read front to back and want aggressive readahead; index probes want none
+        if (pattern == AccessPattern::Sequential)
+        {
+            madvise(mapping, length, MADV_SEQUENTIAL);
+        }
+        else if (pattern == AccessPattern::Random)
+        {
+            madvise(mapping, length, MADV_RANDOM);
+        }
+        bytes = static_cast<const char *>(mapping);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief Release the mapping. Safe to call more than once.
+ */
+void MappedFile::close()
+{
+    if (bytes != nullptr)
+    {
+#ifdef _WIN32
+        delete[] bytes;
+#else
+        munmap(const_cast<char *>(bytes), length);
+#endif
+    }
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
+
+/**
+ * @brief Check whether a file is currently mapped.
+ * @return true if open() succeeded and close() has not been called.
+ */
+bool MappedFile::isOpen() const
+{
+    return opened;
+}
+
+/**
+ * @brief Get the first byte of the mapping.
+ * @return Pointer to the file contents, or nullptr for a closed or empty file.
+ */
+const char *MappedFile::data() const
+{
+    return bytes;
+}
+
+/**
+ * @brief Get the number of mapped bytes.
+ * @return The file size in bytes.
+ */
+size_t MappedFile::size() const
+{
+    return length;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file MappedFile.h
+ * @brief Defines the MappedFile class, a read-only memory mapping of a file.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * A MappedFile exposes the whole contents of a file as one contiguous
+ * block of bytes so loaders can split records in place instead of
+ * copying every line into a std::string first.
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <initializer_list>
+
+using namespace std;
+
+/**
+ * @brief Read the size and modification time of a file.
+ * @param fileName The file.
+ * @param size     Receives its size in bytes.
+ * @param modified Receives its modification time (seconds since 1970).
+ * @return false if the file cannot be found.
+ * @note Used by the on-disk formats to tell whether their source changed.
+ */
+bool fileStamp(const string &fileName, uint64_t &size, int64_t &modified);
+
+/**
+ * @brief Write a file in one step, replacing any previous version.
+ * @param fileName The file.
+ * @param parts    The contents, written one after another.
+ * @return true if the whole file was written and moved into place.
+ * @note The bytes go to a temporary file in the same directory that is then
+ * renamed over @p fileName, so a reader (or a mapping) never sees a
+ * half-written file and a failed write leaves the old one untouched.
+ */
+bool replaceFile(const string &fileName, initializer_list<string_view> parts);
+
+/**
+ * @brief How a mapping will be read, passed on to the kernel as a readahead hint.
+ */
+enum class AccessPattern
+{
+    Sequential, /**< Front to back once, as the loaders do: read ahead hard and drop pages behind */
+    Random,     /**< Scattered probes such as binary searches and hash lookups: no readahead */
+    Normal      /**< No hint; the kernel's default readahead */
+};
+
+class MappedFile
+{
+private:
+    const char *bytes; /**< First byte of the mapping (nullptr when closed) */
+    size_t length;     /**< Number of bytes mapped */
+    bool opened;       /**< True between a successful open() and close() */
+
+public:
+    /**
+     * @brief Default constructor creating a closed mapping.
+     */
+    MappedFile();
+
+    /**
+     * @brief Open and map a file in one step.
+     * @param fileName Path of the file to map.
+     * @param pattern  How the file will be read.
+     * @note Check isOpen() afterwards; a missing file leaves the mapping closed.
+     */
+    explicit MappedFile(const string &fileName, AccessPattern pattern = AccessPattern::Sequential);
+
+    /**
+     * @brief Unmaps the file if it is still open.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Map a file read-only, closing any previous mapping first.
+     * @param fileName Path of the file to map.
+     * @param pattern  How the file will be read (a hint; ignored on Windows).
+     * @return true if the file was mapped, false if it could not be opened.
+     * @note An empty file opens successfully with size() == 0.
+     */
+    bool open(const string &fileName, AccessPattern pattern = AccessPattern::Sequential);
+
+    /**
+     * @brief Release the mapping. Safe to call more than once.
+     */
+    void close();
+
+    /**
+     * @brief Check whether a file is currently mapped.
+     * @return true if open() succeeded and close() has not been called.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get the first byte of the mapping.
+     * @return Pointer to the file contents, or nullptr for a closed or empty file.
+     * @note The bytes are not null-terminated.
+     */
+    const char *data() const;
+
+    /**
+     * @brief Get the number of mapped bytes.
+     * @return The file size in bytes.
+     */
+    size_t size() const;
+};
+
+#include "MappedFile.cpp"
+#endif
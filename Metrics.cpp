@@ -0,0 +1,447 @@
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the Metrics totals and the phase and latency timers.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "Metrics.h"
+#include <iomanip>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+using namespace std;
+
+const int METRIC_PHASES = static_cast<int>(MetricPhase::Count);
+const int METRIC_COUNTERS = static_cast<int>(MetricCounter::Count);
+const int METRIC_HISTOGRAMS = static_cast<int>(MetricHistogram::Count);
+
+/** Names used in the JSON keys and Prometheus labels, in enum order */
+const char *const PHASE_NAMES[METRIC_PHASES] = {"read", "parse", "insert", "sort", "index_build", "output"};
+const char *const COUNTER_NAMES[METRIC_COUNTERS] = {"bytes_read", "bytes_written", "rows_loaded", "rows_rejected",
+                                                   "zip_hits", "zip_misses", "index_hits", "index_misses"};
+const char *const HISTOGRAM_NAMES[METRIC_HISTOGRAMS] = {"zip_lookup", "index_lookup"};
+
+/** The hit and miss counters behind each histogram, for its hit rate */
+const MetricCounter HISTOGRAM_HITS[METRIC_HISTOGRAMS] = {MetricCounter::ZipHits, MetricCounter::IndexHits};
+const MetricCounter HISTOGRAM_MISSES[METRIC_HISTOGRAMS] = {MetricCounter::ZipMisses, MetricCounter::IndexMisses};
+
+/**
+ * @brief Totals of one phase.
+ */
+struct PhaseTotals
+{
+    atomic<uint64_t> wallNanos{0}; /**< Wall time over all runs */
+    atomic<uint64_t> cpuNanos{0};  /**< CPU time over all runs */
+    atomic<uint64_t> runs{0};      /**< How many runs were added */
+};
+
+/**
+ * @brief Totals of one latency histogram.
+ */
+struct HistogramTotals
+{
+    atomic<uint64_t> buckets[Metrics::BUCKETS] = {}; /**< Samples per power-of-two bucket */
+    atomic<uint64_t> count{0};                       /**< Samples */
+    atomic<uint64_t> sumNanos{0};                    /**< Sum of all samples */
+};
+
+atomic<bool> metricsEnabled(false);
+PhaseTotals phaseTotals[METRIC_PHASES];
+atomic<uint64_t> counterTotals[METRIC_COUNTERS] = {};
+HistogramTotals histogramTotals[METRIC_HISTOGRAMS];
+
+/**
+ * @brief Turn recording on or off.
+ * @param enabled true to record from now on.
+ */
+void Metrics::enable(bool enabled)
+{
+    metricsEnabled.store(enabled, memory_order_relaxed);
+}
+
+/**
+ * @brief Check whether recording is on.
+ * @return true after enable().
+ */
+bool Metrics::isEnabled()
+{
+    return metricsEnabled.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Add to a counter (ignored while recording is off).
+ * @param counter The counter.
+ * @param amount  How much to add.
+ */
+void Metrics::add(MetricCounter counter, uint64_t amount)
+{
+    if (isEnabled())
+    {
+        counterTotals[static_cast<int>(counter)].fetch_add(amount, memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Add one timed run of a phase.
+ * @param phase     The phase.
+ * @param wallNanos Wall time in nanoseconds.
+ * @param cpuNanos  Process CPU time (all threads) in nanoseconds.
+ */
+void Metrics::addPhase(MetricPhase phase, uint64_t wallNanos, uint64_t cpuNanos)
+{
+    PhaseTotals &totals = phaseTotals[static_cast<int>(phase)];
+    totals.wallNanos.fetch_add(wallNanos, memory_order_relaxed);
+    totals.cpuNanos.fetch_add(cpuNanos, memory_order_relaxed);
+    totals.runs.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * @brief Add one latency sample to a histogram.
+ * @param histogram The histogram.
+ * @param nanos     The latency in nanoseconds.
+ */
+void Metrics::addLatency(MetricHistogram histogram, uint64_t nanos)
+{
+    // Bucket b holds [2^(b-1), 2^b); bucket 0 holds 0
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && (nanos >> bucket) != 0)
+    {
+        bucket++;
+    }
+    HistogramTotals &totals = histogramTotals[static_cast<int>(histogram)];
+    totals.buckets[bucket].fetch_add(1, memory_order_relaxed);
+    totals.count.fetch_add(1, memory_order_relaxed);
+    totals.sumNanos.fetch_add(nanos, memory_order_relaxed);
+}
+
+/**
+ * @brief Get a counter's total.
+ * @param counter The counter.
+ * @return Its value.
+ */
+uint64_t Metrics::counter(MetricCounter counter)
+{
+    return counterTotals[static_cast<int>(counter)].load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get a phase's total wall time.
+ * @param phase The phase.
+ * @return Nanoseconds over all runs of the phase.
+ */
+uint64_t Metrics::phaseWallNanos(MetricPhase phase)
+{
+    return phaseTotals[static_cast<int>(phase)].wallNanos.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get a phase's total CPU time.
+ * @param phase The phase.
+ * @return Nanoseconds of process CPU time over all runs of the phase.
+ */
+uint64_t Metrics::phaseCpuNanos(MetricPhase phase)
+{
+    return phaseTotals[static_cast<int>(phase)].cpuNanos.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get how many times a phase ran.
+ * @param phase The phase.
+ * @return The run count.
+ */
+uint64_t Metrics::phaseRuns(MetricPhase phase)
+{
+    return phaseTotals[static_cast<int>(phase)].runs.load(memory_order_relaxed);
+}
+
+/**
+ * @brief Get a latency percentile from a histogram.
+ * @param histogram The histogram.
+ * @param fraction  The percentile as a fraction, e.g. 0.99.
+ * @return The upper bound of the bucket that holds it, in nanoseconds (0 if empty).
+ */
+uint64_t Metrics::latencyPercentile(MetricHistogram histogram, double fraction)
+{
+    const HistogramTotals &totals = histogramTotals[static_cast<int>(histogram)];
+    uint64_t count = totals.count.load(memory_order_relaxed);
+    if (count == 0)
+    {
+        return 0;
+    }
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        seen += totals.buckets[b].load(memory_order_relaxed);
+        if (seen >= fraction * count)
+        {
+            return uint64_t(1) << b;
+        }
+    }
+    return uint64_t(1) << (BUCKETS - 1);
+}
+
+/**
+ * @brief Set every phase, counter and histogram back to zero.
+ */
+void Metrics::reset()
+{
+    for (PhaseTotals &totals : phaseTotals)
+    {
+        totals.wallNanos = 0;
+        totals.cpuNanos = 0;
+        totals.runs = 0;
+    }
+    for (atomic<uint64_t> &total : counterTotals)
+    {
+        total = 0;
+    }
+    for (HistogramTotals &totals : histogramTotals)
+    {
+        for (atomic<uint64_t> &bucket : totals.buckets)
+        {
+            bucket = 0;
+        }
+        totals.count = 0;
+        totals.sumNanos = 0;
+    }
+}
+
+/**
+ * @brief Get the hit rate of the lookups behind a histogram.
+ * @param h The histogram index.
+ * @return Hits over hits plus misses, or 0 before any lookup.
+ */
+double metricsHitRate(int h)
+{
+    uint64_t hits = Metrics::counter(HISTOGRAM_HITS[h]);
+    uint64_t misses = Metrics::counter(HISTOGRAM_MISSES[h]);
+    return (hits + misses == 0) ? 0.0 : static_cast<double>(hits) / (hits + misses);
+}
+
+/**
+ * @brief Write the totals as one JSON object.
+ * @param out Where to write.
+ */
+void writeMetricsJSON(ostream &out)
+{
+    out << "{\n  \"phases\": {";
+    for (int p = 0; p < METRIC_PHASES; p++)
+    {
+        const PhaseTotals &totals = phaseTotals[p];
+        out << (p ? "," : "") << "\n    \"" << PHASE_NAMES[p] << "\": {\"runs\": " << totals.runs
+            << ", \"wallSeconds\": " << totals.wallNanos / 1e9
+            << ", \"cpuSeconds\": " << totals.cpuNanos / 1e9 << "}";
+    }
+    out << "\n  },\n  \"counters\": {";
+    for (int c = 0; c < METRIC_COUNTERS; c++)
+    {
+        out << (c ? "," : "") << "\n    \"" << COUNTER_NAMES[c] << "\": " << counterTotals[c];
+    }
+    out << "\n  },\n  \"lookups\": {";
+    for (int h = 0; h < METRIC_HISTOGRAMS; h++)
+    {
+        const HistogramTotals &totals = histogramTotals[h];
+        MetricHistogram histogram = static_cast<MetricHistogram>(h);
+        uint64_t count = totals.count;
+        uint64_t lookups = Metrics::counter(HISTOGRAM_HITS[h]) + Metrics::counter(HISTOGRAM_MISSES[h]);
+        out << (h ? "," : "") << "\n    \"" << HISTOGRAM_NAMES[h] << "\": {\"lookups\": " << lookups
+            << ", \"hitRate\": " << metricsHitRate(h) << ", \"latencySamples\": " << count
+            << ", \"meanNanos\": " << (count ? static_cast<double>(totals.sumNanos) / count : 0.0)
+            << ", \"p50Nanos\": " << Metrics::latencyPercentile(histogram, 0.5)
+            << ", \"p99Nanos\": " << Metrics::latencyPercentile(histogram, 0.99)
+            << ", \"p999Nanos\": " << Metrics::latencyPercentile(histogram, 0.999)
+            << ", \"buckets\": [";
+        // Only the buckets that were used, as {upper bound, samples} pairs
+        bool first = true;
+        for (int b = 0; b < Metrics::BUCKETS; b++)
+        {
+            uint64_t samples = totals.buckets[b];
+            if (samples != 0)
+            {
+                out << (first ? "" : ", ") << "{\"ltNanos\": " << (uint64_t(1) << b) << ", \"count\": " << samples << "}";
+                first = false;
+            }
+        }
+        out << "]}";
+    }
+    out << "\n  }\n}\n";
+}
+
+/**
+ * @brief Write the totals in the Prometheus text exposition format.
+ * @param out Where to write.
+ */
+void writeMetricsPrometheus(ostream &out)
+{
+    out << "# HELP postal_phase_wall_seconds_total Wall time spent in each phase.\n"
+        << "# TYPE postal_phase_wall_seconds_total counter\n";
+    for (int p = 0; p < METRIC_PHASES; p++)
+    {
+        out << "postal_phase_wall_seconds_total{phase=\"" << PHASE_NAMES[p] << "\"} "
+            << phaseTotals[p].wallNanos / 1e9 << "\n";
+    }
+    out << "# HELP postal_phase_cpu_seconds_total Process CPU time spent in each phase.\n"
+        << "# TYPE postal_phase_cpu_seconds_total counter\n";
+    for (int p = 0; p < METRIC_PHASES; p++)
+    {
+        out << "postal_phase_cpu_seconds_total{phase=\"" << PHASE_NAMES[p] << "\"} "
+            << phaseTotals[p].cpuNanos / 1e9 << "\n";
+    }
+    out << "# HELP postal_phase_runs_total Times each phase ran.\n"
+        << "# TYPE postal_phase_runs_total counter\n";
+    for (int p = 0; p < METRIC_PHASES; p++)
+    {
+        out << "postal_phase_runs_total{phase=\"" << PHASE_NAMES[p] << "\"} " << phaseTotals[p].runs << "\n";
+    }
+    for (int c = 0; c < METRIC_COUNTERS; c++)
+    {
+        out << "# TYPE postal_" << COUNTER_NAMES[c] << "_total counter\n"
+            << "postal_" << COUNTER_NAMES[c] << "_total " << counterTotals[c] << "\n";
+    }
+
+    // Prometheus buckets are cumulative and end with +Inf
+    out << "# HELP postal_lookup_latency_seconds Latency of single ZIP lookups (sampled).\n"
+        << "# TYPE postal_lookup_latency_seconds histogram\n";
+    for (int h = 0; h < METRIC_HISTOGRAMS; h++)
+    {
+        const HistogramTotals &totals = histogramTotals[h];
+        uint64_t cumulative = 0;
+        for (int b = 0; b < Metrics::BUCKETS - 1; b++)
+        {
+            cumulative += totals.buckets[b];
+            out << "postal_lookup_latency_seconds_bucket{lookup=\"" << HISTOGRAM_NAMES[h] << "\",le=\""
+                << (uint64_t(1) << b) / 1e9 << "\"} " << cumulative << "\n";
+        }
+        out << "postal_lookup_latency_seconds_bucket{lookup=\"" << HISTOGRAM_NAMES[h] << "\",le=\"+Inf\"} "
+            << totals.count << "\n"
+            << "postal_lookup_latency_seconds_sum{lookup=\"" << HISTOGRAM_NAMES[h] << "\"} "
+            << totals.sumNanos / 1e9 << "\n"
+            << "postal_lookup_latency_seconds_count{lookup=\"" << HISTOGRAM_NAMES[h] << "\"} "
+            << totals.count << "\n";
+    }
+}
+
+/**
+ * @brief Write every phase, counter and histogram.
+ * @param out    Where to write.
+ * @param format JSON or Prometheus text.
+ */
+void Metrics::write(ostream &out, MetricsFormat format)
+{
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision(9);
+    if (format == MetricsFormat::Prometheus)
+    {
+        writeMetricsPrometheus(out);
+    }
+    else
+    {
+        writeMetricsJSON(out);
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/**
+ * @brief Get the process CPU time used so far.
+ * @return Nanoseconds over all threads.
+ */
+uint64_t Metrics::cpuNanos()
+{
+#ifndef _WIN32
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+    return static_cast<uint64_t>(clock()) * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * @brief Start timing.
+ * @param phase The phase to add the time to.
+ */
+PhaseTimer::PhaseTimer(MetricPhase phase) : phase(phase), active(Metrics::isEnabled())
+{
+    if (active)
+    {
+        start = chrono::steady_clock::now();
+        cpuStart = Metrics::cpuNanos();
+    }
+}
+
+/**
+ * @brief Stop timing and add the phase run.
+ */
+PhaseTimer::~PhaseTimer()
+{
+    if (active)
+    {
+        chrono::nanoseconds wall = chrono::steady_clock::now() - start;
+        Metrics::addPhase(phase, wall.count(), Metrics::cpuNanos() - cpuStart);
+    }
+}
+
+/**
+ * @brief Start timing.
+ * @param histogram   The histogram to add the latency to.
+ * @param sampleEvery Time one lookup in this many (1 = every lookup).
+ */
+LatencyTimer::LatencyTimer(MetricHistogram histogram, unsigned sampleEvery)
+    : histogram(histogram), active(Metrics::isEnabled())
+{
+    if (active)
+    {
+        static thread_local unsigned tick = 0;
+        active = ++tick % sampleEvery == 0;
+    }
+    if (active)
+    {
+        start = chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief Stop timing and add the sample.
+ */
+LatencyTimer::~LatencyTimer()
+{
+    if (active)
+    {
+        chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+        Metrics::addLatency(histogram, elapsed.count());
+    }
+}
+
+/**
+ * @brief Recognize a --stats command-line flag and turn recording on.
+ * @param arg    One command-line argument.
+ * @param format Receives the format.
+ * @return true if @p arg was a --stats flag.
+ */
+bool parseStatsFlag(const string &arg, MetricsFormat &format)
+{
+    if (arg == "--stats" || arg == "--stats=json")
+    {
+        format = MetricsFormat::JSON;
+    }
+    else if (arg == "--stats=prometheus")
+    {
+        format = MetricsFormat::Prometheus;
+    }
+    else
+    {
+        return false;
+    }
+    Metrics::enable();
+    return true;
+}
@@ -0,0 +1,246 @@
+/**
+ * @file Metrics.h
+ * @brief Declares the process-wide phase timers, counters and latency histograms.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The loaders, PostalList, PostalSnapshot and make_index report what they do
+ * here: wall and CPU time per phase, bytes and rows, and lookup hits, misses
+ * and latencies. Everything is off until enable() is called (the drivers do
+ * it for --stats). While off, each hook is one relaxed atomic load and a
+ * branch, and no clock is read. The totals can be written as JSON or in the
+ * Prometheus text format.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief The timed phases of a run.
+ * @note Phases do not nest: a print walks a sort order that was built before
+ * its Output timer starts.
+ */
+enum class MetricPhase
+{
+    Read,       /**< Opening and mapping input files */
+    Parse,      /**< Splitting and converting rows (the serial loader also adds each row here, the parallel ones fill per-chunk columns) */
+    Insert,     /**< Merging the parsed chunks into a list (parallel loaders) */
+    Sort,       /**< Building the ZIP and state orders */
+    IndexBuild, /**< Building the ZIP table, the place index and index files */
+    Output,     /**< Writing result rows */
+    Count
+};
+
+/**
+ * @brief The event counters.
+ */
+enum class MetricCounter
+{
+    BytesRead,    /**< Bytes of input files opened for loading */
+    BytesWritten, /**< Bytes written by TableFormatter */
+    RowsLoaded,   /**< Rows added by the loaders */
+    RowsRejected, /**< Input lines that did not parse */
+    ZipHits,      /**< PostalList::findByZip calls that found a row */
+    ZipMisses,    /**< PostalList::findByZip calls that did not */
+    IndexHits,    /**< make_index lookups that found a record */
+    IndexMisses,  /**< make_index lookups that did not */
+    Count
+};
+
+/**
+ * @brief The latency histograms.
+ */
+enum class MetricHistogram
+{
+    ZipLookup,   /**< PostalList::findByZip (one call in 16 is timed) */
+    IndexLookup, /**< ZipIndexFile / ZipHashIndex find in make_index */
+    Count
+};
+
+/**
+ * @brief How Metrics::write() lays out the totals.
+ */
+enum class MetricsFormat
+{
+    JSON,
+    Prometheus
+};
+
+class Metrics
+{
+public:
+    /** Histogram buckets: bucket b counts latencies below 2^b nanoseconds; the last one takes the rest. */
+    static const int BUCKETS = 32;
+
+    /**
+     * @brief Turn recording on or off.
+     * @param enabled true to record from now on.
+     */
+    static void enable(bool enabled = true);
+
+    /**
+     * @brief Check whether recording is on.
+     * @return true after enable().
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Add to a counter (ignored while recording is off).
+     * @param counter The counter.
+     * @param amount  How much to add.
+     */
+    static void add(MetricCounter counter, uint64_t amount = 1);
+
+    /**
+     * @brief Add one timed run of a phase.
+     * @param phase     The phase.
+     * @param wallNanos Wall time in nanoseconds.
+     * @param cpuNanos  Process CPU time (all threads) in nanoseconds.
+     */
+    static void addPhase(MetricPhase phase, uint64_t wallNanos, uint64_t cpuNanos);
+
+    /**
+     * @brief Add one latency sample to a histogram.
+     * @param histogram The histogram.
+     * @param nanos     The latency in nanoseconds.
+     */
+    static void addLatency(MetricHistogram histogram, uint64_t nanos);
+
+    /**
+     * @brief Get a counter's total.
+     * @param counter The counter.
+     * @return Its value.
+     */
+    static uint64_t counter(MetricCounter counter);
+
+    /**
+     * @brief Get a phase's total wall time.
+     * @param phase The phase.
+     * @return Nanoseconds over all runs of the phase.
+     */
+    static uint64_t phaseWallNanos(MetricPhase phase);
+
+    /**
+     * @brief Get a phase's total CPU time.
+     * @param phase The phase.
+     * @return Nanoseconds of process CPU time over all runs of the phase.
+     */
+    static uint64_t phaseCpuNanos(MetricPhase phase);
+
+    /**
+     * @brief Get how many times a phase ran.
+     * @param phase The phase.
+     * @return The run count.
+     */
+    static uint64_t phaseRuns(MetricPhase phase);
+
+    /**
+     * @brief Get a latency percentile from a histogram.
+     * @param histogram The histogram.
+     * @param fraction  The percentile as a fraction, e.g. 0.99.
+     * @return The upper bound of the bucket that holds it, in nanoseconds (0 if empty).
+     */
+    static uint64_t latencyPercentile(MetricHistogram histogram, double fraction);
+
+    /**
+     * @brief Set every phase, counter and histogram back to zero.
+     */
+    static void reset();
+
+    /**
+     * @brief Write every phase, counter and histogram.
+     * @param out    Where to write.
+     * @param format JSON or Prometheus text.
+     */
+    static void write(ostream &out, MetricsFormat format);
+
+    /**
+     * @brief Get the process CPU time used so far.
+     * @return Nanoseconds over all threads.
+     */
+    static uint64_t cpuNanos();
+};
+
+/**
+ * @brief Times a phase from construction to destruction.
+ *
+ * Reads the clocks only while Metrics is enabled.
+ */
+class PhaseTimer
+{
+private:
+    MetricPhase phase;                      /**< The phase being timed */
+    bool active;                            /**< Whether the clocks were read at the start */
+    chrono::steady_clock::time_point start; /**< Wall time at the start */
+    uint64_t cpuStart = 0;                  /**< CPU time at the start */
+
+public:
+    /**
+     * @brief Start timing.
+     * @param phase The phase to add the time to.
+     */
+    explicit PhaseTimer(MetricPhase phase);
+
+    /**
+     * @brief Stop timing and add the phase run.
+     */
+    ~PhaseTimer();
+
+    PhaseTimer(const PhaseTimer &) = delete;
+    PhaseTimer &operator=(const PhaseTimer &) = delete;
+};
+
+/**
+ * @brief Times one lookup from construction to destruction into a latency histogram.
+ *
+ * Reads the clock only while Metrics is enabled, and then only for every
+ * sampleEvery-th timer on each thread: a clock read costs far more than a
+ * ZIP table probe, so the hottest lookups are sampled instead of all timed.
+ */
+class LatencyTimer
+{
+private:
+    MetricHistogram histogram;              /**< The histogram to add to */
+    bool active;                            /**< Whether the clock was read at the start */
+    chrono::steady_clock::time_point start; /**< Time at the start */
+
+public:
+    /**
+     * @brief Start timing.
+     * @param histogram   The histogram to add the latency to.
+     * @param sampleEvery Time one lookup in this many (1 = every lookup).
+     */
+    explicit LatencyTimer(MetricHistogram histogram, unsigned sampleEvery = 1);
+
+    /**
+     * @brief Stop timing and add the sample.
+     */
+    ~LatencyTimer();
+
+    LatencyTimer(const LatencyTimer &) = delete;
+    LatencyTimer &operator=(const LatencyTimer &) = delete;
+};
+
+/**
+ * @brief Recognize a --stats command-line flag and turn recording on.
+ * @param arg    One command-line argument.
+ * @param format Receives the format: "--stats" and "--stats=json" give JSON,
+ * "--stats=prometheus" gives Prometheus text.
+ * @return true if @p arg was a --stats flag.
+ */
+bool parseStatsFlag(const string &arg, MetricsFormat &format);
+
+#include "Metrics.cpp"
+#endif
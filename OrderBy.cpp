@@ -0,0 +1,321 @@
+/**
+ * @file OrderBy.cpp
+ * @brief Implementation of the normalized-key multi-column sort.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "OrderBy.h"
+#include "ParallelFor.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief A row's place in the sort: its first 8 key bytes as a number, and the row.
+ */
+struct SortKeyRef
+{
+    uint64_t prefix; /**< Key bytes 0-7, big-endian, so integer order is memcmp order */
+    uint32_t row;    /**< Row number; the full key is at row * width */
+};
+
+/**
+ * @brief Get the number of key bytes a column takes.
+ * @param column The column.
+ * @return 8 for the coordinates, 4 for the rest.
+ */
+size_t sortKeyBytes(SortColumn column)
+{
+    return (column == SortColumn::Latitude || column == SortColumn::Longitude) ? 8 : 4;
+}
+
+/**
+ * @brief Write the low @p bytes bytes of a value, most significant first.
+ * @param out   Where to write.
+ * @param value The value.
+ * @param bytes How many bytes to write (4 or 8).
+ */
+void writeBigEndian(uint8_t *out, uint64_t value, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - i)));
+    }
+}
+
+/**
+ * @brief Map a double to an unsigned integer with the same order.
+ * @param value The double.
+ * @return Positive values get their sign bit set, negative ones all bits
+ * flipped, so smaller doubles give smaller integers.
+ */
+uint64_t orderedBits(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof bits);
+    return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+/**
+ * @brief Parse an ORDER BY list such as "county, place, lat desc".
+ * @param text   Comma-separated columns, each optionally followed by "asc" or "desc".
+ * @param fields Receives the parsed columns, in order.
+ * @return false if a column or direction is unknown or the list is empty.
+ */
+bool parseOrderBy(string_view text, vector<SortField> &fields)
+{
+    fields.clear();
+    string lower(text);
+    for (char &c : lower)
+    {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+
+    size_t start = 0;
+    while (start <= lower.size())
+    {
+        size_t comma = lower.find(',', start);
+        if (comma == string::npos)
+        {
+            comma = lower.size();
+        }
+
+        // Split "name [asc|desc]" into words
+        vector<string> words;
+        size_t i = start;
+        while (i < comma)
+        {
+            while (i < comma && isspace(static_cast<unsigned char>(lower[i])))
+            {
+                i++;
+            }
+            size_t wordStart = i;
+            while (i < comma && !isspace(static_cast<unsigned char>(lower[i])))
+            {
+                i++;
+            }
+            if (i > wordStart)
+            {
+                words.push_back(lower.substr(wordStart, i - wordStart));
+            }
+        }
+        if (words.empty() || words.size() > 2)
+        {
+            return false;
+        }
+
+        SortField field;
+        const string &name = words[0];
+        if (name == "zip")
+        {
+            field.column = SortColumn::Zip;
+        }
+        else if (name == "place")
+        {
+            field.column = SortColumn::Place;
+        }
+        else if (name == "state")
+        {
+            field.column = SortColumn::State;
+        }
+        else if (name == "county")
+        {
+            field.column = SortColumn::County;
+        }
+        else if (name == "lat" || name == "latitude")
+        {
+            field.column = SortColumn::Latitude;
+        }
+        else if (name == "lon" || name == "longitude")
+        {
+            field.column = SortColumn::Longitude;
+        }
+        else
+        {
+            return false;
+        }
+        if (words.size() == 2)
+        {
+            if (words[1] == "desc")
+            {
+                field.descending = true;
+            }
+            else if (words[1] != "asc")
+            {
+                return false;
+            }
+        }
+        fields.push_back(field);
+        start = comma + 1;
+    }
+    return true;
+}
+
+/**
+ * @brief Sort the rows of @p columns by a list of columns.
+ * @param columns     The rows to sort.
+ * @param fields      The ORDER BY list; rows equal on every field keep their order.
+ * @param limit       Only the first @p limit rows are wanted (0 = all of them).
+ * @param rows        Receives min(limit, size) row numbers in order.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ */
+void orderRows(const PostalColumns &columns, const vector<SortField> &fields, size_t limit,
+               vector<uint32_t> &rows, unsigned threadCount)
+{
+    PhaseTimer timer(MetricPhase::Sort);
+    size_t count = columns.size();
+    size_t wanted = (limit == 0 || limit > count) ? count : limit;
+
+    // The rank tables are built lazily, so build them before any thread reads them
+    vector<const vector<uint32_t> *> ranks(fields.size(), nullptr);
+    size_t width = sizeof(uint32_t);
+    for (size_t f = 0; f < fields.size(); f++)
+    {
+        switch (fields[f].column)
+        {
+        case SortColumn::Place:
+            ranks[f] = &columns.placeDictionary().sortRanks();
+            break;
+        case SortColumn::State:
+            ranks[f] = &columns.stateDictionary().sortRanks();
+            break;
+        case SortColumn::County:
+            ranks[f] = &columns.countyDictionary().sortRanks();
+            break;
+        default:
+            break;
+        }
+        width += sortKeyBytes(fields[f].column);
+    }
+    // The prefix reads 8 bytes; a shorter key is padded with zeros
+    width = max(width, size_t(8));
+
+    // Small inputs are not worth the threads and the merge
+    unsigned threads = workerCount(threadCount);
+    size_t chunkCount = (threads == 1 || count < (size_t(1) << 16)) ? 1 : threads;
+    vector<size_t> bounds(chunkCount + 1);
+    for (size_t c = 0; c <= chunkCount; c++)
+    {
+        bounds[c] = count * c / chunkCount;
+    }
+
+    vector<uint8_t> keys(count * width);
+    vector<SortKeyRef> refs(count);
+    const uint8_t *keyData = keys.data();
+    auto less = [keyData, width](const SortKeyRef &a, const SortKeyRef &b)
+    {
+        if (a.prefix != b.prefix)
+        {
+            return a.prefix < b.prefix;
+        }
+        return memcmp(keyData + size_t(a.row) * width + 8, keyData + size_t(b.row) * width + 8, width - 8) < 0;
+    };
+
+    // Encode each chunk's keys and sort the chunk (or keep only its best `wanted`)
+    parallelFor(chunkCount, threads, [&](size_t chunk)
+                {
+                    for (size_t row = bounds[chunk]; row < bounds[chunk + 1]; row++)
+                    {
+                        uint8_t *key = keys.data() + row * width;
+                        uint8_t *out = key;
+                        for (size_t f = 0; f < fields.size(); f++)
+                        {
+                            uint64_t value = 0;
+                            switch (fields[f].column)
+                            {
+                            case SortColumn::Zip:
+                                value = static_cast<uint32_t>(columns.zipData()[row]) ^ 0x80000000u;
+                                break;
+                            case SortColumn::Place:
+                                value = (*ranks[f])[columns.placeIdData()[row]];
+                                break;
+                            case SortColumn::State:
+                                value = (*ranks[f])[columns.stateIdData()[row]];
+                                break;
+                            case SortColumn::County:
+                                value = (*ranks[f])[columns.countyIdData()[row]];
+                                break;
+                            case SortColumn::Latitude:
+                                value = orderedBits(columns.latitudeData()[row]);
+                                break;
+                            case SortColumn::Longitude:
+                                value = orderedBits(columns.longitudeData()[row]);
+                                break;
+                            }
+                            size_t bytes = sortKeyBytes(fields[f].column);
+                            writeBigEndian(out, fields[f].descending ? ~value : value, bytes);
+                            out += bytes;
+                        }
+                        // The row number breaks ties, so equal rows stay in list order
+                        writeBigEndian(out, row, sizeof(uint32_t));
+
+                        uint64_t prefix = 0;
+                        for (size_t i = 0; i < 8; i++)
+                        {
+                            prefix = (prefix << 8) | key[i];
+                        }
+                        refs[row] = {prefix, static_cast<uint32_t>(row)};
+                    }
+
+                    auto first = refs.begin() + bounds[chunk];
+                    auto last = refs.begin() + bounds[chunk + 1];
+                    if (wanted < count && static_cast<size_t>(last - first) > wanted)
+                    {
+                        partial_sort(first, first + wanted, last, less);
+                    }
+                    else
+                    {
+                        sort(first, last, less);
+                    }
+                });
+
+    if (wanted < count)
+    {
+        // Top-K: only each chunk's sorted best `wanted` can make the cut
+        if (chunkCount > 1)
+        {
+            size_t kept = 0;
+            for (size_t chunk = 0; chunk < chunkCount; chunk++)
+            {
+                size_t take = min(wanted, bounds[chunk + 1] - bounds[chunk]);
+                move(refs.begin() + bounds[chunk], refs.begin() + bounds[chunk] + take, refs.begin() + kept);
+                kept += take;
+            }
+            partial_sort(refs.begin(), refs.begin() + wanted, refs.begin() + kept, less);
+        }
+    }
+    else
+    {
+        // Merge sorted runs pairwise until one is left
+        vector<SortKeyRef> merged(count);
+        for (size_t runs = 1; runs < chunkCount; runs *= 2)
+        {
+            size_t pairs = (chunkCount + 2 * runs - 1) / (2 * runs);
+            parallelFor(pairs, threads, [&](size_t pair)
+                        {
+                            size_t lo = bounds[pair * 2 * runs];
+                            size_t mid = bounds[min(chunkCount, pair * 2 * runs + runs)];
+                            size_t hi = bounds[min(chunkCount, pair * 2 * runs + 2 * runs)];
+                            merge(refs.begin() + lo, refs.begin() + mid, refs.begin() + mid, refs.begin() + hi,
+                                  merged.begin() + lo, less);
+                        });
+            refs.swap(merged);
+        }
+    }
+
+    rows.resize(wanted);
+    for (size_t i = 0; i < wanted; i++)
+    {
+        rows[i] = refs[i].row;
+    }
+}
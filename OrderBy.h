@@ -0,0 +1,79 @@
+/**
+ * @file OrderBy.h
+ * @brief Declares a multi-column sort of postal rows through normalized keys.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * orderRows() sorts the rows of a PostalColumns by any list of columns, each
+ * ascending or descending, e.g. "county, place, lat desc". Every row is
+ * encoded once into a fixed-width byte key whose memcmp order is the wanted
+ * order: ZIP codes and coordinates are stored big-endian with their sign bits
+ * flipped, text columns as the dictionary's alphabetical rank, descending
+ * columns with every bit inverted, and the row number last so equal rows keep
+ * list order. The sort then compares the first 8 key bytes as one integer and
+ * only calls memcmp on a tie, and never reads a string. Chunks are sorted on
+ * several threads and merged; a limit turns it into a partial top-K sort.
+ */
+
+#ifndef ORDER_BY_H
+#define ORDER_BY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "PostalColumns.h"
+
+using namespace std;
+
+/**
+ * @brief The columns rows can be ordered by.
+ */
+enum class SortColumn
+{
+    Zip,
+    Place,
+    State,
+    County,
+    Latitude,
+    Longitude
+};
+
+/**
+ * @brief One column of an ORDER BY list.
+ */
+struct SortField
+{
+    SortColumn column;       /**< The column to compare */
+    bool descending = false; /**< true for largest (or last alphabetically) first */
+};
+
+/**
+ * @brief Parse an ORDER BY list such as "county, place, lat desc".
+ * @param text   Comma-separated columns, each optionally followed by "asc" or
+ * "desc". Columns: zip, place, state, county, lat/latitude, lon/longitude
+ * (case does not matter).
+ * @param fields Receives the parsed columns, in order.
+ * @return false if a column or direction is unknown or the list is empty.
+ */
+bool parseOrderBy(string_view text, vector<SortField> &fields);
+
+/**
+ * @brief Sort the rows of @p columns by a list of columns.
+ * @param columns     The rows to sort.
+ * @param fields      The ORDER BY list; rows equal on every field keep their order.
+ * @param limit       Only the first @p limit rows are wanted (0 = all of them).
+ * @param rows        Receives min(limit, size) row numbers in order; reuse it
+ * across calls so repeated sorts do not regrow it.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ * @note With a limit, each chunk keeps only its best @p limit keys before the
+ * final pass, so a "first N rows" request never fully sorts the data.
+ */
+void orderRows(const PostalColumns &columns, const vector<SortField> &fields, size_t limit,
+               vector<uint32_t> &rows, unsigned threadCount = 0);
+
+#include "OrderBy.cpp"
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file ParallelFor.cpp
+ * @brief Implementation of the parallelFor() task helper.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "ParallelFor.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Pick a worker count for parallel work.
+ * @param requested The count asked for, or 0 to use every hardware thread.
+ * @return A thread count of at least 1.
+ */
+unsigned workerCount(unsigned requested)
+{
+    if (requested > 0)
+    {
+        return requested;
+    }
+    unsigned hardware = thread::hardware_concurrency();
+    return (hardware > 0) ? hardware : 1;
+}
+
+/**
+ * @brief Run task(0) .. task(taskCount - 1), spread over a pool of threads.
+ * @param taskCount   How many tasks to run.
+ * @param threadCount How many threads to use (0 = one per hardware thread).
+ * @param task        The work for one task number.
+ */
+void parallelFor(size_t taskCount, unsigned threadCount, const function<void(size_t)> &task)
+{
+    size_t threads = workerCount(threadCount);
+    if (threads > taskCount)
+    {
+        threads = taskCount;
+    }
+
+    if (threads <= 1)
+    {
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    atomic<size_t> nextTask(0);
+    auto worker = [&]()
+    {
+        for (size_t i = nextTask++; i < taskCount; i = nextTask++)
+        {
+            task(i);
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+}
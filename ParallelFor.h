@@ -0,0 +1,40 @@
+/**
+ * @file ParallelFor.h
+ * @brief Declares a small helper that runs numbered tasks on a pool of threads.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The loaders split their input into chunks and hand each chunk number to
+ * parallelFor(). Workers take the next unclaimed task until none are left,
+ * so a slow chunk does not hold up the others.
+ */
+
+#ifndef PARALLEL_FOR_H
+#define PARALLEL_FOR_H
+
+#include <functional>
+
+using namespace std;
+
+/**
+ * @brief Pick a worker count for parallel work.
+ * @param requested The count asked for, or 0 to use every hardware thread.
+ * @return A thread count of at least 1.
+ */
+unsigned workerCount(unsigned requested);
+
+/**
+ * @brief Run task(0) .. task(taskCount - 1), spread over a pool of threads.
+ * @param taskCount   How many tasks to run.
+ * @param threadCount How many threads to use (0 = one per hardware thread).
+ * @param task        The work for one task number. It must be safe to call concurrently.
+ * @note The calling thread takes part in the work, and the call returns only
+ * after every task has finished. With one thread everything runs inline.
+ */
+void parallelFor(size_t taskCount, unsigned threadCount, const function<void(size_t)> &task);
+
+#include "ParallelFor.cpp"
+#endif
@@ -0,0 +1,211 @@
+/**
+ * @file PlaceIndex.cpp
+ * @brief Implementation of the PlaceIndex class and the case-insensitive helpers.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "PlaceIndex.h"
+#include "RadixSort.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Lower-case one ASCII letter; other bytes are unchanged.
+ * @param c The byte.
+ * @return The folded byte.
+ */
+unsigned char foldByte(char c)
+{
+    unsigned char u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + ('a' - 'A')) : u;
+}
+
+/**
+ * @brief Compare two strings, ignoring ASCII case.
+ * @param a First string.
+ * @param b Second string.
+ * @return Negative, zero or positive like strcmp.
+ */
+int compareFolded(string_view a, string_view b)
+{
+    size_t common = min(a.size(), b.size());
+    for (size_t i = 0; i < common; i++)
+    {
+        unsigned char x = foldByte(a[i]);
+        unsigned char y = foldByte(b[i]);
+        if (x != y)
+        {
+            return x < y ? -1 : 1;
+        }
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+/**
+ * @brief Check whether a name starts with a prefix, ignoring ASCII case.
+ * @param name   The name.
+ * @param prefix The prefix.
+ * @return true if it does.
+ */
+bool hasFoldedPrefix(string_view name, string_view prefix)
+{
+    return name.size() >= prefix.size() && compareFolded(name.substr(0, prefix.size()), prefix) == 0;
+}
+
+/**
+ * @brief Find the run of sorted names that start with a prefix.
+ * @param sortedIds Name ids in case-insensitive order.
+ * @param count     Number of ids.
+ * @param nameOf    Gives the name of an id.
+ * @param prefix    The prefix.
+ * @return First and one-past-last position in @p sortedIds.
+ */
+template <typename NameOf>
+pair<uint32_t, uint32_t> findFoldedPrefix(const uint32_t *sortedIds, uint32_t count, NameOf nameOf, string_view prefix)
+{
+    // Names before the run compare below the prefix; names after it do not start with it
+    const uint32_t *end = sortedIds + count;
+    const uint32_t *first = partition_point(sortedIds, end, [&](uint32_t id)
+                                            { return compareFolded(nameOf(id), prefix) < 0; });
+    const uint32_t *last = partition_point(first, end, [&](uint32_t id)
+                                           { return hasFoldedPrefix(nameOf(id), prefix); });
+    return {static_cast<uint32_t>(first - sortedIds), static_cast<uint32_t>(last - sortedIds)};
+}
+
+/**
+ * @brief Build the index for some columns.
+ * @param columns  The records.
+ * @param zipOrder The rows sorted by ZIP, equal ZIP codes in row order.
+ */
+void PlaceIndex::build(const PostalColumns &columns, const uint32_t *zipOrder)
+{
+    // Names that differ only in case are kept apart, in byte order, so the order is fixed
+    const StringDictionary &names = columns.placeDictionary();
+    sortedIds.resize(names.size());
+    for (uint32_t id = 0; id < sortedIds.size(); id++)
+    {
+        sortedIds[id] = id;
+    }
+    sort(sortedIds.begin(), sortedIds.end(), [&](uint32_t a, uint32_t b)
+         {
+             int order = compareFolded(names.at(a), names.at(b));
+             return order != 0 ? order < 0 : names.at(a) < names.at(b);
+         });
+    vector<uint32_t> rank(sortedIds.size());
+    for (uint32_t i = 0; i < sortedIds.size(); i++)
+    {
+        rank[sortedIds[i]] = i;
+    }
+
+    // Stable-sort the ZIP order by name rank, as PostalList does for states
+    const uint32_t *placeIds = columns.placeIdData();
+    rows.assign(zipOrder, zipOrder + columns.size());
+    vector<uint32_t> keys(rows.size());
+    starts.assign(sortedIds.size() + 1, 0);
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        keys[i] = rank[placeIds[rows[i]]];
+        starts[keys[i] + 1]++;
+    }
+    radixSortRows(rows, keys);
+    for (size_t i = 1; i < starts.size(); i++)
+    {
+        starts[i] += starts[i - 1];
+    }
+}
+
+/**
+ * @brief Suggest places whose name starts with a prefix.
+ * @param columns The records the index was built for.
+ * @param prefix  The typed text; case does not matter.
+ * @param limit   The most suggestions to return.
+ * @param state   Only suggest places in this state; "" for any state.
+ * @param out     Receives the suggestions by place name and then ZIP.
+ */
+void PlaceIndex::complete(const PostalColumns &columns, string_view prefix, size_t limit, string_view state,
+                          vector<PlaceMatch> &out) const
+{
+    out.clear();
+    if (starts.empty())
+    {
+        return;
+    }
+    uint32_t stateId = StringDictionary::npos;
+    if (!state.empty())
+    {
+        stateId = columns.stateDictionary().find(state);
+        if (stateId == StringDictionary::npos)
+        {
+            return;
+        }
+    }
+
+    const StringDictionary &names = columns.placeDictionary();
+    auto found = findFoldedPrefix(sortedIds.data(), static_cast<uint32_t>(sortedIds.size()),
+                                  [&](uint32_t id) -> string_view
+                                  { return names.at(id); },
+                                  prefix);
+    const uint32_t *states = columns.stateIdData();
+    for (uint32_t i = starts[found.first]; i < starts[found.second] && out.size() < limit; i++)
+    {
+        uint32_t row = rows[i];
+        if (stateId == StringDictionary::npos || states[row] == stateId)
+        {
+            out.push_back({columns.place(row), columns.state(row), columns.zipData()[row], row});
+        }
+    }
+}
+
+/**
+ * @brief Get the place ids in case-insensitive name order.
+ * @return One id per distinct place name.
+ */
+const vector<uint32_t> &PlaceIndex::placeIds() const
+{
+    return sortedIds;
+}
+
+/**
+ * @brief Get where each name's rows start.
+ * @return placeIds().size() + 1 positions in rowOrder().
+ */
+const vector<uint32_t> &PlaceIndex::rowStarts() const
+{
+    return starts;
+}
+
+/**
+ * @brief Get every row by place name and then ZIP.
+ * @return One entry per row.
+ */
+const vector<uint32_t> &PlaceIndex::rowOrder() const
+{
+    return rows;
+}
+
+/**
+ * @brief Remove everything.
+ */
+void PlaceIndex::clear()
+{
+    sortedIds.clear();
+    starts.clear();
+    rows.clear();
+}
+
+/**
+ * @brief Estimate the memory the index uses.
+ * @return Bytes of heap memory for the three arrays.
+ */
+size_t PlaceIndex::memoryBytes() const
+{
+    return (sortedIds.capacity() + starts.capacity() + rows.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file PlaceIndex.h
+ * @brief Defines the PlaceIndex class, a case-insensitive place-name prefix index.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The distinct place names are kept in an array sorted without regard to
+ * case, so every name starting with "holts" sits in one run that two binary
+ * searches find. Next to it, every row is listed by place name and then by
+ * ZIP code, and starts[i] says where the rows of the i-th name begin: the
+ * rows for a whole run of names are one contiguous slice of that list.
+ */
+
+#ifndef PLACE_INDEX_H
+#define PLACE_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "PostalColumns.h"
+
+using namespace std;
+
+/**
+ * @brief One autocomplete suggestion.
+ * @note The views point into the list's (or snapshot's) string pools.
+ */
+struct PlaceMatch
+{
+    string_view place; /**< Place name as stored */
+    string_view state; /**< State abbreviation */
+    int zip;           /**< ZIP code */
+    uint32_t row;      /**< Row number, for getItem() */
+};
+
+/**
+ * @brief Lower-case one ASCII letter; other bytes are unchanged.
+ * @param c The byte.
+ * @return The folded byte.
+ */
+unsigned char foldByte(char c);
+
+/**
+ * @brief Compare two strings, ignoring ASCII case.
+ * @param a First string.
+ * @param b Second string.
+ * @return Negative, zero or positive like strcmp.
+ */
+int compareFolded(string_view a, string_view b);
+
+/**
+ * @brief Check whether a name starts with a prefix, ignoring ASCII case.
+ * @param name   The name.
+ * @param prefix The prefix.
+ * @return true if it does.
+ */
+bool hasFoldedPrefix(string_view name, string_view prefix);
+
+/**
+ * @brief Find the run of sorted names that start with a prefix.
+ * @param sortedIds Name ids in case-insensitive order.
+ * @param count     Number of ids.
+ * @param nameOf    Gives the name of an id.
+ * @param prefix    The prefix ("" matches every name).
+ * @return First and one-past-last position in @p sortedIds.
+ */
+template <typename NameOf>
+pair<uint32_t, uint32_t> findFoldedPrefix(const uint32_t *sortedIds, uint32_t count, NameOf nameOf, string_view prefix);
+
+class PlaceIndex
+{
+private:
+    vector<uint32_t> sortedIds; /**< Place ids in case-insensitive name order */
+    vector<uint32_t> starts;    /**< sortedIds.size() + 1 positions in rows; name i owns rows[starts[i], starts[i + 1]) */
+    vector<uint32_t> rows;      /**< Every row, by place name and then ZIP */
+
+public:
+    PlaceIndex() = default;
+
+    /**
+     * @brief Build the index for some columns.
+     * @param columns  The records.
+     * @param zipOrder The rows sorted by ZIP, equal ZIP codes in row order.
+     * @note O(P log P) for P distinct names plus a radix sort of the rows.
+     */
+    void build(const PostalColumns &columns, const uint32_t *zipOrder);
+
+    /**
+     * @brief Suggest places whose name starts with a prefix.
+     * @param columns The records the index was built for.
+     * @param prefix  The typed text, e.g. "holts"; case does not matter.
+     * @param limit   The most suggestions to return.
+     * @param state   Only suggest places in this state; "" for any state.
+     * @param out     Receives the suggestions by place name and then ZIP (cleared first).
+     * @note O(log P) to find the names; then only the suggestions returned,
+     * plus any rows skipped by the state filter, are read.
+     */
+    void complete(const PostalColumns &columns, string_view prefix, size_t limit, string_view state,
+                  vector<PlaceMatch> &out) const;
+
+    /**
+     * @brief Get the place ids in case-insensitive name order.
+     * @return One id per distinct place name.
+     */
+    const vector<uint32_t> &placeIds() const;
+
+    /**
+     * @brief Get where each name's rows start.
+     * @return placeIds().size() + 1 positions in rowOrder().
+     */
+    const vector<uint32_t> &rowStarts() const;
+
+    /**
+     * @brief Get every row by place name and then ZIP.
+     * @return One entry per row.
+     */
+    const vector<uint32_t> &rowOrder() const;
+
+    /**
+     * @brief Remove everything.
+     */
+    void clear();
+
+    /**
+     * @brief Estimate the memory the index uses.
+     * @return Bytes of heap memory for the three arrays.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "PlaceIndex.cpp"
+#endif
@@ -0,0 +1,637 @@
+/**
+ * @file PostalBlockFile.cpp
+ * @brief Implementation of the PostalBlockFile class and the block file writer.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "PostalBlockFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+const char BLOCK_FILE_MAGIC[8] = {'Z', 'I', 'P', 'B', 'L', 'K', '\0', '\0'};
+const uint32_t BLOCK_FILE_BYTE_ORDER = 0x01020304;
+const uint32_t MAX_BLOCK_BYTES = 1u << 24; /**< open() rejects blocks that claim to be larger */
+
+/**
+ * @brief Append an unsigned number 7 bits per byte, low bits first (a varint).
+ */
+void appendVarint(string &out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Read one varint of up to 64 bits; false if it runs past @p end or is too long.
+ */
+bool readVarint(const char *&at, const char *end, uint64_t &value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && at < end; shift += 7)
+    {
+        unsigned char byte = static_cast<unsigned char>(*at++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Read one varint that must fit in 32 bits; false if it does not.
+ */
+bool readVarint(const char *&at, const char *end, uint32_t &value)
+{
+    uint64_t wide = 0;
+    if (!readVarint(at, end, wide) || wide > UINT32_MAX)
+    {
+        return false;
+    }
+    value = static_cast<uint32_t>(wide);
+    return true;
+}
+
+/**
+ * @brief Append doubles as 8 byte planes: byte 0 of every value, then byte 1, and so on.
+ */
+void appendBytePlanes(string &out, const vector<double> &values)
+{
+    size_t start = out.size();
+    out.resize(start + values.size() * sizeof(double));
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        unsigned char bytes[sizeof(double)];
+        memcpy(bytes, &values[i], sizeof(double));
+        for (size_t plane = 0; plane < sizeof(double); plane++)
+        {
+            out[start + plane * values.size() + i] = static_cast<char>(bytes[plane]);
+        }
+    }
+}
+
+/**
+ * @brief Read @p count doubles stored as byte planes.
+ */
+void readBytePlanes(const char *planes, size_t count, vector<double> &values)
+{
+    values.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char bytes[sizeof(double)];
+        for (size_t plane = 0; plane < sizeof(double); plane++)
+        {
+            bytes[plane] = static_cast<unsigned char>(planes[plane * count + i]);
+        }
+        memcpy(&values[i], bytes, sizeof(double));
+    }
+}
+
+/**
+ * @brief Find the fewest decimal places that give back every coordinate exactly.
+ * @return d such that value == round(value * 10^d) / 10^d for all values, or -1 if no d <= 9 works.
+ */
+int coordinateDecimals(const vector<double> &latitudes, const vector<double> &longitudes)
+{
+    double scale = 1;
+    for (int decimals = 0; decimals <= 9; decimals++, scale *= 10)
+    {
+        bool exact = true;
+        for (const vector<double> *values : {&latitudes, &longitudes})
+        {
+            for (size_t i = 0; exact && i < values->size(); i++)
+            {
+                double value = (*values)[i];
+                exact = fabs(value) < 1e6 && static_cast<double>(llround(value * scale)) / scale == value;
+            }
+        }
+        if (exact)
+        {
+            return decimals;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Append coordinates as varint deltas of value * 10^decimals (zigzag-coded for sign).
+ */
+void appendScaled(string &out, const vector<double> &values, double scale)
+{
+    int64_t previous = 0;
+    for (double value : values)
+    {
+        int64_t scaled = llround(value * scale);
+        int64_t delta = scaled - previous;
+        // Zigzag-coded to 64 bits: with 8 or 9 decimals a delta does not fit in 32
+        appendVarint(out, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        previous = scaled;
+    }
+}
+
+/**
+ * @brief Read @p count coordinates written by appendScaled(); false if the bytes run out.
+ */
+bool readScaled(const char *&at, const char *end, size_t count, double scale, vector<double> &values)
+{
+    values.resize(count);
+    int64_t previous = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t zigzag = 0;
+        if (!readVarint(at, end, zigzag))
+        {
+            return false;
+        }
+        previous += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        values[i] = static_cast<double>(previous) / scale;
+    }
+    return true;
+}
+
+/**
+ * @brief Create a closed block file.
+ */
+PostalBlockFile::PostalBlockFile()
+{
+    header = nullptr;
+    blocks = nullptr;
+}
+
+/**
+ * @brief Write a list as a block file.
+ * @param fileName   Where to write it (replaced if it exists).
+ * @param list       The records; they are written in ZIP order.
+ * @param blockBytes Target size of a block before compression (coordinates counted as raw doubles).
+ * @return true if the whole file was written.
+ */
+bool PostalBlockFile::write(const string &fileName, const PostalList &list, size_t blockBytes)
+{
+    const PostalColumns &columns = list.getColumns();
+    ItemRange byZip = list.sortedByZip();
+
+    BlockFileHeader head = {};
+    memcpy(head.magic, BLOCK_FILE_MAGIC, sizeof(head.magic));
+    head.version = BLOCK_FILE_VERSION;
+    head.byteOrder = BLOCK_FILE_BYTE_ORDER;
+    head.rowCount = byZip.size();
+    head.stateCount = static_cast<uint32_t>(columns.stateDictionary().size());
+    head.countyCount = static_cast<uint32_t>(columns.countyDictionary().size());
+
+    string body;
+    vector<BlockIndexEntry> index;
+    string zipColumn, stateColumn, countyColumn, lengthColumn, placeColumn, raw;
+    vector<double> latitudes, longitudes;
+    vector<char> compressed;
+    BlockIndexEntry entry = {};
+
+    auto flushBlock = [&]()
+    {
+        raw = zipColumn + stateColumn + countyColumn + lengthColumn + placeColumn;
+        int decimals = coordinateDecimals(latitudes, longitudes);
+        raw.push_back(static_cast<char>(decimals));
+        if (decimals >= 0)
+        {
+            appendScaled(raw, latitudes, pow(10.0, decimals));
+            appendScaled(raw, longitudes, pow(10.0, decimals));
+        }
+        else
+        {
+            appendBytePlanes(raw, latitudes);
+            appendBytePlanes(raw, longitudes);
+        }
+
+        compressed.resize(lz4CompressBound(raw.size()));
+        size_t packed = lz4Compress(raw.data(), raw.size(), compressed.data());
+        entry.rawSize = static_cast<uint32_t>(raw.size());
+        entry.offset = sizeof(BlockFileHeader) + body.size();
+        if (packed < raw.size())
+        {
+            entry.compressedSize = static_cast<uint32_t>(packed);
+            body.append(compressed.data(), packed);
+        }
+        else
+        {
+            entry.compressedSize = entry.rawSize; // not worth compressing: stored as is
+            body += raw;
+        }
+        index.push_back(entry);
+
+        entry = {};
+        zipColumn.clear();
+        stateColumn.clear();
+        countyColumn.clear();
+        lengthColumn.clear();
+        placeColumn.clear();
+        latitudes.clear();
+        longitudes.clear();
+    };
+
+    for (size_t n = 0; n < byZip.size(); n++)
+    {
+        uint32_t row = byZip.indexAt(n);
+        int zip = columns.zipData()[row];
+
+        // Start a new block once this one is full, but keep equal ZIP codes together
+        size_t pending = zipColumn.size() + stateColumn.size() + countyColumn.size() + lengthColumn.size() +
+                         placeColumn.size() + 2 * sizeof(double) * latitudes.size();
+        if (entry.rowCount > 0 && pending >= blockBytes && zip != entry.lastZip)
+        {
+            flushBlock();
+        }
+        if (entry.rowCount == 0)
+        {
+            entry.firstZip = zip;
+            entry.lastZip = zip;
+        }
+
+        string_view place = columns.place(row);
+        appendVarint(zipColumn, static_cast<uint32_t>(zip - entry.lastZip));
+        appendVarint(stateColumn, columns.stateIdData()[row]);
+        appendVarint(countyColumn, columns.countyIdData()[row]);
+        appendVarint(lengthColumn, static_cast<uint32_t>(place.size()));
+        placeColumn.append(place.data(), place.size());
+        latitudes.push_back(columns.latitudeData()[row]);
+        longitudes.push_back(columns.longitudeData()[row]);
+        entry.lastZip = zip;
+        entry.rowCount++;
+    }
+    if (entry.rowCount > 0)
+    {
+        flushBlock();
+    }
+    for (const auto &block : index)
+    {
+        head.rawBytes += block.rawSize;
+    }
+    head.blockCount = static_cast<uint32_t>(index.size());
+
+    // Dictionaries, each on an 8-byte boundary, then the index
+    auto appendDictionary = [&](const StringDictionary &strings)
+    {
+        body.append((8 - (sizeof(BlockFileHeader) + body.size()) % 8) % 8, '\0');
+        uint64_t start = sizeof(BlockFileHeader) + body.size();
+        vector<uint32_t> offsets(1, 0);
+        string pool;
+        for (uint32_t id = 0; id < strings.size(); id++)
+        {
+            pool += strings.at(id);
+            offsets.push_back(static_cast<uint32_t>(pool.size()));
+        }
+        body.append(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        body += pool;
+        return start;
+    };
+    head.stateOffset = appendDictionary(columns.stateDictionary());
+    head.countyOffset = appendDictionary(columns.countyDictionary());
+    body.append((8 - (sizeof(BlockFileHeader) + body.size()) % 8) % 8, '\0');
+    head.indexOffset = sizeof(BlockFileHeader) + body.size();
+    body.append(reinterpret_cast<const char *>(index.data()), index.size() * sizeof(BlockIndexEntry));
+    head.fileSize = sizeof(BlockFileHeader) + body.size();
+
+    return replaceFile(fileName, {string_view(reinterpret_cast<const char *>(&head), sizeof(head)), body});
+}
+
+/**
+ * @brief Get the usual block file name for a source file.
+ * @param sourceName e.g. "us_postal_codes.csv".
+ * @return The name with its extension replaced by ".zblk".
+ */
+string PostalBlockFile::nameFor(const string &sourceName)
+{
+    size_t dot = sourceName.find_last_of('.');
+    size_t slash = sourceName.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+    {
+        return sourceName + ".zblk";
+    }
+    return sourceName.substr(0, dot) + ".zblk";
+}
+
+/**
+ * @brief Map a block file and check its header, dictionaries and index.
+ * @param fileName The block file.
+ * @return true if it is a version-1 block file whose parts all fit in it.
+ */
+bool PostalBlockFile::open(const string &fileName)
+{
+    close();
+    if (!file.open(fileName) || file.size() < sizeof(BlockFileHeader))
+    {
+        close();
+        return false;
+    }
+
+    const BlockFileHeader *head = reinterpret_cast<const BlockFileHeader *>(file.data());
+    const uint64_t size = file.size();
+    bool valid = memcmp(head->magic, BLOCK_FILE_MAGIC, sizeof(head->magic)) == 0 &&
+                 head->version == BLOCK_FILE_VERSION &&
+                 head->byteOrder == BLOCK_FILE_BYTE_ORDER &&
+                 head->fileSize == size &&
+                 head->indexOffset % 8 == 0 && head->indexOffset <= size &&
+                 (size - head->indexOffset) == head->blockCount * uint64_t(sizeof(BlockIndexEntry));
+
+    // Each dictionary's offsets must count up and stay inside the file
+    auto validDictionary = [&](uint64_t start, uint32_t count)
+    {
+        if (start % 8 != 0 || start > head->indexOffset ||
+            (head->indexOffset - start) / sizeof(uint32_t) < count + 1ull)
+        {
+            return false;
+        }
+        const uint32_t *offsets = reinterpret_cast<const uint32_t *>(file.data() + start);
+        uint64_t poolStart = start + (count + 1ull) * sizeof(uint32_t);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (offsets[i] > offsets[i + 1])
+            {
+                return false;
+            }
+        }
+        return offsets[0] == 0 && poolStart + offsets[count] <= head->indexOffset;
+    };
+    valid = valid && validDictionary(head->stateOffset, head->stateCount) &&
+            validDictionary(head->countyOffset, head->countyCount);
+
+    // Blocks must sit between the header and the dictionaries, in ZIP order, and add up to rowCount
+    if (valid)
+    {
+        const BlockIndexEntry *index = reinterpret_cast<const BlockIndexEntry *>(file.data() + head->indexOffset);
+        uint64_t rows = 0;
+        uint64_t blockEnd = min(head->stateOffset, head->countyOffset);
+        for (uint32_t b = 0; valid && b < head->blockCount; b++)
+        {
+            valid = index[b].offset >= sizeof(BlockFileHeader) && index[b].offset <= blockEnd &&
+                    index[b].compressedSize <= blockEnd - index[b].offset &&
+                    index[b].rawSize <= MAX_BLOCK_BYTES && index[b].compressedSize <= index[b].rawSize &&
+                    index[b].rowCount > 0 && index[b].firstZip <= index[b].lastZip &&
+                    (b == 0 || index[b - 1].lastZip < index[b].firstZip);
+            rows += index[b].rowCount;
+        }
+        valid = valid && rows == head->rowCount;
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+    header = head;
+    blocks = reinterpret_cast<const BlockIndexEntry *>(file.data() + head->indexOffset);
+    return true;
+}
+
+/**
+ * @brief Unmap the file.
+ */
+void PostalBlockFile::close()
+{
+    file.close();
+    header = nullptr;
+    blocks = nullptr;
+}
+
+/**
+ * @brief Check whether a block file is open.
+ * @return true after a successful open().
+ */
+bool PostalBlockFile::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Get the number of records.
+ * @return The row count (0 when closed).
+ */
+size_t PostalBlockFile::size() const
+{
+    return isOpen() ? header->rowCount : 0;
+}
+
+/**
+ * @brief Get the number of blocks.
+ * @return The block count (0 when closed).
+ */
+size_t PostalBlockFile::blockCount() const
+{
+    return isOpen() ? header->blockCount : 0;
+}
+
+/**
+ * @brief Get the size of the file.
+ * @return Bytes (0 when closed).
+ */
+size_t PostalBlockFile::fileBytes() const
+{
+    return isOpen() ? file.size() : 0;
+}
+
+/**
+ * @brief Look up string @p id of the dictionary at @p offset ("" if out of range).
+ */
+string_view PostalBlockFile::dictionaryText(uint64_t offset, uint32_t count, uint32_t id) const
+{
+    if (id >= count)
+    {
+        return string_view();
+    }
+    const uint32_t *bounds = reinterpret_cast<const uint32_t *>(file.data() + offset);
+    const char *pool = file.data() + offset + (count + 1ull) * sizeof(uint32_t);
+    return string_view(pool + bounds[id], bounds[id + 1] - bounds[id]);
+}
+
+/**
+ * @brief Decompress one block and split it into its columns.
+ * @param block   The block number.
+ * @param decoded Receives the columns (its buffers are reused).
+ * @return false if the block is damaged.
+ */
+bool PostalBlockFile::decodeBlock(size_t block, DecodedBlock &decoded) const
+{
+    const BlockIndexEntry &entry = blocks[block];
+    const char *stored = file.data() + entry.offset;
+    decoded.raw.resize(entry.rawSize);
+    if (entry.compressedSize == entry.rawSize)
+    {
+        memcpy(&decoded.raw[0], stored, entry.rawSize);
+    }
+    else if (!lz4Decompress(stored, entry.compressedSize, &decoded.raw[0], entry.rawSize))
+    {
+        return false;
+    }
+
+    size_t rows = entry.rowCount;
+    const char *at = decoded.raw.data();
+    const char *end = at + decoded.raw.size();
+    decoded.zips.resize(rows);
+    decoded.states.resize(rows);
+    decoded.counties.resize(rows);
+    decoded.places.resize(rows);
+
+    uint32_t value = 0;
+    int64_t zip = entry.firstZip;
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (!readVarint(at, end, value))
+        {
+            return false;
+        }
+        zip += value;
+        decoded.zips[i] = static_cast<int32_t>(zip);
+    }
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (!readVarint(at, end, decoded.states[i]))
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (!readVarint(at, end, decoded.counties[i]))
+        {
+            return false;
+        }
+    }
+    vector<uint32_t> lengths(rows);
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (!readVarint(at, end, lengths[i]))
+        {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < rows; i++)
+    {
+        if (lengths[i] > static_cast<size_t>(end - at))
+        {
+            return false;
+        }
+        decoded.places[i] = string_view(at, lengths[i]);
+        at += lengths[i];
+    }
+
+    if (at == end || zip != entry.lastZip)
+    {
+        return false;
+    }
+    signed char decimals = static_cast<signed char>(*at++);
+    if (decimals < 0)
+    {
+        if (static_cast<size_t>(end - at) != 2 * rows * sizeof(double))
+        {
+            return false;
+        }
+        readBytePlanes(at, rows, decoded.latitudes);
+        readBytePlanes(at + rows * sizeof(double), rows, decoded.longitudes);
+        return true;
+    }
+    double scale = pow(10.0, decimals);
+    return decimals <= 9 && readScaled(at, end, rows, scale, decoded.latitudes) &&
+           readScaled(at, end, rows, scale, decoded.longitudes) && at == end;
+}
+
+/**
+ * @brief Build the BlockRow of one decoded row.
+ */
+BlockRow PostalBlockFile::rowOf(const DecodedBlock &decoded, size_t row) const
+{
+    return {decoded.zips[row], decoded.places[row],
+            dictionaryText(header->stateOffset, header->stateCount, decoded.states[row]),
+            dictionaryText(header->countyOffset, header->countyCount, decoded.counties[row]),
+            decoded.latitudes[row], decoded.longitudes[row]};
+}
+
+/**
+ * @brief Look up a ZIP code, decompressing only the block that can hold it.
+ * @param zip  The ZIP code.
+ * @param item Receives the first record with that ZIP code.
+ * @return true if it was found.
+ */
+bool PostalBlockFile::find(int zip, PostalCodeItem &item) const
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+    const BlockIndexEntry *last = blocks + header->blockCount;
+    const BlockIndexEntry *block = lower_bound(blocks, last, zip, [](const BlockIndexEntry &entry, int key)
+                                               {
+                                                   return entry.lastZip < key;
+                                               });
+    if (block == last || block->firstZip > zip)
+    {
+        return false;
+    }
+
+    DecodedBlock decoded;
+    if (!decodeBlock(block - blocks, decoded))
+    {
+        return false;
+    }
+    auto found = lower_bound(decoded.zips.begin(), decoded.zips.end(), zip);
+    if (found == decoded.zips.end() || *found != zip)
+    {
+        return false;
+    }
+    BlockRow row = rowOf(decoded, found - decoded.zips.begin());
+    item = PostalCodeItem(row.zip, row.place, row.state, row.county, row.latitude, row.longitude);
+    return true;
+}
+
+/**
+ * @brief Visit every record in ZIP order, one block at a time.
+ * @param visit Called once per record.
+ * @return false if a block is damaged.
+ */
+bool PostalBlockFile::scan(const function<void(const BlockRow &)> &visit) const
+{
+    DecodedBlock decoded;
+    for (size_t b = 0; b < blockCount(); b++)
+    {
+        if (!decodeBlock(b, decoded))
+        {
+            return false;
+        }
+        for (size_t row = 0; row < decoded.zips.size(); row++)
+        {
+            visit(rowOf(decoded, row));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Add every record to a list.
+ * @param list The list to append to.
+ * @return The number of records added, or -1 if a block is damaged.
+ */
+int PostalBlockFile::addTo(PostalList &list) const
+{
+    int added = 0;
+    bool intact = scan([&](const BlockRow &row)
+                       {
+                           // The row's names live in the decoded block until the visit returns; addItem copies them
+                           list.addItem(PostalCodeItem::withSharedStrings(row.zip, row.place, row.state, row.county,
+                                                                          row.latitude, row.longitude));
+                           added++;
+                       });
+    return intact ? added : -1;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file PostalBlockFile.h
+ * @brief Defines the PostalBlockFile class, a compressed, block-indexed copy of a postal list.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The length-indicated text file spends most of its bytes on repeated state
+ * and county names and on digits. A block file keeps the records sorted by
+ * ZIP code in blocks of about 64 KiB (before compression). Inside a block
+ * each field is stored as its own column: ZIP codes as the difference from
+ * the previous one, states and counties as numbers into one dictionary for
+ * the whole file, and latitudes and longitudes as whole numbers of their
+ * last decimal place (40.8154 -> 408154), again as differences, whenever
+ * that gives every value back exactly. The block is then compressed with LZ4.
+ *
+ * A small index holds the first and last ZIP code of every block, so a point
+ * lookup decompresses one block. A full scan decompresses the blocks in file
+ * order, one at a time, and reads far fewer bytes from disk than the text.
+ *
+ * File layout (version 1, little-endian):
+ * - BlockFileHeader: magic "ZIPBLK\0\0", version, byte-order mark, file
+ *   size, row count, total decompressed bytes, block, state and county
+ *   counts, and where the dictionaries and the block index start.
+ * - The compressed blocks, back to back. Equal ZIP codes never straddle two
+ *   blocks. A block whose compressed size equals its raw size is stored as is.
+ * - State and county dictionaries: count + 1 uint32 offsets into a byte
+ *   pool, then the pool (each dictionary starts on an 8-byte boundary).
+ * - blockCount BlockIndexEntry records, in ZIP order.
+ *
+ * Block contents, with n = the block's row count: n varint ZIP deltas (the
+ * first from the block's first ZIP), n varint state ids, n varint county ids,
+ * n varint place name lengths, the place name bytes, then one byte d. If d
+ * is 0 .. 9, the n latitudes and then the n longitudes follow as 64-bit zigzag
+ * varint differences of value * 10^d; if d is -1, they follow as raw doubles
+ * in 8 byte planes (byte 0 of every value, then byte 1, ...).
+ */
+
+#ifndef POSTAL_BLOCK_FILE_H
+#define POSTAL_BLOCK_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "MappedFile.h"
+#include "PostalList.h"
+#include "Lz4.h"
+
+using namespace std;
+
+/**
+ * @brief The fixed header at the start of a block file.
+ */
+struct BlockFileHeader
+{
+    char magic[8];         /**< "ZIPBLK\0\0" */
+    uint32_t version;      /**< BLOCK_FILE_VERSION */
+    uint32_t byteOrder;    /**< 0x01020304 as written by this machine */
+    uint64_t fileSize;     /**< Total bytes, header included */
+    uint64_t rowCount;     /**< Number of records */
+    uint64_t rawBytes;     /**< Sum of the blocks' decompressed sizes */
+    uint32_t blockCount;   /**< Number of blocks (and index entries) */
+    uint32_t stateCount;   /**< Distinct states */
+    uint32_t countyCount;  /**< Distinct counties */
+    uint32_t reserved;     /**< Zero */
+    uint64_t stateOffset;  /**< Start of the state dictionary */
+    uint64_t countyOffset; /**< Start of the county dictionary */
+    uint64_t indexOffset;  /**< Start of the block index */
+};
+
+/**
+ * @brief One block index entry.
+ */
+struct BlockIndexEntry
+{
+    int32_t firstZip;        /**< Smallest ZIP code in the block */
+    int32_t lastZip;         /**< Largest ZIP code in the block */
+    uint32_t rowCount;       /**< Records in the block */
+    uint32_t rawSize;        /**< Decompressed size in bytes */
+    uint64_t offset;         /**< Where the compressed block starts in the file */
+    uint32_t compressedSize; /**< Its size in the file */
+    uint32_t reserved;       /**< Zero */
+};
+
+const uint32_t BLOCK_FILE_VERSION = 1;
+
+/**
+ * @brief One record read from a block file. The strings point into the file or the decoded block.
+ */
+struct BlockRow
+{
+    int zip;            /**< The ZIP code */
+    string_view place;  /**< Place name */
+    string_view state;  /**< State */
+    string_view county; /**< County */
+    double latitude;    /**< Latitude */
+    double longitude;   /**< Longitude */
+};
+
+class PostalBlockFile
+{
+private:
+    /**
+     * @brief The columns of one decompressed block.
+     */
+    struct DecodedBlock
+    {
+        string raw;                 /**< Decompressed bytes */
+        vector<int32_t> zips;       /**< ZIP code of each row */
+        vector<uint32_t> states;    /**< State id of each row */
+        vector<uint32_t> counties;  /**< County id of each row */
+        vector<string_view> places; /**< Place name of each row (points into raw) */
+        vector<double> latitudes;   /**< Latitude of each row */
+        vector<double> longitudes;  /**< Longitude of each row */
+    };
+
+    MappedFile file;               /**< The mapped block file */
+    const BlockFileHeader *header; /**< Start of the mapping (nullptr when closed) */
+    const BlockIndexEntry *blocks; /**< The block index */
+
+    bool decodeBlock(size_t block, DecodedBlock &decoded) const;
+    string_view dictionaryText(uint64_t offset, uint32_t count, uint32_t id) const;
+    BlockRow rowOf(const DecodedBlock &decoded, size_t row) const;
+
+public:
+    /**
+     * @brief Create a closed block file.
+     */
+    PostalBlockFile();
+
+    PostalBlockFile(const PostalBlockFile &) = delete;
+    PostalBlockFile &operator=(const PostalBlockFile &) = delete;
+
+    /**
+     * @brief Write a list as a block file.
+     * @param fileName   Where to write it (replaced if it exists, see replaceFile()).
+     * @param list       The records; they are written in ZIP order.
+     * @param blockBytes Target size of a block before compression, counting each coordinate as a raw double.
+     * @return true if the whole file was written.
+     */
+    static bool write(const string &fileName, const PostalList &list, size_t blockBytes = 64 * 1024);
+
+    /**
+     * @brief Get the usual block file name for a source file.
+     * @param sourceName e.g. "us_postal_codes.csv".
+     * @return The name with its extension replaced by ".zblk".
+     */
+    static string nameFor(const string &sourceName);
+
+    /**
+     * @brief Map a block file and check its header, dictionaries and index.
+     * @param fileName The block file.
+     * @return true if it is a version-1 block file whose parts all fit in it.
+     * @note The blocks themselves are checked as they are decompressed.
+     */
+    bool open(const string &fileName);
+
+    /**
+     * @brief Unmap the file.
+     */
+    void close();
+
+    /**
+     * @brief Check whether a block file is open.
+     * @return true after a successful open().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get the number of records.
+     * @return The row count (0 when closed).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of blocks.
+     * @return The block count (0 when closed).
+     */
+    size_t blockCount() const;
+
+    /**
+     * @brief Get the size of the file.
+     * @return Bytes (0 when closed).
+     */
+    size_t fileBytes() const;
+
+    /**
+     * @brief Look up a ZIP code, decompressing only the block that can hold it.
+     * @param zip  The ZIP code.
+     * @param item Receives the first record with that ZIP code.
+     * @return true if it was found.
+     */
+    bool find(int zip, PostalCodeItem &item) const;
+
+    /**
+     * @brief Visit every record in ZIP order, one block at a time.
+     * @param visit Called once per record; the row's strings are only valid during the call.
+     * @return false if a block is damaged (the records before it were visited).
+     */
+    bool scan(const function<void(const BlockRow &)> &visit) const;
+
+    /**
+     * @brief Add every record to a list.
+     * @param list The list to append to.
+     * @return The number of records added, or -1 if a block is damaged (the
+     * records of the blocks before it have then been added already).
+     */
+    int addTo(PostalList &list) const;
+};
+
+#include "PostalBlockFile.cpp"
+#endif
@@ -21,6 +21,7 @@
  */
 
 #include "PostalCodeItem.h"
+#include "TableFormatter.h"
 #include <iostream>
 #include <string>
 #include <iomanip>
@@ -34,11 +35,11 @@ using namespace std;
  * This ensures that a PostalCodeItem object starts with a known state.
  * @note This constructor can be used to create an empty PostalCodeItem object,
  * which can later be populated with actual data using the setter methods.
- * @see PostalCodeItem(int, const string&, const string&, const string&, double, double)
+ * @see PostalCodeItem(int, string_view, string_view, string_view, double, double)
  * @see setZip(int)
- * @see setPlace(const string&)
- * @see setState(const string&)
- * @see setCounty(const string&)
+ * @see setPlace(string_view)
+ * @see setState(string_view)
+ * @see setCounty(string_view)
  * @see setLatitude(double)
  * @see setLongitude(double)
  * @see printInfo() const
@@ -46,9 +47,6 @@ using namespace std;
 PostalCodeItem::PostalCodeItem()
 {
     zip = 0;
-    place = "";
-    state = "";
-    county = "";
     latitude = 0;
     longitude = 0;
 }
@@ -64,14 +62,122 @@ PostalCodeItem::PostalCodeItem()
  * This constructor allows for the creation of a fully initialized PostalCodeItem object.
  * @note Ensure that the provided values are valid and meaningful for the postal code entry.
  */
-PostalCodeItem::PostalCodeItem(int z, const string &p, const string &s, const string &c, double lat, double lon)
+PostalCodeItem::PostalCodeItem(int z, string_view p, string_view s, string_view c, double lat, double lon)
 {
     zip = z;
-    place = p;
-    state = s;
-    county = c;
     latitude = lat;
     longitude = lon;
+    copyText(p, s, c);
+}
+
+/**
+ * @brief Copy constructor; the copy owns its strings.
+ * @param other The item to copy.
+ */
+PostalCodeItem::PostalCodeItem(const PostalCodeItem &other)
+{
+    zip = other.zip;
+    latitude = other.latitude;
+    longitude = other.longitude;
+    copyText(other.place, other.state, other.county);
+}
+
+/**
+ * @brief Move constructor.
+ * @param other The item to move from; left as a default item.
+ * @note An owned text block stays where it is on the heap, so the views
+ * move along unchanged.
+ */
+PostalCodeItem::PostalCodeItem(PostalCodeItem &&other) noexcept
+    : zip(other.zip), latitude(other.latitude), longitude(other.longitude),
+      place(other.place), state(other.state), county(other.county), text(move(other.text))
+{
+    other = PostalCodeItem();
+}
+
+/**
+ * @brief Copy assignment; this item owns its strings afterwards.
+ * @param other The item to copy.
+ * @return This item.
+ */
+PostalCodeItem &PostalCodeItem::operator=(const PostalCodeItem &other)
+{
+    if (this != &other)
+    {
+        zip = other.zip;
+        latitude = other.latitude;
+        longitude = other.longitude;
+        copyText(other.place, other.state, other.county);
+    }
+    return *this;
+}
+
+/**
+ * @brief Move assignment.
+ * @param other The item to move from; left as a default item.
+ * @return This item.
+ */
+PostalCodeItem &PostalCodeItem::operator=(PostalCodeItem &&other) noexcept
+{
+    if (this != &other)
+    {
+        zip = other.zip;
+        latitude = other.latitude;
+        longitude = other.longitude;
+        place = other.place;
+        state = other.state;
+        county = other.county;
+        text = move(other.text);
+        other.zip = 0;
+        other.latitude = 0;
+        other.longitude = 0;
+        other.place = other.state = other.county = string_view();
+    }
+    return *this;
+}
+
+/**
+ * @brief Make an item whose text fields point at strings kept alive elsewhere.
+ * @param z   The ZIP code.
+ * @param p   The place name.
+ * @param s   The state abbreviation.
+ * @param c   The county name.
+ * @param lat The latitude.
+ * @param lon The longitude.
+ * @return An item that owns no strings.
+ */
+PostalCodeItem PostalCodeItem::withSharedStrings(int z, string_view p, string_view s, string_view c, double lat, double lon)
+{
+    PostalCodeItem item;
+    item.zip = z;
+    item.latitude = lat;
+    item.longitude = lon;
+    item.place = p;
+    item.state = s;
+    item.county = c;
+    return item;
+}
+
+/**
+ * @brief Replace text with a copy of three fields and point the views at it.
+ * @param newPlace  The place name.
+ * @param newState  The state abbreviation.
+ * @param newCounty The county name.
+ * @note The fields may point into text itself, so they are copied into a new
+ * block before the old one is freed. Three empty fields need no block.
+ */
+void PostalCodeItem::copyText(string_view newPlace, string_view newState, string_view newCounty)
+{
+    size_t length = newPlace.size() + newState.size() + newCounty.size();
+    unique_ptr<char[]> joined(length > 0 ? new char[length] : nullptr);
+    char *out = joined.get();
+    newPlace.copy(out, newPlace.size());
+    newState.copy(out + newPlace.size(), newState.size());
+    newCounty.copy(out + newPlace.size() + newState.size(), newCounty.size());
+    place = string_view(out, newPlace.size());
+    state = string_view(out + newPlace.size(), newState.size());
+    county = string_view(out + newPlace.size() + newState.size(), newCounty.size());
+    text = move(joined);
 }
 
 /**
@@ -89,7 +195,7 @@ int PostalCodeItem::getZip() const
  */
 string PostalCodeItem::getPlace() const
 {
-    return place;
+    return string(place);
 }
 
 /**
@@ -98,7 +204,7 @@ string PostalCodeItem::getPlace() const
  */
 string PostalCodeItem::getState() const
 {
-    return state;
+    return string(state);
 }
 
 /**
@@ -108,6 +214,33 @@ string PostalCodeItem::getState() const
  * Ensure that the county name is correctly formatted for display or processing.
  */
 string PostalCodeItem::getCounty() const
+{
+    return string(county);
+}
+
+/**
+ * @brief Get the place name without copying it.
+ * @return A view of the stored name.
+ */
+string_view PostalCodeItem::getPlaceView() const
+{
+    return place;
+}
+
+/**
+ * @brief Get the state abbreviation without copying it.
+ * @return A view of the stored abbreviation.
+ */
+string_view PostalCodeItem::getStateView() const
+{
+    return state;
+}
+
+/**
+ * @brief Get the county name without copying it.
+ * @return A view of the stored name.
+ */
+string_view PostalCodeItem::getCountyView() const
 {
     return county;
 }
@@ -147,9 +280,9 @@ void PostalCodeItem::setZip(int newZip)
  * @param newPlace The new place name to be set (string).
  * @note Ensure that the new place name is a valid string value.
  */
-void PostalCodeItem::setPlace(const string &newPlace)
+void PostalCodeItem::setPlace(string_view newPlace)
 {
-    place = newPlace;
+    copyText(newPlace, state, county);
 }
 
 /**
@@ -157,9 +290,9 @@ void PostalCodeItem::setPlace(const string &newPlace)
  * @param newState The new state name to be set (string).
  * @note Ensure that the new state name is a valid string value.
  */
-void PostalCodeItem::setState(const string &newState)
+void PostalCodeItem::setState(string_view newState)
 {
-    state = newState;
+    copyText(place, newState, county);
 }
 
 /**
@@ -167,9 +300,9 @@ void PostalCodeItem::setState(const string &newState)
  * @param newCounty The new county name to be set (string).
  * @note Ensure that the new county name is a valid string value.
  */
-void PostalCodeItem::setCounty(const string &newCounty)
+void PostalCodeItem::setCounty(string_view newCounty)
 {
-    county = newCounty;
+    copyText(place, state, newCounty);
 }
 
 /**
@@ -202,11 +335,15 @@ void PostalCodeItem::setLongitude(double newLon)
  */
 void PostalCodeItem::printInfo() const
 {
-    cout << left << setw(10) << zip
-         << setw(20) << place
-         << setw(10) << state
-         << setw(30) << county
-         << setw(12) << latitude
-         << setw(12) << longitude
-         << endl;
+    TableFormatter formatter(cout);
+    printInfo(formatter);
+}
+
+/**
+ * @brief Write the postal code item's information through a formatter.
+ * @param formatter The formatter; its format decides the layout (table, TSV, CSV or JSON lines).
+ */
+void PostalCodeItem::printInfo(TableFormatter &formatter) const
+{
+    formatter.writeRow(zip, place, state, county, latitude, longitude);
 }
\ No newline at end of file
@@ -14,22 +14,40 @@
  * - County
  * - Latitude
  * - Longitude
+ *
+ * A standalone item owns its three text fields, stored back to back in one
+ * string. An item inside a PostalList instead points at the list's pooled
+ * copy of each name (see withSharedStrings()), so a name that appears on many
+ * rows is stored once and the items own no heap memory. Copying any item
+ * gives an item that owns its strings again.
  */
 
 #ifndef POSTAL_CODE_ITEM
 #define POSTAL_CODE_ITEM
 
+#include <string>
+#include <string_view>
+#include <memory>
+
 using namespace std;
 
+class TableFormatter;
+
 class PostalCodeItem
 {
 private:
-    int zip;          /**< ZIP code */
-    string place;     /**< Place name */
-    string state;     /**< State abbreviation */
-    string county;    /**< County name */
-    double latitude;  /**< Latitude coordinate */
-    double longitude; /**< Longitude coordinate */
+    int zip;                 /**< ZIP code */
+    double latitude;         /**< Latitude coordinate */
+    double longitude;        /**< Longitude coordinate */
+    string_view place;       /**< Place name */
+    string_view state;       /**< State abbreviation */
+    string_view county;      /**< County name */
+    unique_ptr<char[]> text; /**< place, state and county back to back; null if the views are shared */
+
+    /**
+     * @brief Replace text with a copy of three fields and point the views at it.
+     */
+    void copyText(string_view newPlace, string_view newState, string_view newCounty);
 
 public:
     /**
@@ -39,11 +57,11 @@ public:
      * This ensures that a PostalCodeItem object starts with a known state.
      * @note This constructor can be used to create an empty PostalCodeItem object,
      * which can later be populated with actual data using the setter methods.
-     * @see PostalCodeItem(int, const string&, const string&, const string&, double, double)
+     * @see PostalCodeItem(int, string_view, string_view, string_view, double, double)
      * @see setZip(int)
-     * @see setPlace(const string&)
-     * @see setState(const string&)
-     * @see setCounty(const string&)
+     * @see setPlace(string_view)
+     * @see setState(string_view)
+     * @see setCounty(string_view)
      * @see setLatitude(double)
      * @see setLongitude(double)
      * @see printInfo() const
@@ -61,7 +79,48 @@ public:
      * This constructor allows for the creation of a fully initialized PostalCodeItem object.
      * @note Ensure that the provided values are valid and meaningful for the postal code entry.
      */
-    PostalCodeItem(int z, const string &p, const string &s, const string &c, double lat, double lon);
+    PostalCodeItem(int z, string_view p, string_view s, string_view c, double lat, double lon);
+
+    /**
+     * @brief Copy constructor; the copy owns its strings even if @p other shares them.
+     * @param other The item to copy.
+     */
+    PostalCodeItem(const PostalCodeItem &other);
+
+    /**
+     * @brief Move constructor; the strings move with the item, shared or owned.
+     * @param other The item to move from; left empty.
+     */
+    PostalCodeItem(PostalCodeItem &&other) noexcept;
+
+    /**
+     * @brief Copy assignment; this item owns its strings afterwards.
+     * @param other The item to copy.
+     * @return This item.
+     */
+    PostalCodeItem &operator=(const PostalCodeItem &other);
+
+    /**
+     * @brief Move assignment; the strings move with the item, shared or owned.
+     * @param other The item to move from; left empty.
+     * @return This item.
+     */
+    PostalCodeItem &operator=(PostalCodeItem &&other) noexcept;
+
+    /**
+     * @brief Make an item whose text fields point at strings kept alive elsewhere.
+     * @param z   The ZIP code.
+     * @param p   The place name.
+     * @param s   The state abbreviation.
+     * @param c   The county name.
+     * @param lat The latitude.
+     * @param lon The longitude.
+     * @return An item that owns no strings.
+     * @note The strings must outlive the item and every move of it. PostalList
+     * uses this with the names in its column dictionaries; a copy of the item
+     * owns its strings, so copies may outlive the list.
+     */
+    static PostalCodeItem withSharedStrings(int z, string_view p, string_view s, string_view c, double lat, double lon);
 
     /**
      * @brief Get the ZIP code of the postal code item.
@@ -89,6 +148,24 @@ public:
      */
     string getCounty() const;
 
+    /**
+     * @brief Get the place name without copying it.
+     * @return A view of the stored name; valid until the item is changed or destroyed.
+     */
+    string_view getPlaceView() const;
+
+    /**
+     * @brief Get the state abbreviation without copying it.
+     * @return A view of the stored abbreviation; valid until the item is changed or destroyed.
+     */
+    string_view getStateView() const;
+
+    /**
+     * @brief Get the county name without copying it.
+     * @return A view of the stored name; valid until the item is changed or destroyed.
+     */
+    string_view getCountyView() const;
+
     /**
      * @brief Get the latitude of the postal code item.
      * @return The latitude as a double.
@@ -115,21 +192,21 @@ public:
      * @param newPlace The new place name to be set (string).
      * @note Ensure that the new place name is a valid string value.
      */
-    void setPlace(const string &newPlace);
+    void setPlace(string_view newPlace);
 
     /**
      * @brief Set the state name of the postal code item.
      * @param newState The new state name to be set (string).
      * @note Ensure that the new state name is a valid string value.
      */
-    void setState(const string &newState);
+    void setState(string_view newState);
 
     /**
      * @brief Set the county name of the postal code item.
      * @param newCounty The new county name to be set (string).
      * @note Ensure that the new county name is a valid string value.
      */
-    void setCounty(const string &newCounty);
+    void setCounty(string_view newCounty);
 
     /**
      * @brief Set the latitude of the postal code item.
@@ -154,6 +231,14 @@ public:
      * @note This method uses standard output (cout) to display the information.
      */
     void printInfo() const;
+
+    /**
+     * @brief Write the postal code item's information through a formatter.
+     * @param formatter The formatter; its format decides the layout (table, TSV, CSV or JSON lines).
+     * @note Use this when printing many items: the formatter buffers the rows
+     * instead of writing and flushing each one.
+     */
+    void printInfo(TableFormatter &formatter) const;
 };
 
 #include "PostalCodeItem.cpp"
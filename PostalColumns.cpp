@@ -0,0 +1,221 @@
+/**
+ * @file PostalColumns.cpp
+ * @brief Implementation of the PostalColumns class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "PostalColumns.h"
+
+using namespace std;
+
+/**
+ * @brief Append one record as a new row.
+ * @param item The record to append.
+ */
+void PostalColumns::append(const PostalCodeItem &item)
+{
+    zips.push_back(item.getZip());
+    latitudes.push_back(item.getLatitude());
+    longitudes.push_back(item.getLongitude());
+    placeIds.push_back(placeNames.intern(item.getPlaceView()));
+    stateIds.push_back(stateNames.intern(item.getStateView()));
+    countyIds.push_back(countyNames.intern(item.getCountyView()));
+}
+
+/**
+ * @brief Append every row of another set of columns, in order.
+ * @param other The rows to append.
+ */
+void PostalColumns::appendColumns(const PostalColumns &other)
+{
+    // Interning the other dictionary in its id order keeps our ids in first-seen order
+    auto translate = [](StringDictionary &into, const StringDictionary &from)
+    {
+        vector<uint32_t> table(from.size());
+        for (uint32_t id = 0; id < table.size(); id++)
+        {
+            table[id] = into.intern(from.at(id));
+        }
+        return table;
+    };
+    vector<uint32_t> placeTable = translate(placeNames, other.placeNames);
+    vector<uint32_t> stateTable = translate(stateNames, other.stateNames);
+    vector<uint32_t> countyTable = translate(countyNames, other.countyNames);
+
+    zips.insert(zips.end(), other.zips.begin(), other.zips.end());
+    latitudes.insert(latitudes.end(), other.latitudes.begin(), other.latitudes.end());
+    longitudes.insert(longitudes.end(), other.longitudes.begin(), other.longitudes.end());
+    for (size_t row = 0; row < other.size(); row++)
+    {
+        placeIds.push_back(placeTable[other.placeIds[row]]);
+        stateIds.push_back(stateTable[other.stateIds[row]]);
+        countyIds.push_back(countyTable[other.countyIds[row]]);
+    }
+}
+
+/**
+ * @brief Reserve room for a number of rows.
+ * @param rows The expected row count.
+ */
+void PostalColumns::reserve(size_t rows)
+{
+    zips.reserve(rows);
+    latitudes.reserve(rows);
+    longitudes.reserve(rows);
+    placeIds.reserve(rows);
+    stateIds.reserve(rows);
+    countyIds.reserve(rows);
+}
+
+/**
+ * @brief Get the number of rows.
+ * @return The row count.
+ */
+size_t PostalColumns::size() const
+{
+    return zips.size();
+}
+
+/**
+ * @brief Get the ZIP column.
+ * @return Pointer to size() ZIP codes.
+ */
+const int32_t *PostalColumns::zipData() const
+{
+    return zips.data();
+}
+
+/**
+ * @brief Get the latitude column.
+ * @return Pointer to size() latitudes.
+ */
+const double *PostalColumns::latitudeData() const
+{
+    return latitudes.data();
+}
+
+/**
+ * @brief Get the longitude column.
+ * @return Pointer to size() longitudes.
+ */
+const double *PostalColumns::longitudeData() const
+{
+    return longitudes.data();
+}
+
+/**
+ * @brief Get the place id column.
+ * @return Pointer to size() ids into placeDictionary().
+ */
+const uint32_t *PostalColumns::placeIdData() const
+{
+    return placeIds.data();
+}
+
+/**
+ * @brief Get the state id column.
+ * @return Pointer to size() ids into stateDictionary().
+ */
+const uint32_t *PostalColumns::stateIdData() const
+{
+    return stateIds.data();
+}
+
+/**
+ * @brief Get the county id column.
+ * @return Pointer to size() ids into countyDictionary().
+ */
+const uint32_t *PostalColumns::countyIdData() const
+{
+    return countyIds.data();
+}
+
+/**
+ * @brief Get the place name dictionary.
+ * @return The dictionary the place ids refer to.
+ */
+const StringDictionary &PostalColumns::placeDictionary() const
+{
+    return placeNames;
+}
+
+/**
+ * @brief Get the state dictionary.
+ * @return The dictionary the state ids refer to.
+ */
+const StringDictionary &PostalColumns::stateDictionary() const
+{
+    return stateNames;
+}
+
+/**
+ * @brief Get the county dictionary.
+ * @return The dictionary the county ids refer to.
+ */
+const StringDictionary &PostalColumns::countyDictionary() const
+{
+    return countyNames;
+}
+
+/**
+ * @brief Get the place name of a row.
+ * @param row The row number.
+ * @return A view of the interned place name.
+ */
+string_view PostalColumns::place(size_t row) const
+{
+    return placeNames.at(placeIds[row]);
+}
+
+/**
+ * @brief Get the state of a row.
+ * @param row The row number.
+ * @return A view of the interned state abbreviation.
+ */
+string_view PostalColumns::state(size_t row) const
+{
+    return stateNames.at(stateIds[row]);
+}
+
+/**
+ * @brief Get the county of a row.
+ * @param row The row number.
+ * @return A view of the interned county name.
+ */
+string_view PostalColumns::county(size_t row) const
+{
+    return countyNames.at(countyIds[row]);
+}
+
+/**
+ * @brief Rebuild a full PostalCodeItem from one row.
+ * @param row The row number.
+ * @return A new item with the row's values.
+ */
+PostalCodeItem PostalColumns::row(size_t row) const
+{
+    return PostalCodeItem(zips[row], placeNames.at(placeIds[row]), stateNames.at(stateIds[row]),
+                          countyNames.at(countyIds[row]), latitudes[row], longitudes[row]);
+}
+
+/**
+ * @brief Estimate the memory the columns and dictionaries use.
+ * @return Bytes of heap memory, counted by capacity.
+ */
+size_t PostalColumns::memoryBytes() const
+{
+    return zips.capacity() * sizeof(int32_t) +
+           latitudes.capacity() * sizeof(double) +
+           longitudes.capacity() * sizeof(double) +
+           placeIds.capacity() * sizeof(uint32_t) +
+           stateIds.capacity() * sizeof(uint32_t) +
+           countyIds.capacity() * sizeof(uint32_t) +
+           placeNames.memoryBytes() + stateNames.memoryBytes() + countyNames.memoryBytes();
+}
@@ -0,0 +1,162 @@
+/**
+ * @file PostalColumns.h
+ * @brief Defines the PostalColumns class, a column-by-column copy of a postal list.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * PostalColumns stores each field of the postal records in its own array
+ * (struct of arrays): the ZIP codes are one contiguous int32 array, the
+ * coordinates two double arrays, and the text fields are ids into string
+ * dictionaries. A search over ZIP codes or coordinates then reads only those
+ * arrays instead of stepping over whole PostalCodeItem objects.
+ */
+
+#ifndef POSTAL_COLUMNS_H
+#define POSTAL_COLUMNS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "PostalCodeItem.h"
+#include "StringDictionary.h"
+
+using namespace std;
+
+class PostalColumns
+{
+private:
+    vector<int32_t> zips;       /**< ZIP code of each row */
+    vector<double> latitudes;   /**< Latitude of each row */
+    vector<double> longitudes;  /**< Longitude of each row */
+    vector<uint32_t> placeIds;  /**< Place name id of each row (into placeNames) */
+    vector<uint32_t> stateIds;  /**< State id of each row (into stateNames) */
+    vector<uint32_t> countyIds; /**< County id of each row (into countyNames) */
+    StringDictionary placeNames;  /**< Distinct place names */
+    StringDictionary stateNames;  /**< Distinct state abbreviations */
+    StringDictionary countyNames; /**< Distinct county names */
+
+public:
+    PostalColumns() = default;
+
+    /**
+     * @brief Append one record as a new row.
+     * @param item The record to append.
+     */
+    void append(const PostalCodeItem &item);
+
+    /**
+     * @brief Append every row of another set of columns, in order.
+     * @param other The rows to append.
+     * @note Each distinct name in @p other is interned once and the rows are
+     * translated through a table, so no row's text is hashed again. The ids
+     * come out the same as appending the rows one by one would give.
+     */
+    void appendColumns(const PostalColumns &other);
+
+    /**
+     * @brief Reserve room for a number of rows.
+     * @param rows The expected row count.
+     */
+    void reserve(size_t rows);
+
+    /**
+     * @brief Get the number of rows.
+     * @return The row count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the ZIP column.
+     * @return Pointer to size() ZIP codes.
+     */
+    const int32_t *zipData() const;
+
+    /**
+     * @brief Get the latitude column.
+     * @return Pointer to size() latitudes.
+     */
+    const double *latitudeData() const;
+
+    /**
+     * @brief Get the longitude column.
+     * @return Pointer to size() longitudes.
+     */
+    const double *longitudeData() const;
+
+    /**
+     * @brief Get the place id column.
+     * @return Pointer to size() ids into placeDictionary().
+     */
+    const uint32_t *placeIdData() const;
+
+    /**
+     * @brief Get the state id column.
+     * @return Pointer to size() ids into stateDictionary().
+     */
+    const uint32_t *stateIdData() const;
+
+    /**
+     * @brief Get the county id column.
+     * @return Pointer to size() ids into countyDictionary().
+     */
+    const uint32_t *countyIdData() const;
+
+    /**
+     * @brief Get the place name dictionary.
+     * @return The dictionary the place ids refer to.
+     */
+    const StringDictionary &placeDictionary() const;
+
+    /**
+     * @brief Get the state dictionary.
+     * @return The dictionary the state ids refer to.
+     */
+    const StringDictionary &stateDictionary() const;
+
+    /**
+     * @brief Get the county dictionary.
+     * @return The dictionary the county ids refer to.
+     */
+    const StringDictionary &countyDictionary() const;
+
+    /**
+     * @brief Get the place name of a row.
+     * @param row The row number.
+     * @return A view of the interned place name.
+     */
+    string_view place(size_t row) const;
+
+    /**
+     * @brief Get the state of a row.
+     * @param row The row number.
+     * @return A view of the interned state abbreviation.
+     */
+    string_view state(size_t row) const;
+
+    /**
+     * @brief Get the county of a row.
+     * @param row The row number.
+     * @return A view of the interned county name.
+     */
+    string_view county(size_t row) const;
+
+    /**
+     * @brief Rebuild a full PostalCodeItem from one row.
+     * @param row The row number.
+     * @return A new item with the row's values.
+     */
+    PostalCodeItem row(size_t row) const;
+
+    /**
+     * @brief Estimate the memory the columns and dictionaries use.
+     * @return Bytes of heap memory, counted by capacity.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "PostalColumns.cpp"
+#endif
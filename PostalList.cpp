@@ -12,20 +12,61 @@
  */
 
 #include "PostalList.h"
+#include "Metrics.h"
 #include <iostream>
 #include <algorithm>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 using namespace std;
 
 /**
  * @brief Add a PostalCodeItem to the list.
  * @param item The PostalCodeItem to be added.
+ * The names are interned in the columns first, and the stored item points at
+ * the dictionaries' copies (which never move) instead of owning its own.
  */
 void PostalList::addItem(const PostalCodeItem &item)
 {
-    items.push_back(item);
+    size_t first = items.size();
+    columns.append(item);
+    indexNewRows(first);
+}
+
+/**
+ * @brief Add every row of a set of columns, in order.
+ * @param rows The rows to add, with their own dictionaries.
+ */
+void PostalList::addColumns(const PostalColumns &rows)
+{
+    size_t first = items.size();
+    columns.appendColumns(rows);
+    indexNewRows(first);
+}
+
+/**
+ * @brief Add the items, postings and ZIP table entries for the new column rows.
+ * @param first The first row that has no item yet.
+ */
+void PostalList::indexNewRows(size_t first)
+{
+    for (uint32_t row = static_cast<uint32_t>(first); row < columns.size(); row++)
+    {
+        int zip = columns.zipData()[row];
+        items.push_back(PostalCodeItem::withSharedStrings(zip, columns.place(row), columns.state(row),
+                                                          columns.county(row), columns.latitudeData()[row],
+                                                          columns.longitudeData()[row]));
+        statePostings.add(columns.stateIdData()[row], row);
+        countyPostings.add(columns.countyIdData()[row], row);
+        if (zipTableEnabled)
+        {
+            zipTable.insert(zip, static_cast<int>(row));
+        }
+    }
+    zipOrderValid = false;
+    stateOrderValid = false;
+    placeIndexValid = false;
 }
 
 /**
@@ -34,7 +75,7 @@ void PostalList::addItem(const PostalCodeItem &item)
  * @return The PostalCodeItem at the specified index.
  * @throws out_of_range if the index is invalid.
  */
-PostalCodeItem PostalList::getItem(int index) const
+const PostalCodeItem &PostalList::getItem(int index) const
 {
     if (index < items.size())
     {
@@ -43,6 +84,43 @@ PostalCodeItem PostalList::getItem(int index) const
     throw out_of_range("Index out of range in PostalList::getItem");
 }
 
+/**
+ * @brief Make room for a number of rows so the loaders do not regrow the storage.
+ * @param rows The expected total row count.
+ */
+void PostalList::reserve(size_t rows)
+{
+    items.reserve(rows);
+    columns.reserve(rows);
+}
+
+/**
+ * @brief Get the items as one contiguous array, in the order they were added.
+ * @return Pointer to size() items.
+ */
+const PostalCodeItem *PostalList::data() const
+{
+    return items.data();
+}
+
+/**
+ * @brief Get an iterator to the first item, for range-based for loops.
+ * @return Iterator over the items in the order they were added.
+ */
+vector<PostalCodeItem>::const_iterator PostalList::begin() const
+{
+    return items.begin();
+}
+
+/**
+ * @brief Get an iterator past the last item.
+ * @return The end iterator.
+ */
+vector<PostalCodeItem>::const_iterator PostalList::end() const
+{
+    return items.end();
+}
+
 /**
  * @brief Find a PostalCodeItem by its ZIP code.
  * @param zip The ZIP code to search for.
@@ -51,14 +129,69 @@ PostalCodeItem PostalList::getItem(int index) const
  */
 const PostalCodeItem *PostalList::findByZip(int zip) const
 {
-    for (const auto &item : items)
+    int index = findIndexByZip(zip);
+    return (index < 0) ? nullptr : &items[index];
+}
+
+/**
+ * @brief Find the index of the item with a ZIP code.
+ * @param zip The ZIP code to search for.
+ * @return The index for getItem(), or -1 if no item has that ZIP code.
+ */
+int PostalList::findIndexByZip(int zip) const
+{
+    LatencyTimer timer(MetricHistogram::ZipLookup, 16);
+    int index = -1;
+    if (zipTableEnabled)
     {
-        if (item.getZip() == zip)
+        index = zipTable.find(zip);
+    }
+    else
+    {
+        // Scan the contiguous ZIP column instead of stepping over whole items
+        const int32_t *zips = columns.zipData();
+        for (size_t i = 0; i < columns.size(); i++)
         {
-            return &item;
+            if (zips[i] == zip)
+            {
+                index = static_cast<int>(i);
+                break;
+            }
         }
     }
-    return nullptr;
+    Metrics::add(index >= 0 ? MetricCounter::ZipHits : MetricCounter::ZipMisses);
+    return index;
+}
+
+/**
+ * @brief Turn the ZIP lookup table on or off.
+ * @param enabled true to build the table now and keep it current in addItem.
+ */
+void PostalList::setZipTableEnabled(bool enabled)
+{
+    if (enabled && !zipTableEnabled)
+    {
+        PhaseTimer timer(MetricPhase::IndexBuild);
+        const int32_t *zips = columns.zipData();
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            zipTable.insert(zips[i], static_cast<int>(i));
+        }
+    }
+    else if (!enabled)
+    {
+        zipTable.clear();
+    }
+    zipTableEnabled = enabled;
+}
+
+/**
+ * @brief Check whether findByZip uses the lookup table.
+ * @return true if the ZIP table is enabled.
+ */
+bool PostalList::isZipTableEnabled() const
+{
+    return zipTableEnabled;
 }
 
 /**
@@ -70,6 +203,392 @@ int PostalList::size() const
     return items.size();
 }
 
+/**
+ * @brief Rebuild the ZIP order if addItem has changed the list since the last build.
+ */
+void PostalList::ensureZipOrder() const
+{
+    if (zipOrderValid)
+    {
+        return;
+    }
+    PhaseTimer timer(MetricPhase::Sort);
+
+    // Radix sort (row, ZIP - smallest ZIP) pairs; a row number is all that moves
+    const int32_t *zips = columns.zipData();
+    int32_t smallest = columns.size() ? *min_element(zips, zips + columns.size()) : 0;
+    vector<uint32_t> keys(items.size());
+    zipOrder.resize(items.size());
+    for (uint32_t i = 0; i < zipOrder.size(); i++)
+    {
+        zipOrder[i] = i;
+        keys[i] = static_cast<uint32_t>(static_cast<int64_t>(zips[i]) - smallest);
+    }
+    radixSortRows(zipOrder, keys);
+
+    // Keep the keys next to each other so the binary search stays in cache
+    zipOrderKeys.resize(zipOrder.size());
+    for (size_t i = 0; i < zipOrder.size(); i++)
+    {
+        zipOrderKeys[i] = zips[zipOrder[i]];
+    }
+    zipOrderValid = true;
+}
+
+/**
+ * @brief Get every item in ascending ZIP order.
+ * @return A view over the sorted index.
+ */
+ItemRange PostalList::sortedByZip() const
+{
+    ensureZipOrder();
+    return ItemRange(items.data(), zipOrder.data(), zipOrder.data() + zipOrder.size());
+}
+
+/**
+ * @brief Rebuild the state order if addItem has changed the list since the last build.
+ */
+void PostalList::ensureStateOrder() const
+{
+    if (stateOrderValid)
+    {
+        return;
+    }
+
+    // Start from the ZIP order and stable-sort by the state's alphabetical
+    // rank, so items end up by state and by ZIP inside each state
+    ensureZipOrder();
+    PhaseTimer timer(MetricPhase::Sort);
+    const uint32_t *states = columns.stateIdData();
+    const vector<uint32_t> &stateRanks = columns.stateDictionary().sortRanks();
+    stateOrder = zipOrder;
+    vector<uint32_t> keys(stateOrder.size());
+    for (size_t i = 0; i < stateOrder.size(); i++)
+    {
+        keys[i] = stateRanks[states[stateOrder[i]]];
+    }
+    radixSortRows(stateOrder, keys);
+    stateOrderValid = true;
+}
+
+/**
+ * @brief Get every item ordered by state name, then by ZIP code.
+ * @return A view over the sorted index.
+ */
+ItemRange PostalList::sortedByState() const
+{
+    ensureStateOrder();
+    return ItemRange(items.data(), stateOrder.data(), stateOrder.data() + stateOrder.size());
+}
+
+/**
+ * @brief Get the items in any column order.
+ * @param fields The ORDER BY list.
+ * @param rows   Scratch space for the sorted row numbers.
+ * @param limit  Only the first @p limit items are wanted (0 = all of them).
+ * @return A view of the sorted items.
+ */
+ItemRange PostalList::sortedBy(const vector<SortField> &fields, vector<uint32_t> &rows, size_t limit) const
+{
+    orderRows(columns, fields, limit, rows);
+    return ItemRange(items.data(), rows.data(), rows.data() + rows.size());
+}
+
+/**
+ * @brief Get the items whose ZIP code is at least @p zip, in ZIP order.
+ * @param zip The smallest ZIP code to include.
+ * @return A view from the first such item to the end of the sorted index.
+ */
+ItemRange PostalList::lowerBound(int zip) const
+{
+    ensureZipOrder();
+    size_t start = lower_bound(zipOrderKeys.begin(), zipOrderKeys.end(), zip) - zipOrderKeys.begin();
+    return ItemRange(items.data(), zipOrder.data() + start, zipOrder.data() + zipOrder.size());
+}
+
+/**
+ * @brief Get the items with low <= ZIP <= high, in ZIP order.
+ * @param low  The smallest ZIP code to include.
+ * @param high The largest ZIP code to include.
+ * @return A view of the matching items.
+ */
+ItemRange PostalList::findZipRange(int low, int high) const
+{
+    if (low > high)
+    {
+        return ItemRange();
+    }
+    ensureZipOrder();
+    size_t start = lower_bound(zipOrderKeys.begin(), zipOrderKeys.end(), low) - zipOrderKeys.begin();
+    size_t stop = upper_bound(zipOrderKeys.begin() + start, zipOrderKeys.end(), high) - zipOrderKeys.begin();
+    return ItemRange(items.data(), zipOrder.data() + start, zipOrder.data() + stop);
+}
+
+/**
+ * @brief Get the 5-digit ZIP codes that start with some digits, in ZIP order.
+ * @param prefix 0 to 5 digits.
+ * @return A view of the matching items.
+ * @throws invalid_argument if the prefix has non-digits or more than 5 characters.
+ */
+ItemRange PostalList::findByPrefix(const string &prefix) const
+{
+    if (prefix.size() > 5 || prefix.find_first_not_of("0123456789") != string::npos)
+    {
+        throw invalid_argument("ZIP prefix must be at most 5 digits in PostalList::findByPrefix");
+    }
+
+    // "554" covers 55400 .. 55499: pad the prefix with 0s for the low end and 9s for the high end
+    int low = 0;
+    int high = 0;
+    for (size_t i = 0; i < 5; i++)
+    {
+        low = low * 10 + ((i < prefix.size()) ? prefix[i] - '0' : 0);
+        high = high * 10 + ((i < prefix.size()) ? prefix[i] - '0' : 9);
+    }
+    return findZipRange(low, high);
+}
+
+/**
+ * @brief Get the items in a state.
+ * @param state The state, e.g. "MN".
+ * @return A view of the matching items in list order.
+ */
+ItemRange PostalList::findByState(string_view state) const
+{
+    auto found = statePostings.rows(columns.stateDictionary().find(state));
+    return ItemRange(items.data(), found.first, found.second);
+}
+
+/**
+ * @brief Get the items in every county with some name, in any state.
+ * @param county The county, e.g. "Hennepin".
+ * @return A view of the matching items in list order.
+ */
+ItemRange PostalList::findByCounty(string_view county) const
+{
+    auto found = countyPostings.rows(columns.countyDictionary().find(county));
+    return ItemRange(items.data(), found.first, found.second);
+}
+
+/**
+ * @brief Get the items in one county of one state.
+ * @param state  The state.
+ * @param county The county.
+ * @param rows   Scratch space for the matching row numbers.
+ * @return A view of the matching items in list order.
+ */
+ItemRange PostalList::findByStateAndCounty(string_view state, string_view county, vector<uint32_t> &rows) const
+{
+    auto inState = statePostings.rows(columns.stateDictionary().find(state));
+    auto inCounty = countyPostings.rows(columns.countyDictionary().find(county));
+    intersectRows(inState.first, inState.second, inCounty.first, inCounty.second, rows);
+    return ItemRange(items.data(), rows.data(), rows.data() + rows.size());
+}
+
+/**
+ * @brief Rebuild the place index if addItem has changed the list since the last build.
+ */
+void PostalList::ensurePlaceIndex() const
+{
+    if (placeIndexValid)
+    {
+        return;
+    }
+    ensureZipOrder();
+    PhaseTimer timer(MetricPhase::IndexBuild);
+    placeIndex.build(columns, zipOrder.data());
+    placeIndexValid = true;
+}
+
+/**
+ * @brief Add the rows and names added since the last fuzzySearch to the fuzzy indexes.
+ */
+void PostalList::ensureFuzzyIndex() const
+{
+    if (fuzzyIndexedRows == items.size())
+    {
+        return;
+    }
+    PhaseTimer timer(MetricPhase::IndexBuild);
+    const uint32_t *placeIds = columns.placeIdData();
+    for (size_t row = fuzzyIndexedRows; row < items.size(); row++)
+    {
+        placePostings.add(placeIds[row], static_cast<uint32_t>(row));
+    }
+    fuzzyIndexedRows = items.size();
+
+    // Dictionary ids count up, so the names not indexed yet are the ones past size()
+    const StringDictionary &places = columns.placeDictionary();
+    for (uint32_t id = static_cast<uint32_t>(placeFuzzy.size()); id < places.size(); id++)
+    {
+        placeFuzzy.add(places.at(id));
+    }
+    const StringDictionary &counties = columns.countyDictionary();
+    for (uint32_t id = static_cast<uint32_t>(countyFuzzy.size()); id < counties.size(); id++)
+    {
+        countyFuzzy.add(counties.at(id));
+    }
+}
+
+/**
+ * @brief Suggest places whose name starts with some text (autocomplete).
+ * @param prefix The typed text; case does not matter.
+ * @param limit  The most suggestions to return.
+ * @param out    Receives the suggestions by place name and then ZIP code.
+ * @param state  Only suggest places in this state; "" for any state.
+ */
+void PostalList::completePlace(string_view prefix, size_t limit, vector<PlaceMatch> &out, string_view state) const
+{
+    ensurePlaceIndex();
+    placeIndex.complete(columns, prefix, limit, state, out);
+}
+
+/**
+ * @brief Find the items whose place or county name is close to some text.
+ * @param query       The text; case does not matter.
+ * @param limit       The most items to return.
+ * @param out         Receives the matches, best first.
+ * @param maxDistance The most edits allowed.
+ */
+void PostalList::fuzzySearch(string_view query, size_t limit, vector<FuzzyMatch> &out, int maxDistance) const
+{
+    ensureFuzzyIndex();
+    out.clear();
+    vector<FuzzyNameMatch> places;
+    vector<FuzzyNameMatch> counties;
+    placeFuzzy.search(query, maxDistance, places);
+    countyFuzzy.search(query, maxDistance, counties);
+
+    struct NameHit
+    {
+        FuzzyNameMatch name;
+        double score;
+        bool byCounty;
+    };
+    vector<NameHit> hits;
+    for (int field = 0; field < 2; field++)
+    {
+        const StringDictionary &names = field ? columns.countyDictionary() : columns.placeDictionary();
+        for (const FuzzyNameMatch &name : field ? counties : places)
+        {
+            size_t longer = max(max(query.size(), names.at(name.id).size()), size_t(1));
+            hits.push_back({name, 1.0 - static_cast<double>(name.distance) / longer, field == 1});
+        }
+    }
+    stable_sort(hits.begin(), hits.end(), [](const NameHit &a, const NameHit &b)
+                {
+                    if (a.name.distance != b.name.distance)
+                    {
+                        return a.name.distance < b.name.distance;
+                    }
+                    return a.score != b.score ? a.score > b.score : a.byCounty < b.byCounty;
+                });
+
+    for (const NameHit &hit : hits)
+    {
+        auto rows = (hit.byCounty ? countyPostings : placePostings).rows(hit.name.id);
+        for (const uint32_t *row = rows.first; row != rows.second && out.size() < limit; row++)
+        {
+            // Only a county hit can repeat an item already taken through its place name
+            bool seen = hit.byCounty && any_of(out.begin(), out.end(), [&](const FuzzyMatch &match)
+                                               { return match.row == *row; });
+            if (!seen)
+            {
+                out.push_back({&items[*row], *row, hit.name.distance, hit.score, hit.byCounty});
+            }
+        }
+        if (out.size() >= limit)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Find every item inside a latitude/longitude box.
+ * @param minLat Southern edge (inclusive).
+ * @param maxLat Northern edge (inclusive).
+ * @param minLon Western edge (inclusive).
+ * @param maxLon Eastern edge (inclusive).
+ * @return The indexes of the matching items, in list order.
+ */
+vector<int> PostalList::findInArea(double minLat, double maxLat, double minLon, double maxLon) const
+{
+    const double *latitudes = columns.latitudeData();
+    const double *longitudes = columns.longitudeData();
+    vector<int> found;
+
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        if (latitudes[i] >= minLat && latitudes[i] <= maxLat &&
+            longitudes[i] >= minLon && longitudes[i] <= maxLon)
+        {
+            found.push_back(static_cast<int>(i));
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Write the list to a binary snapshot file.
+ * @param fileName   Where to write it.
+ * @param sourceName The file the list was loaded from.
+ * @return true if the file was written.
+ */
+bool PostalList::saveSnapshot(const string &fileName, const string &sourceName) const
+{
+    ensureStateOrder();
+    ensurePlaceIndex();
+    return PostalSnapshot::write(fileName, columns, zipOrder.data(), stateOrder.data(), statePostings,
+                                 countyPostings, placeIndex, sourceName);
+}
+
+/**
+ * @brief Append every record of an open snapshot to the list.
+ * @param snapshot The snapshot.
+ * @return The number of records added.
+ */
+int PostalList::addSnapshot(const PostalSnapshot &snapshot)
+{
+    reserve(items.size() + snapshot.size());
+    for (size_t row = 0; row < snapshot.size(); row++)
+    {
+        // The names are views into the mapped snapshot; addItem copies them into the list
+        addItem(PostalCodeItem::withSharedStrings(snapshot.zip(row), snapshot.place(row), snapshot.state(row),
+                                                  snapshot.county(row), snapshot.latitude(row),
+                                                  snapshot.longitude(row)));
+    }
+    return static_cast<int>(snapshot.size());
+}
+
+/**
+ * @brief Get the columnar copy of the list.
+ * @return The columns; row i is the same record as getItem(i).
+ */
+const PostalColumns &PostalList::getColumns() const
+{
+    return columns;
+}
+
+/**
+ * @brief Estimate the memory the PostalCodeItem objects use.
+ * @return Bytes of heap memory for the item vector.
+ * @note Stored items own no strings (see addItem), so only the vector counts.
+ */
+size_t PostalList::itemMemoryBytes() const
+{
+    return items.capacity() * sizeof(PostalCodeItem);
+}
+
+/**
+ * @brief Estimate the memory the state, county and place posting lists use.
+ * @return Bytes of heap memory for the three indexes.
+ */
+size_t PostalList::postingMemoryBytes() const
+{
+    return statePostings.memoryBytes() + countyPostings.memoryBytes() + placePostings.memoryBytes();
+}
+
 /**
  * @brief Print all PostalCodeItems in the list.
  * Each item's information is printed followed by a separator line.
@@ -77,10 +596,21 @@ int PostalList::size() const
  */
 void PostalList::printAll() const
 {
+    TableFormatter formatter(cout);
+    printAll(formatter);
+}
+
+/**
+ * @brief Same as printAll(), written through a formatter.
+ * @param formatter Collects the rows and writes them in large chunks.
+ */
+void PostalList::printAll(TableFormatter &formatter) const
+{
+    PhaseTimer timer(MetricPhase::Output);
     for (int i = 0; i < items.size(); i++)
     {
-        items[i].printInfo();
-        cout << "-----------------------------------------------------------------------------------------------" << endl;
+        items[i].printInfo(formatter);
+        formatter.writeSeparator();
     }
 }
 
@@ -91,19 +621,23 @@ void PostalList::printAll() const
  */
 void PostalList::printSortedByZip() const
 {
-    // Make a copy so original order is preserved
-    vector<PostalCodeItem> sortedItems = items;
-
-    sort(sortedItems.begin(), sortedItems.end(),
-         [](const PostalCodeItem &a, const PostalCodeItem &b)
-         {
-             return a.getZip() < b.getZip();
-         });
+    TableFormatter formatter(cout);
+    printSortedByZip(formatter);
+}
 
-    for (const auto &item : sortedItems)
+/**
+ * @brief Same as printSortedByZip(), written through a formatter.
+ * @param formatter Collects the rows and writes them in large chunks.
+ */
+void PostalList::printSortedByZip(TableFormatter &formatter) const
+{
+    // Walk the cached ZIP index so the items themselves are not copied or re-sorted
+    ItemRange rows = sortedByZip();
+    PhaseTimer timer(MetricPhase::Output);
+    for (const auto &item : rows)
     {
-        item.printInfo();
-        cout << "-----------------------------------------------------------------------------------------------" << endl;
+        item.printInfo(formatter);
+        formatter.writeSeparator();
     }
 }
 
@@ -114,22 +648,21 @@ void PostalList::printSortedByZip() const
  */
 void PostalList::printSortedByState() const
 {
-    // Copy items so we don’t change the internal order
-    vector<PostalCodeItem> sortedItems = items;
-
-    sort(sortedItems.begin(), sortedItems.end(),
-         [](const PostalCodeItem &a, const PostalCodeItem &b)
-         {
-             if (a.getState() == b.getState())
-             {
-                 return a.getZip() < b.getZip(); // secondary sort by ZIP
-             }
-             return a.getState() < b.getState();
-         });
+    TableFormatter formatter(cout);
+    printSortedByState(formatter);
+}
 
-    for (const auto &item : sortedItems)
+/**
+ * @brief Same as printSortedByState(), written through a formatter.
+ * @param formatter Collects the rows and writes them in large chunks.
+ */
+void PostalList::printSortedByState(TableFormatter &formatter) const
+{
+    ItemRange rows = sortedByState();
+    PhaseTimer timer(MetricPhase::Output);
+    for (const auto &item : rows)
     {
-        item.printInfo();
-        cout << "-----------------------------------------------------------------------------------------------" << endl;
+        item.printInfo(formatter);
+        formatter.writeSeparator();
     }
 }
\ No newline at end of file
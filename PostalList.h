@@ -10,13 +10,27 @@
  * The PostalList class provides storage and utility functions for handling
  * multiple PostalCodeItem objects, including adding, searching, and printing
  * data in sorted order.
+ * Next to the items, the list keeps a columnar copy (PostalColumns) with one
+ * array per field and interned text fields. Searches and sorts run on those
+ * columns and only touch the items to hand them back or print them.
  */
 
 #ifndef POSTAL_LIST_H
 #define POSTAL_LIST_H
 
 #include "PostalCodeItem.h"
+#include "PostalColumns.h"
+#include "ZipTable.h"
+#include "PostingIndex.h"
+#include "PlaceIndex.h"
+#include "FuzzyIndex.h"
+#include "ItemRange.h"
+#include "RadixSort.h"
+#include "OrderBy.h"
+#include "TableFormatter.h"
+#include "PostalSnapshot.h"
 #include <vector>
+#include <string_view>
 
 using namespace std;
 
@@ -24,6 +38,54 @@ class PostalList
 {
 private:
     vector<PostalCodeItem> items; /**< Internal storage for postal code entries */
+    PostalColumns columns;        /**< Column-by-column copy of items used for scans and sorts */
+    ZipTable zipTable;            /**< ZIP code -> index, used by findByZip when enabled */
+    bool zipTableEnabled = true;  /**< Whether zipTable is kept up to date */
+    PostingIndex statePostings;   /**< State id -> rows, kept up to date by addItem */
+    PostingIndex countyPostings;  /**< County id -> rows, kept up to date by addItem */
+
+    mutable vector<uint32_t> zipOrder;    /**< Item indexes sorted by ZIP (rebuilt lazily) */
+    mutable vector<int32_t> zipOrderKeys; /**< ZIP of each zipOrder entry, for binary search */
+    mutable bool zipOrderValid = false;   /**< False after addItem until zipOrder is rebuilt */
+
+    mutable vector<uint32_t> stateOrder;  /**< Item indexes sorted by state, then ZIP (rebuilt lazily) */
+    mutable bool stateOrderValid = false; /**< False after addItem until stateOrder is rebuilt */
+
+    mutable PlaceIndex placeIndex;        /**< Place names for prefix search (rebuilt lazily) */
+    mutable bool placeIndexValid = false; /**< False after addItem until placeIndex is rebuilt */
+
+    mutable PostingIndex placePostings; /**< Place id -> rows (caught up lazily) */
+    mutable FuzzyIndex placeFuzzy;      /**< Trigrams of each place name, by place id (caught up lazily) */
+    mutable FuzzyIndex countyFuzzy;     /**< Trigrams of each county name, by county id (caught up lazily) */
+    mutable size_t fuzzyIndexedRows = 0; /**< Rows already in placePostings */
+
+    /**
+     * @brief Rebuild the ZIP order if addItem has changed the list since the last build.
+     */
+    void ensureZipOrder() const;
+
+    /**
+     * @brief Rebuild the state order if addItem has changed the list since the last build.
+     */
+    void ensureStateOrder() const;
+
+    /**
+     * @brief Rebuild the place index if addItem has changed the list since the last build.
+     */
+    void ensurePlaceIndex() const;
+
+    /**
+     * @brief Add the rows and names that addItem has added since the last
+     * fuzzySearch to the place postings and the trigram indexes.
+     */
+    void ensureFuzzyIndex() const;
+
+    /**
+     * @brief Add the items, postings and ZIP table entries for the column rows
+     * from @p first on, and mark the lazy indexes out of date.
+     * @param first The first row that has no item yet.
+     */
+    void indexNewRows(size_t first);
 
 public:
     // Constructors
@@ -32,31 +94,255 @@ public:
     /**
      * @brief Add a PostalCodeItem to the list.
      * @param item The PostalCodeItem to be added.
+     * @note The stored item does not copy the place, state and county strings;
+     * it points at the copy the column dictionaries already keep, so each
+     * distinct name is stored once however many rows use it.
      */
     void addItem(const PostalCodeItem &item);
 
+    /**
+     * @brief Add every row of a set of columns, in order.
+     * @param rows The rows to add, with their own dictionaries.
+     * @note The same as calling addItem() for each row, but each distinct name
+     * is interned once rather than once per row. The parallel loaders build
+     * one PostalColumns per chunk on their worker threads and add them here.
+     */
+    void addColumns(const PostalColumns &rows);
+
+    /**
+     * @brief Make room for a number of rows so the loaders do not regrow the storage.
+     * @param rows The expected total row count.
+     */
+    void reserve(size_t rows);
+
     /**
      * @brief Get a PostalCodeItem by index.
      * @param index The index of the item to retrieve.
-     * @return The PostalCodeItem at the specified index.
+     * @return The PostalCodeItem at the specified index, without copying it.
      * @throws out_of_range if the index is invalid.
+     * @note The reference is valid as long as the PostalList object exists and is not modified.
+     */
+    const PostalCodeItem &getItem(int index) const;
+
+    /**
+     * @brief Get the items as one contiguous array, in the order they were added.
+     * @return Pointer to size() items; valid until the list is modified.
      */
-    PostalCodeItem getItem(int index) const;
+    const PostalCodeItem *data() const;
+
+    /**
+     * @brief Get an iterator to the first item, for range-based for loops.
+     * @return Iterator over the items in the order they were added.
+     */
+    vector<PostalCodeItem>::const_iterator begin() const;
+
+    /**
+     * @brief Get an iterator past the last item.
+     * @return The end iterator.
+     */
+    vector<PostalCodeItem>::const_iterator end() const;
 
     /**
      * @brief Find a PostalCodeItem by its ZIP code.
      * @param zip The ZIP code to search for.
      * @return A pointer to the PostalCodeItem if found, nullptr otherwise.
      * @note The returned pointer is valid as long as the PostalList object exists and is not modified.
+     * @note With the ZIP table enabled (the default) this takes constant time;
+     * otherwise the ZIP column is searched front to back. Either way the
+     * first item added with that ZIP code is returned.
      */
     const PostalCodeItem *findByZip(int zip) const;
 
+    /**
+     * @brief Find the index of the item with a ZIP code.
+     * @param zip The ZIP code to search for.
+     * @return The index for getItem(), or -1 if no item has that ZIP code.
+     * @note Same lookup and cost as findByZip.
+     */
+    int findIndexByZip(int zip) const;
+
+    /**
+     * @brief Turn the ZIP lookup table on or off.
+     * @param enabled true to build the table now and keep it current in addItem.
+     * @note Turning it off frees the table (about 400 KB for 5-digit codes);
+     * findByZip then falls back to a linear search.
+     */
+    void setZipTableEnabled(bool enabled);
+
+    /**
+     * @brief Check whether findByZip uses the lookup table.
+     * @return true if the ZIP table is enabled.
+     */
+    bool isZipTableEnabled() const;
+
     /**
      * @brief Get the number of items in the list.
      * @return The number of PostalCodeItem objects in the list.
      */
     int size() const;
 
+    /**
+     * @brief Get every item in ascending ZIP order.
+     * @return A view over the sorted index; items with equal ZIP codes keep list order.
+     * @note The views returned by the ZIP range functions stay valid until the
+     * next addItem. The sorted index is rebuilt on the first query after a
+     * change, so do one query before sharing the list between threads.
+     */
+    ItemRange sortedByZip() const;
+
+    /**
+     * @brief Get every item ordered by state name, then by ZIP code.
+     * @return A view over the sorted index; items with the same state and ZIP keep list order.
+     * @note Like sortedByZip(), the index is built on the first call after an
+     * addItem and reused until the next one, so repeated walks copy nothing.
+     */
+    ItemRange sortedByState() const;
+
+    /**
+     * @brief Get the items in any column order, e.g. by county, place and then latitude descending.
+     * @param fields The ORDER BY list (see parseOrderBy()); items equal on every field keep list order.
+     * @param rows   Scratch space for the sorted row numbers; reuse it across calls.
+     * @param limit  Only the first @p limit items are wanted (0 = all of them).
+     * @return A view of the sorted items, valid while @p rows is unchanged and no item is added.
+     * @note Sorted fresh on every call through normalized keys (see orderRows());
+     * the ZIP and state orders above are cached and cheaper for those two orders.
+     */
+    ItemRange sortedBy(const vector<SortField> &fields, vector<uint32_t> &rows, size_t limit = 0) const;
+
+    /**
+     * @brief Get the items whose ZIP code is at least @p zip, in ZIP order.
+     * @param zip The smallest ZIP code to include.
+     * @return A view from the first such item to the end of the sorted index.
+     * @note O(log N) to find the start; the items themselves are not copied.
+     */
+    ItemRange lowerBound(int zip) const;
+
+    /**
+     * @brief Get the items with low <= ZIP <= high, in ZIP order.
+     * @param low  The smallest ZIP code to include.
+     * @param high The largest ZIP code to include.
+     * @return A view of the matching items (empty if low > high).
+     * @note O(log N + K) for K matches, e.g. findZipRange(55000, 55999).
+     */
+    ItemRange findZipRange(int low, int high) const;
+
+    /**
+     * @brief Get the 5-digit ZIP codes that start with some digits, in ZIP order.
+     * @param prefix 0 to 5 digits, e.g. "554" for 55400-55499 or "005" for 00500-00599.
+     * @return A view of the matching items.
+     * @throws invalid_argument if the prefix has non-digits or more than 5 characters.
+     */
+    ItemRange findByPrefix(const string &prefix) const;
+
+    /**
+     * @brief Get the items in a state.
+     * @param state The state, e.g. "MN".
+     * @return A view of the matching items in list order (empty for an unknown state).
+     * @note One hash lookup of the name; the rows come from a posting list kept
+     * up to date by addItem, so nothing is scanned or copied. The view stays
+     * valid until the next addItem.
+     */
+    ItemRange findByState(string_view state) const;
+
+    /**
+     * @brief Get the items in every county with some name, in any state.
+     * @param county The county, e.g. "Hennepin".
+     * @return A view of the matching items in list order (empty for an unknown county).
+     * @note Same cost and lifetime as findByState().
+     */
+    ItemRange findByCounty(string_view county) const;
+
+    /**
+     * @brief Get the items in one county of one state.
+     * @param state  The state, e.g. "MN".
+     * @param county The county, e.g. "Hennepin".
+     * @param rows   Scratch space for the matching row numbers; reuse it across
+     * calls so repeated queries do not allocate.
+     * @return A view of the matching items in list order, valid while @p rows
+     * is unchanged and no item is added.
+     * @note Intersects the state's and the county's posting lists.
+     */
+    ItemRange findByStateAndCounty(string_view state, string_view county, vector<uint32_t> &rows) const;
+
+    /**
+     * @brief Suggest places whose name starts with some text (autocomplete).
+     * @param prefix The typed text, e.g. "Holts"; case does not matter.
+     * @param limit  The most suggestions to return.
+     * @param out    Receives up to @p limit (place, state, ZIP) entries by place
+     * name and then ZIP code; reuse it across calls so queries do not allocate.
+     * @param state  Only suggest places in this state, e.g. "NY"; "" for any state.
+     * @note Two binary searches over the sorted place names, then only the
+     * returned rows are read. The index is built on the first call after an
+     * addItem, like sortedByZip(); the views in @p out stay valid until the
+     * list changes.
+     */
+    void completePlace(string_view prefix, size_t limit, vector<PlaceMatch> &out, string_view state = "") const;
+
+    /**
+     * @brief Find the items whose place or county name is close to some text (typo-tolerant search).
+     * @param query       The text, e.g. "Holtsvile" or "Sufolk"; case does not matter.
+     * @param limit       The most items to return.
+     * @param out         Receives up to @p limit matches, best first (cleared first).
+     * @param maxDistance The most edits (insert, delete or change a letter) allowed.
+     * @note Names are ranked by edit distance, then by score, place names
+     * before county names; the items of each name follow in list order, and
+     * an item matched by both names appears once. Candidate names come from
+     * trigram indexes, so no name list is scanned. The indexes are caught up
+     * with any rows added since the last call, so do one search before
+     * sharing the list between threads.
+     */
+    void fuzzySearch(string_view query, size_t limit, vector<FuzzyMatch> &out, int maxDistance = 2) const;
+
+    /**
+     * @brief Find every item inside a latitude/longitude box.
+     * @param minLat Southern edge (inclusive).
+     * @param maxLat Northern edge (inclusive).
+     * @param minLon Western edge (inclusive).
+     * @param maxLon Eastern edge (inclusive).
+     * @return The indexes of the matching items, in list order.
+     * @note Only the latitude and longitude columns are read.
+     */
+    vector<int> findInArea(double minLat, double maxLat, double minLon, double maxLon) const;
+
+    /**
+     * @brief Write the list to a binary snapshot file.
+     * @param fileName   Where to write it, e.g. PostalSnapshot::nameFor(sourceName).
+     * @param sourceName The file the list was loaded from, so PostalSnapshot::isStale() can tell when it changes.
+     * @return true if the file was written.
+     */
+    bool saveSnapshot(const string &fileName, const string &sourceName = "") const;
+
+    /**
+     * @brief Append every record of an open snapshot to the list.
+     * @param snapshot The snapshot.
+     * @return The number of records added.
+     * @note No text is parsed, but each record becomes a PostalCodeItem.
+     * For read-only use, query the snapshot directly instead.
+     */
+    int addSnapshot(const PostalSnapshot &snapshot);
+
+    /**
+     * @brief Get the columnar copy of the list.
+     * @return The columns; row i is the same record as getItem(i).
+     */
+    const PostalColumns &getColumns() const;
+
+    /**
+     * @brief Estimate the memory the PostalCodeItem objects use.
+     * @return Bytes of heap memory for the item vector.
+     * @note The items' strings live in the column dictionaries and are counted
+     * by getColumns().memoryBytes().
+     */
+    size_t itemMemoryBytes() const;
+
+    /**
+     * @brief Estimate the memory the state, county and place posting lists use.
+     * @return Bytes of heap memory for the three indexes.
+     * @note The place lists are built by fuzzySearch() and only hold the rows
+     * it has indexed so far.
+     */
+    size_t postingMemoryBytes() const;
+
     /**
      * @brief Print all PostalCodeItems in the list.
      * Each item's information is printed followed by a separator line.
@@ -64,6 +350,13 @@ public:
      */
     void printAll() const;
 
+    /**
+     * @brief Same as printAll(), written through a formatter.
+     * @param formatter Collects the rows and writes them in large chunks; its
+     * format decides the layout. Separator lines appear only in table mode.
+     */
+    void printAll(TableFormatter &formatter) const;
+
     /**
      * @brief Print PostalCodeItems sorted by ZIP code.
      * Each item's information is printed followed by a separator line.
@@ -71,12 +364,26 @@ public:
      */
     void printSortedByZip() const;
 
+    /**
+     * @brief Same as printSortedByZip(), written through a formatter.
+     * @param formatter Collects the rows and writes them in large chunks; its
+     * format decides the layout. Separator lines appear only in table mode.
+     */
+    void printSortedByZip(TableFormatter &formatter) const;
+
     /**
      * @brief Print PostalCodeItems sorted by state and then by ZIP code.
      * Each item's information is printed followed by a separator line.
      * @note Items are sorted first by state (alphabetically) and then by ZIP code (numerically) within each state.
      */
     void printSortedByState() const;
+
+    /**
+     * @brief Same as printSortedByState(), written through a formatter.
+     * @param formatter Collects the rows and writes them in large chunks; its
+     * format decides the layout. Separator lines appear only in table mode.
+     */
+    void printSortedByState(TableFormatter &formatter) const;
 };
 
 #include "PostalList.cpp"
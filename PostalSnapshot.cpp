@@ -0,0 +1,667 @@
+/**
+ * @file PostalSnapshot.cpp
+ * @brief Implementation of the PostalSnapshot class and the snapshot writer.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "PostalSnapshot.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+const char SNAPSHOT_MAGIC[8] = {'Z', 'I', 'P', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/**
+ * @brief Hash a block of bytes for the snapshot checksum.
+ * @param data The bytes.
+ * @param size How many bytes.
+ * @return A 64-bit hash.
+ */
+uint64_t snapshotChecksum(const char *data, size_t size)
+{
+    const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    uint64_t lanes[4] = {PRIME1, PRIME2, ~PRIME1, ~PRIME2};
+
+    // Four independent multiply-rotate chains keep the CPU busy on every cycle
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            uint64_t word;
+            memcpy(&word, data + i + lane * 8, 8);
+            lanes[lane] = (lanes[lane] ^ (word * PRIME2)) * PRIME1;
+            lanes[lane] = (lanes[lane] << 31) | (lanes[lane] >> 33);
+        }
+    }
+
+    uint64_t hash = size * PRIME1;
+    for (int lane = 0; lane < 4; lane++)
+    {
+        hash = ((hash ^ lanes[lane]) * PRIME2) + (hash >> 29);
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * PRIME1;
+    }
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Create a closed snapshot.
+ */
+PostalSnapshot::PostalSnapshot()
+{
+    header = nullptr;
+}
+
+/**
+ * @brief Write a snapshot of some columns.
+ * @param fileName   Where to write it (replaced if it exists).
+ * @param columns    The records.
+ * @param zipOrder   Rows sorted by ZIP, equal ZIP codes in row order.
+ * @param stateOrder Rows sorted by state, then ZIP.
+ * @param states     Rows of each state id.
+ * @param counties   Rows of each county id.
+ * @param places     The place-name prefix index.
+ * @param sourceName The file the records came from, for isStale(); "" for none.
+ * @return true if the whole file was written.
+ */
+bool PostalSnapshot::write(const string &fileName, const PostalColumns &columns, const uint32_t *zipOrder,
+                           const uint32_t *stateOrder, const PostingIndex &states, const PostingIndex &counties,
+                           const PlaceIndex &places, const string &sourceName)
+{
+    SnapshotHeader head = {};
+    memcpy(head.magic, SNAPSHOT_MAGIC, sizeof(head.magic));
+    head.version = SNAPSHOT_VERSION;
+    head.byteOrder = SNAPSHOT_BYTE_ORDER;
+    head.rowCount = columns.size();
+    head.placeCount = static_cast<uint32_t>(columns.placeDictionary().size());
+    head.stateCount = static_cast<uint32_t>(columns.stateDictionary().size());
+    head.countyCount = static_cast<uint32_t>(columns.countyDictionary().size());
+    if (sourceName.empty() || !fileStamp(sourceName, head.sourceSize, head.sourceModified))
+    {
+        head.sourceSize = 0;
+        head.sourceModified = -1;
+    }
+
+    // Build everything after the header in memory, each section padded to 8 bytes
+    string body;
+    auto startSection = [&](SnapshotSection which)
+    {
+        body.append((8 - body.size() % 8) % 8, '\0');
+        head.sections[which] = sizeof(SnapshotHeader) + body.size();
+    };
+    auto appendArray = [&](SnapshotSection which, const void *data, size_t bytes)
+    {
+        startSection(which);
+        body.append(static_cast<const char *>(data), bytes);
+    };
+    auto appendStrings = [&](SnapshotSection offsetSection, SnapshotSection byteSection, const StringDictionary &strings)
+    {
+        vector<uint32_t> offsets(1, 0);
+        string pool;
+        for (uint32_t id = 0; id < strings.size(); id++)
+        {
+            pool += strings.at(id);
+            offsets.push_back(static_cast<uint32_t>(pool.size()));
+        }
+        appendArray(offsetSection, offsets.data(), offsets.size() * sizeof(uint32_t));
+        appendArray(byteSection, pool.data(), pool.size());
+    };
+    auto appendPostings = [&](SnapshotSection offsetSection, SnapshotSection rowSection, const PostingIndex &index,
+                              size_t keyCount)
+    {
+        vector<uint32_t> offsets;
+        vector<uint32_t> rows;
+        index.flatten(offsets, rows);
+        offsets.resize(keyCount + 1, offsets.back()); // ids with no rows get empty lists
+        appendArray(offsetSection, offsets.data(), offsets.size() * sizeof(uint32_t));
+        appendArray(rowSection, rows.data(), rows.size() * sizeof(uint32_t));
+    };
+
+    size_t rows = columns.size();
+    vector<int32_t> zipKeys(rows);
+    for (size_t i = 0; i < rows; i++)
+    {
+        zipKeys[i] = columns.zipData()[zipOrder[i]];
+    }
+
+    appendArray(SECTION_ZIPS, columns.zipData(), rows * sizeof(int32_t));
+    appendArray(SECTION_LATITUDES, columns.latitudeData(), rows * sizeof(double));
+    appendArray(SECTION_LONGITUDES, columns.longitudeData(), rows * sizeof(double));
+    appendArray(SECTION_PLACE_IDS, columns.placeIdData(), rows * sizeof(uint32_t));
+    appendArray(SECTION_STATE_IDS, columns.stateIdData(), rows * sizeof(uint32_t));
+    appendArray(SECTION_COUNTY_IDS, columns.countyIdData(), rows * sizeof(uint32_t));
+    appendArray(SECTION_ZIP_ORDER, zipOrder, rows * sizeof(uint32_t));
+    appendArray(SECTION_ZIP_KEYS, zipKeys.data(), rows * sizeof(int32_t));
+    appendArray(SECTION_STATE_ORDER, stateOrder, rows * sizeof(uint32_t));
+    appendStrings(SECTION_PLACE_OFFSETS, SECTION_PLACE_BYTES, columns.placeDictionary());
+    appendStrings(SECTION_STATE_OFFSETS, SECTION_STATE_BYTES, columns.stateDictionary());
+    appendStrings(SECTION_COUNTY_OFFSETS, SECTION_COUNTY_BYTES, columns.countyDictionary());
+    appendPostings(SECTION_STATE_POSTING_OFFSETS, SECTION_STATE_POSTINGS, states, head.stateCount);
+    appendPostings(SECTION_COUNTY_POSTING_OFFSETS, SECTION_COUNTY_POSTINGS, counties, head.countyCount);
+    appendArray(SECTION_PLACE_SORTED, places.placeIds().data(), places.placeIds().size() * sizeof(uint32_t));
+    appendArray(SECTION_PLACE_STARTS, places.rowStarts().data(), places.rowStarts().size() * sizeof(uint32_t));
+    appendArray(SECTION_PLACE_ORDER, places.rowOrder().data(), places.rowOrder().size() * sizeof(uint32_t));
+    startSection(SECTION_COUNT);
+
+    head.fileSize = sizeof(SnapshotHeader) + body.size();
+    head.checksum = snapshotChecksum(body.data(), body.size());
+
+    return replaceFile(fileName, {string_view(reinterpret_cast<const char *>(&head), sizeof(head)), body});
+}
+
+/**
+ * @brief Get the usual snapshot name for a source file.
+ * @param sourceName e.g. "us_postal_codes.csv".
+ * @return The name with its extension replaced by ".snap".
+ */
+string PostalSnapshot::nameFor(const string &sourceName)
+{
+    size_t dot = sourceName.find_last_of('.');
+    size_t slash = sourceName.find_last_of("/\\");
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+    {
+        return sourceName + ".snap";
+    }
+    return sourceName.substr(0, dot) + ".snap";
+}
+
+/**
+ * @brief Map a snapshot and check its header and layout.
+ * @param fileName The snapshot file.
+ * @return true if the file is a version-4 snapshot whose sections all fit in it.
+ */
+bool PostalSnapshot::open(const string &fileName)
+{
+    PhaseTimer timer(MetricPhase::Read);
+    close();
+    if (!file.open(fileName, AccessPattern::Normal) || file.size() < sizeof(SnapshotHeader))
+    {
+        close();
+        return false;
+    }
+
+    const SnapshotHeader *head = reinterpret_cast<const SnapshotHeader *>(file.data());
+    bool valid = memcmp(head->magic, SNAPSHOT_MAGIC, sizeof(head->magic)) == 0 &&
+                 head->version == SNAPSHOT_VERSION &&
+                 head->byteOrder == SNAPSHOT_BYTE_ORDER &&
+                 head->fileSize == file.size() &&
+                 head->rowCount <= 0xFFFFFFFFull;
+
+    // Each section must be aligned, in order, inside the file, and big enough for its contents
+    const uint64_t rows = head->rowCount;
+    const uint64_t minimum[SECTION_COUNT] = {
+        rows * 4, rows * 8, rows * 8, rows * 4, rows * 4, rows * 4, rows * 4, rows * 4, rows * 4,
+        (head->placeCount + 1ull) * 4, 0, (head->stateCount + 1ull) * 4, 0, (head->countyCount + 1ull) * 4, 0,
+        (head->stateCount + 1ull) * 4, rows * 4, (head->countyCount + 1ull) * 4, rows * 4,
+        head->placeCount * 4ull, (head->placeCount + 1ull) * 4, rows * 4};
+    uint64_t previous = sizeof(SnapshotHeader);
+    for (int i = 0; valid && i < SECTION_COUNT; i++)
+    {
+        uint64_t start = head->sections[i];
+        uint64_t end = head->sections[i + 1];
+        valid = start % 8 == 0 && start >= previous && end >= start && end <= head->fileSize &&
+                end - start >= minimum[i];
+        previous = start;
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+    header = head;
+    Metrics::add(MetricCounter::BytesRead, file.size());
+    return true;
+}
+
+/**
+ * @brief Unmap the snapshot.
+ */
+void PostalSnapshot::close()
+{
+    file.close();
+    header = nullptr;
+}
+
+/**
+ * @brief Check whether a snapshot is open.
+ * @return true after a successful open().
+ */
+bool PostalSnapshot::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Get a typed pointer to the start of a section (nullptr when closed).
+ */
+template <typename T>
+const T *PostalSnapshot::section(SnapshotSection which) const
+{
+    if (header == nullptr)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const T *>(file.data() + header->sections[which]);
+}
+
+/**
+ * @brief Look up string @p id in one of the string pools.
+ */
+string_view PostalSnapshot::text(SnapshotSection offsets, SnapshotSection bytes, uint32_t id) const
+{
+    const uint32_t *bounds = section<uint32_t>(offsets);
+    return string_view(section<char>(bytes) + bounds[id], bounds[id + 1] - bounds[id]);
+}
+
+/**
+ * @brief Check the checksum and that every id and string offset is in range.
+ * @return true if the contents are intact.
+ */
+bool PostalSnapshot::verify() const
+{
+    if (!isOpen())
+    {
+        return false;
+    }
+    const char *body = file.data() + sizeof(SnapshotHeader);
+    if (snapshotChecksum(body, header->fileSize - sizeof(SnapshotHeader)) != header->checksum)
+    {
+        return false;
+    }
+
+    // Offsets must count up and stay inside their pool
+    const SnapshotSection pools[3][2] = {{SECTION_PLACE_OFFSETS, SECTION_PLACE_BYTES},
+                                         {SECTION_STATE_OFFSETS, SECTION_STATE_BYTES},
+                                         {SECTION_COUNTY_OFFSETS, SECTION_COUNTY_BYTES}};
+    const uint32_t counts[3] = {header->placeCount, header->stateCount, header->countyCount};
+    for (int p = 0; p < 3; p++)
+    {
+        const uint32_t *offsets = section<uint32_t>(pools[p][0]);
+        uint64_t poolSize = header->sections[pools[p][1] + 1] - header->sections[pools[p][1]];
+        if (offsets[0] != 0 || offsets[counts[p]] > poolSize)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < counts[p]; i++)
+        {
+            if (offsets[i] > offsets[i + 1])
+            {
+                return false;
+            }
+        }
+    }
+
+    // Each posting list must cover every row once, ascending inside each id
+    const SnapshotSection postingLists[2][2] = {{SECTION_STATE_POSTING_OFFSETS, SECTION_STATE_POSTINGS},
+                                                {SECTION_COUNTY_POSTING_OFFSETS, SECTION_COUNTY_POSTINGS}};
+    for (int p = 0; p < 2; p++)
+    {
+        const uint32_t *offsets = section<uint32_t>(postingLists[p][0]);
+        const uint32_t *rows = section<uint32_t>(postingLists[p][1]);
+        uint32_t count = counts[p + 1];
+        if (offsets[0] != 0 || offsets[count] != size())
+        {
+            return false;
+        }
+        for (uint32_t id = 0; id < count; id++)
+        {
+            if (offsets[id] > offsets[id + 1])
+            {
+                return false;
+            }
+            for (uint32_t i = offsets[id]; i < offsets[id + 1]; i++)
+            {
+                if (rows[i] >= size() || (i > offsets[id] && rows[i] <= rows[i - 1]))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Each place's run of the name order must hold only rows with that place
+    const uint32_t *places = section<uint32_t>(SECTION_PLACE_IDS);
+    const uint32_t *sortedPlaces = section<uint32_t>(SECTION_PLACE_SORTED);
+    const uint32_t *placeStarts = section<uint32_t>(SECTION_PLACE_STARTS);
+    const uint32_t *byPlace = section<uint32_t>(SECTION_PLACE_ORDER);
+    if (placeStarts[0] != 0 || placeStarts[header->placeCount] != size())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < header->placeCount; i++)
+    {
+        if (sortedPlaces[i] >= header->placeCount || placeStarts[i] > placeStarts[i + 1])
+        {
+            return false;
+        }
+        for (uint32_t j = placeStarts[i]; j < placeStarts[i + 1]; j++)
+        {
+            if (byPlace[j] >= size() || places[byPlace[j]] != sortedPlaces[i])
+            {
+                return false;
+            }
+        }
+    }
+
+    const uint32_t *states = section<uint32_t>(SECTION_STATE_IDS);
+    const uint32_t *counties = section<uint32_t>(SECTION_COUNTY_IDS);
+    const uint32_t *byZip = section<uint32_t>(SECTION_ZIP_ORDER);
+    const uint32_t *byState = section<uint32_t>(SECTION_STATE_ORDER);
+    for (size_t i = 0; i < size(); i++)
+    {
+        if (places[i] >= header->placeCount || states[i] >= header->stateCount ||
+            counties[i] >= header->countyCount || byZip[i] >= size() || byState[i] >= size())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check whether the source file changed since the snapshot was made.
+ * @param sourceName The CSV or length-indicated file.
+ * @return true if the source's size or modification time differ, or it cannot be read.
+ */
+bool PostalSnapshot::isStale(const string &sourceName) const
+{
+    uint64_t sourceSize;
+    int64_t modified;
+    if (!isOpen() || !fileStamp(sourceName, sourceSize, modified))
+    {
+        return true;
+    }
+    return sourceSize != header->sourceSize || modified != header->sourceModified;
+}
+
+/**
+ * @brief Get the number of records.
+ * @return The row count (0 when closed).
+ */
+size_t PostalSnapshot::size() const
+{
+    return isOpen() ? header->rowCount : 0;
+}
+
+/**
+ * @brief Get the ZIP code of a row.
+ * @param row The row number.
+ * @return The ZIP code.
+ */
+int PostalSnapshot::zip(size_t row) const
+{
+    return section<int32_t>(SECTION_ZIPS)[row];
+}
+
+/**
+ * @brief Get the latitude of a row.
+ * @param row The row number.
+ * @return The latitude.
+ */
+double PostalSnapshot::latitude(size_t row) const
+{
+    return section<double>(SECTION_LATITUDES)[row];
+}
+
+/**
+ * @brief Get the longitude of a row.
+ * @param row The row number.
+ * @return The longitude.
+ */
+double PostalSnapshot::longitude(size_t row) const
+{
+    return section<double>(SECTION_LONGITUDES)[row];
+}
+
+/**
+ * @brief Get the place name of a row.
+ * @param row The row number.
+ * @return A view into the mapped string pool.
+ */
+string_view PostalSnapshot::place(size_t row) const
+{
+    return text(SECTION_PLACE_OFFSETS, SECTION_PLACE_BYTES, section<uint32_t>(SECTION_PLACE_IDS)[row]);
+}
+
+/**
+ * @brief Get the state of a row.
+ * @param row The row number.
+ * @return A view into the mapped string pool.
+ */
+string_view PostalSnapshot::state(size_t row) const
+{
+    return text(SECTION_STATE_OFFSETS, SECTION_STATE_BYTES, section<uint32_t>(SECTION_STATE_IDS)[row]);
+}
+
+/**
+ * @brief Get the county of a row.
+ * @param row The row number.
+ * @return A view into the mapped string pool.
+ */
+string_view PostalSnapshot::county(size_t row) const
+{
+    return text(SECTION_COUNTY_OFFSETS, SECTION_COUNTY_BYTES, section<uint32_t>(SECTION_COUNTY_IDS)[row]);
+}
+
+/**
+ * @brief Rebuild a full PostalCodeItem from one row.
+ * @param row The row number.
+ * @return A new item with the row's values.
+ */
+PostalCodeItem PostalSnapshot::row(size_t row) const
+{
+    return PostalCodeItem(zip(row), place(row), state(row), county(row), latitude(row), longitude(row));
+}
+
+/**
+ * @brief Find the row of a ZIP code.
+ * @param zip The ZIP code.
+ * @return The first row with that ZIP code, or -1.
+ */
+int PostalSnapshot::findIndexByZip(int zip) const
+{
+    const int32_t *keys = section<int32_t>(SECTION_ZIP_KEYS);
+    const int32_t *found = lower_bound(keys, keys + size(), zip);
+    if (found == keys + size() || *found != zip)
+    {
+        return -1;
+    }
+    return static_cast<int>(zipOrder()[found - keys]);
+}
+
+/**
+ * @brief Get the rows in ZIP order.
+ * @return Pointer to size() row numbers.
+ */
+const uint32_t *PostalSnapshot::zipOrder() const
+{
+    return section<uint32_t>(SECTION_ZIP_ORDER);
+}
+
+/**
+ * @brief Get the rows ordered by state, then ZIP.
+ * @return Pointer to size() row numbers.
+ */
+const uint32_t *PostalSnapshot::stateOrder() const
+{
+    return section<uint32_t>(SECTION_STATE_ORDER);
+}
+
+/**
+ * @brief Get the rows with low <= ZIP <= high.
+ * @param low  The smallest ZIP code to include.
+ * @param high The largest ZIP code to include.
+ * @return First and one-past-last row numbers in zipOrder().
+ */
+pair<const uint32_t *, const uint32_t *> PostalSnapshot::findZipRange(int low, int high) const
+{
+    const int32_t *keys = section<int32_t>(SECTION_ZIP_KEYS);
+    if (low > high)
+    {
+        return {zipOrder(), zipOrder()};
+    }
+    size_t start = lower_bound(keys, keys + size(), low) - keys;
+    size_t stop = upper_bound(keys + start, keys + size(), high) - keys;
+    return {zipOrder() + start, zipOrder() + stop};
+}
+
+/**
+ * @brief Find the id of a string in one of the string pools (npos if absent).
+ */
+uint32_t PostalSnapshot::findText(SnapshotSection offsets, SnapshotSection bytes, uint32_t count, string_view value) const
+{
+    for (uint32_t id = 0; id < count; id++)
+    {
+        if (text(offsets, bytes, id) == value)
+        {
+            return id;
+        }
+    }
+    return StringDictionary::npos;
+}
+
+/**
+ * @brief Get the posting list of an id (empty if the id is out of range).
+ */
+pair<const uint32_t *, const uint32_t *> PostalSnapshot::postings(SnapshotSection offsets, SnapshotSection rows,
+                                                                  uint32_t count, uint32_t id) const
+{
+    if (!isOpen() || id >= count)
+    {
+        return {nullptr, nullptr};
+    }
+    const uint32_t *bounds = section<uint32_t>(offsets);
+    const uint32_t *list = section<uint32_t>(rows);
+    return {list + bounds[id], list + bounds[id + 1]};
+}
+
+/**
+ * @brief Get the rows in a state.
+ * @param state The state, e.g. "MN".
+ * @return First and one-past-last row number, ascending.
+ */
+pair<const uint32_t *, const uint32_t *> PostalSnapshot::findByState(string_view state) const
+{
+    if (!isOpen())
+    {
+        return {nullptr, nullptr};
+    }
+    uint32_t id = findText(SECTION_STATE_OFFSETS, SECTION_STATE_BYTES, header->stateCount, state);
+    return postings(SECTION_STATE_POSTING_OFFSETS, SECTION_STATE_POSTINGS, header->stateCount, id);
+}
+
+/**
+ * @brief Get the rows in every county with some name, in any state.
+ * @param county The county, e.g. "Hennepin".
+ * @return First and one-past-last row number, ascending.
+ */
+pair<const uint32_t *, const uint32_t *> PostalSnapshot::findByCounty(string_view county) const
+{
+    if (!isOpen())
+    {
+        return {nullptr, nullptr};
+    }
+    uint32_t id = findText(SECTION_COUNTY_OFFSETS, SECTION_COUNTY_BYTES, header->countyCount, county);
+    return postings(SECTION_COUNTY_POSTING_OFFSETS, SECTION_COUNTY_POSTINGS, header->countyCount, id);
+}
+
+/**
+ * @brief Get the rows in one county of one state.
+ * @param state  The state.
+ * @param county The county.
+ * @param rows   Receives the matching row numbers, ascending.
+ */
+void PostalSnapshot::findByStateAndCounty(string_view state, string_view county, vector<uint32_t> &rows) const
+{
+    auto inState = findByState(state);
+    auto inCounty = findByCounty(county);
+    intersectRows(inState.first, inState.second, inCounty.first, inCounty.second, rows);
+}
+
+/**
+ * @brief Suggest places whose name starts with some text.
+ * @param prefix The typed text; case does not matter.
+ * @param limit  The most suggestions to return.
+ * @param out    Receives the suggestions by place name and then ZIP.
+ * @param state  Only suggest places in this state; "" for any state.
+ */
+void PostalSnapshot::completePlace(string_view prefix, size_t limit, vector<PlaceMatch> &out, string_view state) const
+{
+    out.clear();
+    if (!isOpen())
+    {
+        return;
+    }
+    uint32_t stateId = StringDictionary::npos;
+    if (!state.empty())
+    {
+        stateId = findText(SECTION_STATE_OFFSETS, SECTION_STATE_BYTES, header->stateCount, state);
+        if (stateId == StringDictionary::npos)
+        {
+            return;
+        }
+    }
+
+    auto found = findFoldedPrefix(section<uint32_t>(SECTION_PLACE_SORTED), header->placeCount,
+                                  [&](uint32_t id)
+                                  { return text(SECTION_PLACE_OFFSETS, SECTION_PLACE_BYTES, id); },
+                                  prefix);
+    const uint32_t *starts = section<uint32_t>(SECTION_PLACE_STARTS);
+    const uint32_t *byPlace = section<uint32_t>(SECTION_PLACE_ORDER);
+    const uint32_t *states = section<uint32_t>(SECTION_STATE_IDS);
+    for (uint32_t i = starts[found.first]; i < starts[found.second] && out.size() < limit; i++)
+    {
+        uint32_t row = byPlace[i];
+        if (stateId == StringDictionary::npos || states[row] == stateId)
+        {
+            out.push_back({place(row), this->state(row), zip(row), row});
+        }
+    }
+}
+
+/**
+ * @brief Print every row in ZIP order.
+ * @param formatter Where the rows go.
+ */
+void PostalSnapshot::printSortedByZip(TableFormatter &formatter) const
+{
+    const uint32_t *rows = zipOrder();
+    PhaseTimer timer(MetricPhase::Output);
+    for (size_t i = 0; i < size(); i++)
+    {
+        formatter.writeRow(zip(rows[i]), place(rows[i]), state(rows[i]), county(rows[i]),
+                           latitude(rows[i]), longitude(rows[i]));
+        formatter.writeSeparator();
+    }
+}
+
+/**
+ * @brief Print every row by state and ZIP.
+ * @param formatter Where the rows go.
+ */
+void PostalSnapshot::printSortedByState(TableFormatter &formatter) const
+{
+    const uint32_t *rows = stateOrder();
+    PhaseTimer timer(MetricPhase::Output);
+    for (size_t i = 0; i < size(); i++)
+    {
+        formatter.writeRow(zip(rows[i]), place(rows[i]), state(rows[i]), county(rows[i]),
+                           latitude(rows[i]), longitude(rows[i]));
+        formatter.writeSeparator();
+    }
+}
@@ -0,0 +1,327 @@
+/**
+ * @file PostalSnapshot.h
+ * @brief Defines the PostalSnapshot class, a memory-mapped binary copy of a postal list.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Parsing the CSV on every run costs tens of milliseconds. A snapshot file
+ * holds the list already laid out the way PostalColumns keeps it: one
+ * fixed-width array per field, a string pool per text field, and the ZIP and
+ * state sort orders. Opening one maps the file and checks the header; every
+ * query then reads the mapped arrays directly, with no parsing and no
+ * per-item allocation.
+ *
+ * File layout (version 4, little-endian, every section 8-byte aligned):
+ * - SnapshotHeader: magic "ZIPSNAP\0", version, byte-order mark, file size,
+ *   checksum of everything after the header, row count, source file size
+ *   and modification time, string counts, and the offset of each section.
+ * - zips (int32), latitudes and longitudes (double), place, state and
+ *   county ids (all uint32), one per row.
+ * - zipOrder (uint32 rows, stable by ZIP), zipKeys (the ZIP of each
+ *   zipOrder entry), stateOrder (uint32 rows by state, then ZIP).
+ * - For places, states and counties: count + 1 uint32 offsets into a byte
+ *   pool; string i is pool[offsets[i], offsets[i + 1]).
+ * - For states and counties: count + 1 uint32 offsets into a row array;
+ *   the rows of id i, ascending, are rows[offsets[i], offsets[i + 1])
+ *   (the PostalList's posting lists, so state and county queries need no scan).
+ * - The place-name prefix index (PlaceIndex): placeCount uint32 place ids in
+ *   case-insensitive name order, placeCount + 1 uint32 starts, and every row
+ *   by place name and then ZIP; name i owns rows[starts[i], starts[i + 1]).
+ *
+ * Version 1 files had no posting lists, version 2 files no place index and
+ * version 3 files 16-bit state ids; open() rejects all three.
+ */
+
+#ifndef POSTAL_SNAPSHOT_H
+#define POSTAL_SNAPSHOT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "PostalColumns.h"
+#include "MappedFile.h"
+#include "TableFormatter.h"
+#include "PostingIndex.h"
+#include "PlaceIndex.h"
+
+using namespace std;
+
+/**
+ * @brief The sections of a snapshot file, in file order.
+ */
+enum SnapshotSection
+{
+    SECTION_ZIPS,
+    SECTION_LATITUDES,
+    SECTION_LONGITUDES,
+    SECTION_PLACE_IDS,
+    SECTION_STATE_IDS,
+    SECTION_COUNTY_IDS,
+    SECTION_ZIP_ORDER,
+    SECTION_ZIP_KEYS,
+    SECTION_STATE_ORDER,
+    SECTION_PLACE_OFFSETS,
+    SECTION_PLACE_BYTES,
+    SECTION_STATE_OFFSETS,
+    SECTION_STATE_BYTES,
+    SECTION_COUNTY_OFFSETS,
+    SECTION_COUNTY_BYTES,
+    SECTION_STATE_POSTING_OFFSETS,
+    SECTION_STATE_POSTINGS,
+    SECTION_COUNTY_POSTING_OFFSETS,
+    SECTION_COUNTY_POSTINGS,
+    SECTION_PLACE_SORTED,
+    SECTION_PLACE_STARTS,
+    SECTION_PLACE_ORDER,
+    SECTION_COUNT
+};
+
+/**
+ * @brief The fixed header at the start of a snapshot file.
+ */
+struct SnapshotHeader
+{
+    char magic[8];                        /**< "ZIPSNAP\0" */
+    uint32_t version;                     /**< SNAPSHOT_VERSION */
+    uint32_t byteOrder;                   /**< 0x01020304 as written by this machine */
+    uint64_t fileSize;                    /**< Total bytes, header included */
+    uint64_t checksum;                    /**< snapshotChecksum() of the bytes after the header */
+    uint64_t rowCount;                    /**< Number of records */
+    uint64_t sourceSize;                  /**< Size of the file the snapshot was made from */
+    int64_t sourceModified;               /**< Its modification time (seconds since 1970) */
+    uint32_t placeCount;                  /**< Distinct place names */
+    uint32_t stateCount;                  /**< Distinct states */
+    uint32_t countyCount;                 /**< Distinct counties */
+    uint32_t reserved;                    /**< Zero */
+    uint64_t sections[SECTION_COUNT + 1]; /**< Offset of each section; the last entry is the end */
+};
+
+const uint32_t SNAPSHOT_VERSION = 4;
+
+/**
+ * @brief Hash a block of bytes for the snapshot checksum.
+ * @param data The bytes.
+ * @param size How many bytes.
+ * @return A 64-bit hash; any changed byte changes it with high probability.
+ * @note Reads 8 bytes at a time over 4 independent lanes (several GB/s),
+ * so checking a whole snapshot takes well under a millisecond.
+ */
+uint64_t snapshotChecksum(const char *data, size_t size);
+
+class PostalSnapshot
+{
+private:
+    MappedFile file;                /**< The mapped snapshot */
+    const SnapshotHeader *header;   /**< Start of the mapping (nullptr when closed) */
+
+    template <typename T>
+    const T *section(SnapshotSection which) const;
+    string_view text(SnapshotSection offsets, SnapshotSection bytes, uint32_t id) const;
+    uint32_t findText(SnapshotSection offsets, SnapshotSection bytes, uint32_t count, string_view value) const;
+    pair<const uint32_t *, const uint32_t *> postings(SnapshotSection offsets, SnapshotSection rows,
+                                                      uint32_t count, uint32_t id) const;
+
+public:
+    /**
+     * @brief Create a closed snapshot.
+     */
+    PostalSnapshot();
+
+    PostalSnapshot(const PostalSnapshot &) = delete;
+    PostalSnapshot &operator=(const PostalSnapshot &) = delete;
+
+    /**
+     * @brief Write a snapshot of some columns.
+     * @param fileName   Where to write it (replaced if it exists, see replaceFile()).
+     * @param columns    The records.
+     * @param zipOrder   Rows sorted by ZIP, equal ZIP codes in row order.
+     * @param stateOrder Rows sorted by state, then ZIP.
+     * @param states     Rows of each state id.
+     * @param counties   Rows of each county id.
+     * @param places     The place-name prefix index, built for @p columns.
+     * @param sourceName The file the records came from, for isStale(); "" for none.
+     * @return true if the whole file was written.
+     * @note PostalList::saveSnapshot() fills in the orders and indexes; use that.
+     */
+    static bool write(const string &fileName, const PostalColumns &columns, const uint32_t *zipOrder,
+                      const uint32_t *stateOrder, const PostingIndex &states, const PostingIndex &counties,
+                      const PlaceIndex &places, const string &sourceName);
+
+    /**
+     * @brief Get the usual snapshot name for a source file.
+     * @param sourceName e.g. "us_postal_codes.csv".
+     * @return The name with its extension replaced by ".snap", e.g. "us_postal_codes.snap".
+     */
+    static string nameFor(const string &sourceName);
+
+    /**
+     * @brief Map a snapshot and check its header and layout.
+     * @param fileName The snapshot file.
+     * @return true if the file is a version-4 snapshot whose sections all fit in it.
+     * @note Only the header is read, so this takes microseconds. It does not
+     * check the checksum; call verify() for files that may be damaged.
+     */
+    bool open(const string &fileName);
+
+    /**
+     * @brief Unmap the snapshot.
+     */
+    void close();
+
+    /**
+     * @brief Check whether a snapshot is open.
+     * @return true after a successful open().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Check the checksum and that every id and string offset is in range.
+     * @return true if the contents are intact.
+     * @note Reads the whole file (a fraction of a millisecond for the US data).
+     */
+    bool verify() const;
+
+    /**
+     * @brief Check whether the source file changed since the snapshot was made.
+     * @param sourceName The CSV or length-indicated file.
+     * @return true if the source's size or modification time differ from the
+     * recorded ones, or the source cannot be read.
+     */
+    bool isStale(const string &sourceName) const;
+
+    /**
+     * @brief Get the number of records.
+     * @return The row count (0 when closed).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the ZIP code of a row.
+     * @param row The row number (not checked).
+     * @return The ZIP code.
+     */
+    int zip(size_t row) const;
+
+    /**
+     * @brief Get the latitude of a row.
+     * @param row The row number (not checked).
+     * @return The latitude.
+     */
+    double latitude(size_t row) const;
+
+    /**
+     * @brief Get the longitude of a row.
+     * @param row The row number (not checked).
+     * @return The longitude.
+     */
+    double longitude(size_t row) const;
+
+    /**
+     * @brief Get the place name of a row.
+     * @param row The row number (not checked).
+     * @return A view into the mapped string pool.
+     */
+    string_view place(size_t row) const;
+
+    /**
+     * @brief Get the state of a row.
+     * @param row The row number (not checked).
+     * @return A view into the mapped string pool.
+     */
+    string_view state(size_t row) const;
+
+    /**
+     * @brief Get the county of a row.
+     * @param row The row number (not checked).
+     * @return A view into the mapped string pool.
+     */
+    string_view county(size_t row) const;
+
+    /**
+     * @brief Rebuild a full PostalCodeItem from one row.
+     * @param row The row number.
+     * @return A new item with the row's values.
+     */
+    PostalCodeItem row(size_t row) const;
+
+    /**
+     * @brief Find the row of a ZIP code.
+     * @param zip The ZIP code.
+     * @return The first row with that ZIP code, or -1. O(log N) on the stored ZIP order.
+     */
+    int findIndexByZip(int zip) const;
+
+    /**
+     * @brief Get the rows in ZIP order.
+     * @return Pointer to size() row numbers.
+     */
+    const uint32_t *zipOrder() const;
+
+    /**
+     * @brief Get the rows ordered by state, then ZIP.
+     * @return Pointer to size() row numbers.
+     */
+    const uint32_t *stateOrder() const;
+
+    /**
+     * @brief Get the rows with low <= ZIP <= high.
+     * @param low  The smallest ZIP code to include.
+     * @param high The largest ZIP code to include.
+     * @return First and one-past-last row numbers in zipOrder().
+     */
+    pair<const uint32_t *, const uint32_t *> findZipRange(int low, int high) const;
+
+    /**
+     * @brief Get the rows in a state.
+     * @param state The state, e.g. "MN".
+     * @return First and one-past-last row number, ascending (empty for an unknown state).
+     * @note The name is found by comparing it with each state name (about 60).
+     */
+    pair<const uint32_t *, const uint32_t *> findByState(string_view state) const;
+
+    /**
+     * @brief Get the rows in every county with some name, in any state.
+     * @param county The county, e.g. "Hennepin".
+     * @return First and one-past-last row number, ascending (empty for an unknown county).
+     * @note The name is found by comparing it with each county name (about 1,900, a few microseconds).
+     */
+    pair<const uint32_t *, const uint32_t *> findByCounty(string_view county) const;
+
+    /**
+     * @brief Get the rows in one county of one state.
+     * @param state  The state.
+     * @param county The county.
+     * @param rows   Receives the matching row numbers, ascending.
+     */
+    void findByStateAndCounty(string_view state, string_view county, vector<uint32_t> &rows) const;
+
+    /**
+     * @brief Suggest places whose name starts with some text, as PostalList::completePlace() does.
+     * @param prefix The typed text; case does not matter.
+     * @param limit  The most suggestions to return.
+     * @param out    Receives the suggestions by place name and then ZIP; the
+     * views point into the mapping and stay valid until close().
+     * @param state  Only suggest places in this state; "" for any state.
+     */
+    void completePlace(string_view prefix, size_t limit, vector<PlaceMatch> &out, string_view state = "") const;
+
+    /**
+     * @brief Print every row in ZIP order, as PostalList::printSortedByZip() does.
+     * @param formatter Where the rows go.
+     */
+    void printSortedByZip(TableFormatter &formatter) const;
+
+    /**
+     * @brief Print every row by state and ZIP, as PostalList::printSortedByState() does.
+     * @param formatter Where the rows go.
+     */
+    void printSortedByState(TableFormatter &formatter) const;
+};
+
+#include "PostalSnapshot.cpp"
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file PostingIndex.cpp
+ * @brief Implementation of the PostingIndex class and row list intersection.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "PostingIndex.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Intersect two ascending row lists.
+ * @param a    First list.
+ * @param aEnd One past its end.
+ * @param b    Second list.
+ * @param bEnd One past its end.
+ * @param out  Receives the rows in both lists, ascending.
+ */
+void intersectRows(const uint32_t *a, const uint32_t *aEnd, const uint32_t *b, const uint32_t *bEnd, vector<uint32_t> &out)
+{
+    out.clear();
+    if (aEnd - a > bEnd - b)
+    {
+        swap(a, b);
+        swap(aEnd, bEnd);
+    }
+    size_t shortLength = aEnd - a;
+    size_t longLength = bEnd - b;
+
+    if (longLength < shortLength * 16)
+    {
+        // Similar lengths: a plain merge
+        while (a < aEnd && b < bEnd)
+        {
+            if (*a < *b)
+            {
+                a++;
+            }
+            else if (*b < *a)
+            {
+                b++;
+            }
+            else
+            {
+                out.push_back(*a);
+                a++;
+                b++;
+            }
+        }
+        return;
+    }
+
+    // Very different lengths: gallop through the long list (1, 2, 4, ... steps), then binary search
+    for (; a < aEnd && b < bEnd; a++)
+    {
+        size_t step = 1;
+        const uint32_t *low = b;
+        while (low + step < bEnd && low[step] < *a)
+        {
+            low += step;
+            step *= 2;
+        }
+        b = lower_bound(low, min(low + step + 1, bEnd), *a);
+        if (b < bEnd && *b == *a)
+        {
+            out.push_back(*a);
+            b++;
+        }
+    }
+}
+
+/**
+ * @brief Record that a row holds a key.
+ * @param key The key id.
+ * @param row The row; must be larger than every row added before.
+ */
+void PostingIndex::add(uint32_t key, uint32_t row)
+{
+    if (key >= lists.size())
+    {
+        lists.resize(key + 1);
+    }
+    lists[key].push_back(row);
+    rowCount++;
+}
+
+/**
+ * @brief Get the rows that hold a key.
+ * @param key The key id.
+ * @return First and one-past-last row, ascending; empty for an unknown key.
+ */
+pair<const uint32_t *, const uint32_t *> PostingIndex::rows(uint32_t key) const
+{
+    if (key >= lists.size())
+    {
+        return {nullptr, nullptr};
+    }
+    const vector<uint32_t> &list = lists[key];
+    return {list.data(), list.data() + list.size()};
+}
+
+/**
+ * @brief Get the number of key ids with a list.
+ * @return One more than the largest key added.
+ */
+size_t PostingIndex::keyCount() const
+{
+    return lists.size();
+}
+
+/**
+ * @brief Get the number of rows added.
+ * @return The total length of all lists.
+ */
+size_t PostingIndex::size() const
+{
+    return rowCount;
+}
+
+/**
+ * @brief Lay every list out back to back.
+ * @param offsets Receives keyCount() + 1 offsets.
+ * @param rows    Receives the lists, key by key.
+ */
+void PostingIndex::flatten(vector<uint32_t> &offsets, vector<uint32_t> &rows) const
+{
+    offsets.assign(1, 0);
+    rows.clear();
+    rows.reserve(rowCount);
+    for (const auto &list : lists)
+    {
+        rows.insert(rows.end(), list.begin(), list.end());
+        offsets.push_back(static_cast<uint32_t>(rows.size()));
+    }
+}
+
+/**
+ * @brief Remove every list.
+ */
+void PostingIndex::clear()
+{
+    lists.clear();
+    rowCount = 0;
+}
+
+/**
+ * @brief Estimate the memory the index uses.
+ * @return Bytes of heap memory for the lists.
+ */
+size_t PostingIndex::memoryBytes() const
+{
+    size_t bytes = lists.capacity() * sizeof(vector<uint32_t>);
+    for (const auto &list : lists)
+    {
+        bytes += list.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file PostingIndex.h
+ * @brief Defines the PostingIndex class, a key id to row list (posting list) index.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * States and counties are interned, so each has a small id. A posting index
+ * keeps, for every id, the rows that hold it in ascending order: "all rows in
+ * MN" is one array, read in place. Rows are only ever appended with a larger
+ * row number than before, so adding keeps every list sorted for free, and two
+ * lists can be intersected with a merge ("MN" AND "Hennepin").
+ */
+
+#ifndef POSTING_INDEX_H
+#define POSTING_INDEX_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Intersect two ascending row lists.
+ * @param a    First list.
+ * @param aEnd One past its end.
+ * @param b    Second list.
+ * @param bEnd One past its end.
+ * @param out  Receives the rows in both lists, ascending (cleared first).
+ * @note When one list is much shorter, each of its rows is found in the other
+ * with a galloping search, so the cost follows the short list.
+ */
+void intersectRows(const uint32_t *a, const uint32_t *aEnd, const uint32_t *b, const uint32_t *bEnd, vector<uint32_t> &out);
+
+class PostingIndex
+{
+private:
+    vector<vector<uint32_t>> lists; /**< Rows of each key id, ascending */
+    size_t rowCount = 0;            /**< Rows added so far */
+
+public:
+    PostingIndex() = default;
+
+    /**
+     * @brief Record that a row holds a key.
+     * @param key The key id.
+     * @param row The row; must be larger than every row added before.
+     */
+    void add(uint32_t key, uint32_t row);
+
+    /**
+     * @brief Get the rows that hold a key.
+     * @param key The key id.
+     * @return First and one-past-last row, ascending; empty for an unknown key.
+     * @note The pointers stay valid until the next add().
+     */
+    pair<const uint32_t *, const uint32_t *> rows(uint32_t key) const;
+
+    /**
+     * @brief Get the number of key ids with a list.
+     * @return One more than the largest key added.
+     */
+    size_t keyCount() const;
+
+    /**
+     * @brief Get the number of rows added.
+     * @return The total length of all lists.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Lay every list out back to back.
+     * @param offsets Receives keyCount() + 1 offsets; key k's rows are rows[offsets[k], offsets[k + 1]).
+     * @param rows    Receives the lists, key by key.
+     */
+    void flatten(vector<uint32_t> &offsets, vector<uint32_t> &rows) const;
+
+    /**
+     * @brief Remove every list.
+     */
+    void clear();
+
+    /**
+     * @brief Estimate the memory the index uses.
+     * @return Bytes of heap memory for the lists.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "PostingIndex.cpp"
+#endif
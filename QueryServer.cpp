@@ -0,0 +1,274 @@
+/**
+ * @file QueryServer.cpp
+ * @brief Implementation of the QueryServer class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "QueryServer.h"
+#include "PlaceIndex.h"
+#include <sstream>
+#include <exception>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * @brief Write a whole buffer, retrying short writes.
+ * @return false if the descriptor fails (e.g. the client went away).
+ */
+bool writeAll(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Create a server.
+ * @param data        The data to answer from.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ */
+QueryServer::QueryServer(const LiveDataset &data, unsigned threadCount)
+    : data(data), pool(threadCount), stopping(false)
+{
+}
+
+/**
+ * @brief Close the socket and remove its file.
+ */
+QueryServer::~QueryServer()
+{
+    if (listener >= 0)
+    {
+        close(listener);
+        unlink(socketPath.c_str());
+    }
+}
+
+/**
+ * @brief Create and bind the listening socket.
+ * @param path The socket's file name.
+ * @return false if the socket cannot be created.
+ */
+bool QueryServer::listen(const string &path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    listener = fd;
+    socketPath = path;
+    return true;
+}
+
+/**
+ * @brief Accept clients until stop() is called.
+ */
+void QueryServer::run()
+{
+    vector<thread> workers;
+    while (!stopping)
+    {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            break; // stop() shut the socket down
+        }
+
+        // Join the threads of connections that have closed since the last accept
+        {
+            lock_guard<mutex> guard(connectionLock);
+            connections.push_back(client);
+            for (thread::id done : finished)
+            {
+                auto worker = find_if(workers.begin(), workers.end(), [done](const thread &t)
+                                      { return t.get_id() == done; });
+                worker->join();
+                workers.erase(worker);
+            }
+            finished.clear();
+        }
+        workers.emplace_back([this, client]()
+                             {
+                                 try
+                                 {
+                                     serve(client, client);
+                                 }
+                                 catch (const exception &)
+                                 {
+                                     // serve() answers failed requests itself; anything else just ends the connection
+                                 }
+                                 lock_guard<mutex> guard(connectionLock);
+                                 connections.erase(find(connections.begin(), connections.end(), client));
+                                 close(client);
+                                 finished.push_back(this_thread::get_id());
+                             });
+    }
+
+    // Wake the connection threads out of read() so they can finish
+    {
+        lock_guard<mutex> guard(connectionLock);
+        for (int client : connections)
+        {
+            shutdown(client, SHUT_RDWR);
+        }
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Make run() return.
+ */
+void QueryServer::stop()
+{
+    stopping = true;
+    if (listener >= 0)
+    {
+        shutdown(listener, SHUT_RDWR);
+    }
+}
+
+/**
+ * @brief Answer requests from one input until it ends or sends QUIT.
+ * @param in  File descriptor to read requests from.
+ * @param out File descriptor to write responses to.
+ * @return The number of requests answered.
+ */
+size_t QueryServer::serve(int in, int out)
+{
+    string pending;
+    vector<string_view> batch;
+    vector<string> answers;
+    size_t answered = 0;
+    char block[1 << 16];
+    bool open = true;
+
+    while (open)
+    {
+        ssize_t got = read(in, block, sizeof(block));
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            break;
+        }
+        pending.append(block, static_cast<size_t>(got));
+
+        // Every complete line read so far is one request of the batch
+        batch.clear();
+        size_t start = 0;
+        for (size_t end = pending.find('\n'); end != string::npos; end = pending.find('\n', start))
+        {
+            string_view line(pending.data() + start, end - start);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+            start = end + 1;
+            if (compareFolded(line, "QUIT") == 0)
+            {
+                open = false;
+                break;
+            }
+            batch.push_back(line);
+        }
+        bool tooLong = open && pending.size() - start > MAX_LINE;
+
+        // Answer the chunks on the pool, then send everything back in order
+        size_t chunks = (batch.size() + CHUNK_REQUESTS - 1) / CHUNK_REQUESTS;
+        answers.resize(chunks);
+        pool.run(chunks, [&](size_t chunk)
+                 {
+                     size_t first = chunk * CHUNK_REQUESTS;
+                     size_t last = min(batch.size(), (chunk + 1) * CHUNK_REQUESTS);
+                     try
+                     {
+                         ostringstream text;
+                         LiveDataset::Reader reader = data.read();
+                         {
+                             TableFormatter formatter(text, OutputFormat::TSV);
+                             for (size_t i = first; i < last; i++)
+                             {
+                                 reader->service.answer(batch[i], formatter);
+                             }
+                         }
+                         answers[chunk] = text.str();
+                     }
+                     catch (const exception &error)
+                     {
+                         // Still one response per request, so the client stays in step
+                         string line = string("ERR internal error: ") + error.what() + "\n";
+                         answers[chunk].clear();
+                         for (size_t i = first; i < last; i++)
+                         {
+                             answers[chunk] += line;
+                         }
+                     }
+                 });
+        string reply;
+        for (const string &answer : answers)
+        {
+            reply += answer;
+        }
+        if (tooLong)
+        {
+            reply += "ERR request too long\n";
+            open = false;
+        }
+        if (!writeAll(out, reply.data(), reply.size()))
+        {
+            break;
+        }
+        answered += batch.size();
+        pending.erase(0, start);
+    }
+    return answered;
+}
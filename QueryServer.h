@@ -0,0 +1,99 @@
+/**
+ * @file QueryServer.h
+ * @brief Defines the QueryServer class, a Unix domain socket server for QueryService.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The server keeps the list and its indexes in memory, so a query costs
+ * microseconds instead of a process start and a file load. The data lives in
+ * a LiveDataset, so it can be reloaded while the server runs; each chunk of
+ * requests is answered from one dataset. Each connection
+ * has a thread that reads whatever the client has sent. Clients may pipeline:
+ * every complete line in the buffer joins one batch. The batch is cut into
+ * chunks that a shared WorkerPool answers in parallel. The responses go back
+ * in request order with a single write. serve() runs the same loop on any
+ * pair of file descriptors, e.g. stdin and stdout for testing.
+ */
+
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include "LiveDataset.h"
+#include "WorkerPool.h"
+
+using namespace std;
+
+class QueryServer
+{
+private:
+    const LiveDataset &data;     /**< Answers the requests */
+    WorkerPool pool;             /**< Shared by every connection */
+    int listener = -1;           /**< Listening socket (-1 when not listening) */
+    string socketPath;           /**< File name of the socket, removed on close */
+    atomic<bool> stopping;       /**< Set by stop() */
+    mutex connectionLock;        /**< Guards connections and finished */
+    vector<int> connections;     /**< Sockets of the clients being served */
+    vector<thread::id> finished; /**< Connection threads that are done but not yet joined */
+
+public:
+    static const size_t CHUNK_REQUESTS = 64; /**< Requests per pool task */
+    static const size_t MAX_LINE = 1 << 16;  /**< Longer requests close the connection */
+
+    /**
+     * @brief Create a server.
+     * @param data        The data to answer from; must outlive the server.
+     * @param threadCount Worker threads (0 = one per hardware thread).
+     */
+    QueryServer(const LiveDataset &data, unsigned threadCount = 0);
+
+    /**
+     * @brief Close the socket and remove its file.
+     */
+    ~QueryServer();
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    /**
+     * @brief Create and bind the listening socket.
+     * @param path The socket's file name (an old socket file there is replaced).
+     * @return false if the socket cannot be created.
+     */
+    bool listen(const string &path);
+
+    /**
+     * @brief Accept clients until stop() is called, one thread per connection.
+     * @note Threads of closed connections are joined as new clients arrive,
+     * so a long-running server holds only about one thread per open
+     * connection. Returns after every connection has been closed.
+     */
+    void run();
+
+    /**
+     * @brief Make run() return.
+     * @note Only sets a flag and shuts the listening socket down, so it may be
+     * called from a signal handler. Open connections are closed by run().
+     */
+    void stop();
+
+    /**
+     * @brief Answer requests from one input until it ends or sends QUIT.
+     * @param in  File descriptor to read requests from.
+     * @param out File descriptor to write responses to.
+     * @return The number of requests answered.
+     * @note A request that fails with an exception (e.g. too many reader
+     * threads) is answered with "ERR internal error: ..." instead.
+     */
+    size_t serve(int in, int out);
+};
+
+#include "QueryServer.cpp"
+#endif
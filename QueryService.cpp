@@ -0,0 +1,185 @@
+/**
+ * @file QueryService.cpp
+ * @brief Implementation of the QueryService class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "QueryService.h"
+#include "FieldScanner.h"
+#include "PlaceIndex.h"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Split a request into words separated by spaces or tabs.
+ * @param line  The request.
+ * @param words Receives up to @p most words; the last one keeps the rest of the line.
+ * @param most  The most words to split off.
+ * @return The number of words.
+ */
+size_t splitRequest(string_view line, string_view *words, size_t most)
+{
+    size_t count = 0;
+    size_t at = 0;
+    while (count < most)
+    {
+        at = line.find_first_not_of(" \t", at);
+        if (at == string_view::npos)
+        {
+            break;
+        }
+        size_t end = (count + 1 == most) ? line.find_last_not_of(" \t") + 1 : line.find_first_of(" \t", at);
+        if (end == string_view::npos)
+        {
+            end = line.size();
+        }
+        words[count++] = line.substr(at, end - at);
+        at = end;
+    }
+    return count;
+}
+
+/**
+ * @brief Read an optional non-negative count argument.
+ * @return false if the text is not a number >= 0.
+ */
+bool parseLimit(string_view text, size_t &limit)
+{
+    int value = 0;
+    if (!parseInteger(text, value) || value < 0)
+    {
+        return false;
+    }
+    limit = static_cast<size_t>(value);
+    return true;
+}
+
+/**
+ * @brief Build the indexes the queries need.
+ * @param list The loaded list.
+ */
+QueryService::QueryService(const PostalList &list) : list(list), spatial(list)
+{
+    list.sortedByZip();
+}
+
+/**
+ * @brief Write "OK <n>" and the first @p limit items of a view.
+ */
+void QueryService::writeItems(TableFormatter &formatter, ItemRange items, size_t limit) const
+{
+    size_t count = min(items.size(), limit);
+    formatter.writeText("OK " + to_string(count) + "\n");
+    for (size_t i = 0; i < count; i++)
+    {
+        items[i].printInfo(formatter);
+    }
+}
+
+/**
+ * @brief Answer one request line.
+ * @param request   The line, without its line break.
+ * @param formatter Receives the response.
+ */
+void QueryService::answer(string_view request, TableFormatter &formatter) const
+{
+    string_view words[4];
+    size_t count = splitRequest(request, words, 4);
+    if (count == 0)
+    {
+        formatter.writeText("ERR empty request\n");
+        return;
+    }
+    string_view command = words[0];
+    auto is = [&](string_view name)
+    { return compareFolded(command, name) == 0; };
+    size_t limit = SIZE_MAX;
+
+    if (is("PING") && count == 1)
+    {
+        formatter.writeText("OK 0\n");
+    }
+    else if (is("ZIP"))
+    {
+        int zip = 0;
+        if (count != 2 || !parseInteger(words[1], zip))
+        {
+            formatter.writeText("ERR usage: ZIP <zip>\n");
+            return;
+        }
+        const PostalCodeItem *item = list.findByZip(zip);
+        formatter.writeText(item ? "OK 1\n" : "OK 0\n");
+        if (item)
+        {
+            item->printInfo(formatter);
+        }
+    }
+    else if (is("RANGE"))
+    {
+        int low = 0;
+        int high = 0;
+        if (count < 3 || !parseInteger(words[1], low) || !parseInteger(words[2], high) ||
+            (count == 4 && !parseLimit(words[3], limit)))
+        {
+            formatter.writeText("ERR usage: RANGE <low> <high> [limit]\n");
+            return;
+        }
+        writeItems(formatter, list.findZipRange(low, high), limit);
+    }
+    else if (is("STATE"))
+    {
+        if (count < 2 || count > 3 || (count == 3 && !parseLimit(words[2], limit)))
+        {
+            formatter.writeText("ERR usage: STATE <state> [limit]\n");
+            return;
+        }
+        writeItems(formatter, list.findByState(words[1]), limit);
+    }
+    else if (is("COUNTY"))
+    {
+        if (count < 3)
+        {
+            formatter.writeText("ERR usage: COUNTY <state> <county name>\n");
+            return;
+        }
+        // The county name is everything after the state, spaces included
+        string_view county = request.substr(words[2].data() - request.data());
+        county = county.substr(0, county.find_last_not_of(" \t") + 1);
+        vector<uint32_t> rows;
+        writeItems(formatter, list.findByStateAndCounty(words[1], county, rows), limit);
+    }
+    else if (is("NEAREST"))
+    {
+        double lat = 0;
+        double lon = 0;
+        size_t k = 1;
+        if (count < 3 || !parseDecimal(words[1], lat) || !parseDecimal(words[2], lon) ||
+            (count == 4 && !parseLimit(words[3], k)) || k > MAX_NEAREST)
+        {
+            formatter.writeText("ERR usage: NEAREST <lat> <lon> [k <= 1000]\n");
+            return;
+        }
+        vector<SpatialMatch> found = spatial.nearest(lat, lon, k);
+        formatter.writeText("OK " + to_string(found.size()) + "\n");
+        const PostalColumns &columns = list.getColumns();
+        for (const SpatialMatch &match : found)
+        {
+            size_t row = static_cast<size_t>(match.index);
+            formatter.writeRow(columns.zipData()[row], columns.place(row), columns.state(row), columns.county(row),
+                               columns.latitudeData()[row], columns.longitudeData()[row]);
+        }
+    }
+    else
+    {
+        formatter.writeText("ERR unknown command\n");
+    }
+}
@@ -0,0 +1,64 @@
+/**
+ * @file QueryService.h
+ * @brief Defines the QueryService class, which answers one-line text queries against a loaded list.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The query server's protocol is one request per line, one response per
+ * request, in the same order:
+ *
+ *   ZIP <zip>                          the item with that ZIP code
+ *   RANGE <low> <high> [limit]         items with low <= ZIP <= high, by ZIP
+ *   STATE <state> [limit]              items in a state, in list order
+ *   COUNTY <state> <county name>       items in one county of a state
+ *   NEAREST <lat> <lon> [k]            the k (default 1) closest items, nearest first
+ *   PING                               an empty answer
+ *
+ * Commands are not case-sensitive. A response is "OK <n>" followed by n
+ * tab-separated records (zip, place, state, county, latitude, longitude),
+ * or a single "ERR <reason>" line. Every line ends with '\n'.
+ */
+
+#ifndef QUERY_SERVICE_H
+#define QUERY_SERVICE_H
+
+#include <string>
+#include <string_view>
+#include "PostalList.h"
+#include "SpatialIndex.h"
+#include "TableFormatter.h"
+
+using namespace std;
+
+class QueryService
+{
+private:
+    const PostalList &list; /**< The data; must not change while the service is used */
+    SpatialIndex spatial;   /**< For NEAREST */
+
+    void writeItems(TableFormatter &formatter, ItemRange items, size_t limit) const;
+
+public:
+    static const size_t MAX_NEAREST = 1000; /**< Largest k NEAREST accepts */
+
+    /**
+     * @brief Build the indexes the queries need.
+     * @param list The loaded list. It is kept by reference and must not change afterwards.
+     * @note Builds the list's lazy ZIP order here, so answer() only reads and
+     * may run on many threads at once.
+     */
+    explicit QueryService(const PostalList &list);
+
+    /**
+     * @brief Answer one request line.
+     * @param request   The line, without its line break.
+     * @param formatter Receives the response; it should write TSV.
+     */
+    void answer(string_view request, TableFormatter &formatter) const;
+};
+
+#include "QueryService.cpp"
+#endif
@@ -0,0 +1,66 @@
+/**
+ * @file RadixSort.cpp
+ * @brief Implementation of the stable LSD radix sort.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "RadixSort.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Sort rows by their keys, keeping the current order of equal keys.
+ * @param rows The row numbers to sort.
+ * @param keys The key of each entry of @p rows (same length); sorted along with it.
+ */
+void radixSortRows(vector<uint32_t> &rows, vector<uint32_t> &keys)
+{
+    const int DIGIT_BITS = 11;
+    const uint32_t DIGIT_MASK = (1u << DIGIT_BITS) - 1;
+
+    uint32_t largest = 0;
+    for (uint32_t key : keys)
+    {
+        largest = max(largest, key);
+    }
+
+    vector<uint32_t> rowBuffer(rows.size());
+    vector<uint32_t> keyBuffer(keys.size());
+    vector<size_t> counts(DIGIT_MASK + 1);
+
+    // Only as many passes as the largest key has digits
+    for (int shift = 0; shift < 32 && (largest >> shift) != 0; shift += DIGIT_BITS)
+    {
+        fill(counts.begin(), counts.end(), 0);
+        for (uint32_t key : keys)
+        {
+            counts[(key >> shift) & DIGIT_MASK]++;
+        }
+
+        // Turn the counts into the first output slot of each digit
+        size_t next = 0;
+        for (size_t &count : counts)
+        {
+            size_t here = count;
+            count = next;
+            next += here;
+        }
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            size_t slot = counts[(keys[i] >> shift) & DIGIT_MASK]++;
+            rowBuffer[slot] = rows[i];
+            keyBuffer[slot] = keys[i];
+        }
+        rows.swap(rowBuffer);
+        keys.swap(keyBuffer);
+    }
+}
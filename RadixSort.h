@@ -0,0 +1,35 @@
+/**
+ * @file RadixSort.h
+ * @brief Declares a stable LSD radix sort for row permutations.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Sorted views of a PostalList are arrays of row numbers, each with a small
+ * unsigned key (a ZIP code minus the smallest one, or a state's alphabetical
+ * rank). Sorting those pairs a few bits at a time (least significant digit
+ * first) takes a fixed number of linear passes instead of N log N
+ * comparisons, and never touches the items.
+ */
+
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * @brief Sort rows by their keys, keeping the current order of equal keys.
+ * @param rows The row numbers to sort.
+ * @param keys The key of each entry of @p rows (same length); sorted along with it.
+ * @note Uses 11-bit digits, so keys below 2048 take one pass and 5-digit ZIP
+ * codes take two. Sorting by B and then by A gives the order (A, B).
+ */
+void radixSortRows(vector<uint32_t> &rows, vector<uint32_t> &keys);
+
+#include "RadixSort.cpp"
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file RecordBatch.cpp
+ * @brief Implementation of the RecordBatch class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "RecordBatch.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * @brief Ask the kernel to read one run of the mapped file now, as one large read.
+ * @param data  The mapped file.
+ * @param begin First byte of the run.
+ * @param end   One past its last byte.
+ */
+void readAhead(const MappedFile &data, uint64_t begin, uint64_t end)
+{
+#ifndef _WIN32
+    // The mapping starts on a page boundary, so rounding the offsets keeps the address aligned
+    uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t first = begin / page * page;
+    madvise(const_cast<char *>(data.data() + first), min<uint64_t>(end, data.size()) - first, MADV_WILLNEED);
+#else
+    (void)data;
+    (void)begin;
+    (void)end;
+#endif
+}
+
+/**
+ * @brief Create an empty batch.
+ */
+RecordBatch::RecordBatch()
+{
+    runs = 0;
+}
+
+/**
+ * @brief Read a list of records in file order.
+ * @param data     The mapped data file.
+ * @param requests Where each record is; length 0 reads to the end of the line, offset MISSING has no record.
+ */
+void RecordBatch::fetch(const MappedFile &data, const vector<ZipIndexEntry> &requests)
+{
+    bytes.clear();
+    starts.assign(requests.size(), MISSING);
+    lengths.assign(requests.size(), 0);
+    runs = 0;
+
+    // Visit the requests in file order
+    vector<uint32_t> order;
+    order.reserve(requests.size());
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < requests.size(); i++)
+    {
+        if (requests[i].offset < data.size())
+        {
+            order.push_back(i);
+            total += requests[i].length;
+        }
+    }
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+         {
+             return requests[a].offset < requests[b].offset;
+         });
+    bytes.reserve(total);
+
+    size_t next = 0;
+    while (next < order.size())
+    {
+        // Grow the run while the next record starts within RUN_GAP of the end of the last one
+        size_t stop = next;
+        uint64_t runBegin = requests[order[next]].offset;
+        uint64_t runEnd = runBegin;
+        while (stop < order.size() && requests[order[stop]].offset <= runEnd + RUN_GAP)
+        {
+            const ZipIndexEntry &request = requests[order[stop]];
+            runEnd = max(runEnd, request.offset + max<uint64_t>(request.length, 1));
+            stop++;
+        }
+        readAhead(data, runBegin, runEnd);
+        runs++;
+
+        uint64_t lastOffset = MISSING;
+        for (; next < stop; next++)
+        {
+            uint32_t i = order[next];
+            const ZipIndexEntry &request = requests[i];
+            if (request.offset == lastOffset)
+            {
+                // Same record as the previous request: share its copy
+                starts[i] = starts[order[next - 1]];
+                lengths[i] = lengths[order[next - 1]];
+                continue;
+            }
+            lastOffset = request.offset;
+
+            const char *record = data.data() + request.offset;
+            size_t available = data.size() - request.offset;
+            size_t length = request.length;
+            if (length == 0)
+            {
+                const char *lineEnd = static_cast<const char *>(memchr(record, '\n', available));
+                length = (lineEnd != nullptr) ? lineEnd - record : available;
+                if (length > 0 && record[length - 1] == '\r')
+                {
+                    length--;
+                }
+            }
+            length = min(length, available);
+            starts[i] = bytes.size();
+            lengths[i] = static_cast<uint32_t>(length);
+            bytes.append(record, length);
+        }
+    }
+}
+
+/**
+ * @brief Get the number of requests in the last fetch().
+ * @return The request count.
+ */
+size_t RecordBatch::size() const
+{
+    return starts.size();
+}
+
+/**
+ * @brief Check whether a request has a record.
+ * @param request The request number.
+ * @return false for a MISSING request.
+ */
+bool RecordBatch::found(size_t request) const
+{
+    return starts[request] != MISSING;
+}
+
+/**
+ * @brief Get the record of a request.
+ * @param request The request number.
+ * @return A view into the batch's buffer (empty for a missing request).
+ */
+string_view RecordBatch::record(size_t request) const
+{
+    if (!found(request))
+    {
+        return string_view();
+    }
+    return string_view(bytes.data() + starts[request], lengths[request]);
+}
+
+/**
+ * @brief Get the number of runs the last fetch() read.
+ * @return The number of separate regions of the file that were read.
+ */
+size_t RecordBatch::runCount() const
+{
+    return runs;
+}
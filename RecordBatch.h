@@ -0,0 +1,93 @@
+/**
+ * @file RecordBatch.h
+ * @brief Defines the RecordBatch class, which fetches many data-file records in one pass.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Looking up a long list of ZIP codes one at a time jumps back and forth
+ * through the data file. A batch first takes every record location from the
+ * index, sorts them by file offset, and then reads the file once from front
+ * to back: records that sit close together are grouped into one run, each
+ * run is requested from the kernel in a single call, and the records are
+ * copied into one buffer. The results still come back in request order.
+ */
+
+#ifndef RECORD_BATCH_H
+#define RECORD_BATCH_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+#include "ZipIndexFile.h"
+
+using namespace std;
+
+class RecordBatch
+{
+private:
+    string bytes;             /**< The fetched records back to back, in file order */
+    vector<uint64_t> starts;  /**< Where each request's record starts in bytes (MISSING if none) */
+    vector<uint32_t> lengths; /**< Length of each request's record */
+    size_t runs;              /**< Runs read by the last fetch() */
+
+public:
+    /**
+     * @brief Offset of a request that has no record.
+     */
+    static const uint64_t MISSING = ~0ull;
+
+    /**
+     * @brief Records less than this many bytes apart are read as one run.
+     */
+    static const uint64_t RUN_GAP = 64 * 1024;
+
+    /**
+     * @brief Create an empty batch.
+     */
+    RecordBatch();
+
+    /**
+     * @brief Read a list of records in file order.
+     * @param data     The mapped data file.
+     * @param requests Where each record is: its offset, and its length in
+     * bytes or 0 to read up to the end of the line. An offset of MISSING (or
+     * past the end of the file) marks a request with no record.
+     * @note Replaces the previous contents. Records requested twice are read once.
+     */
+    void fetch(const MappedFile &data, const vector<ZipIndexEntry> &requests);
+
+    /**
+     * @brief Get the number of requests in the last fetch().
+     * @return The request count.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Check whether a request has a record.
+     * @param request The request number.
+     * @return false for a MISSING request.
+     */
+    bool found(size_t request) const;
+
+    /**
+     * @brief Get the record of a request.
+     * @param request The request number.
+     * @return A view into the batch's buffer (empty for a missing request),
+     * valid until the next fetch().
+     */
+    string_view record(size_t request) const;
+
+    /**
+     * @brief Get the number of runs the last fetch() read.
+     * @return The number of separate regions of the file that were read.
+     */
+    size_t runCount() const;
+};
+
+#include "RecordBatch.cpp"
+#endif
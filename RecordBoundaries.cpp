@@ -0,0 +1,189 @@
+/**
+ * @file RecordBoundaries.cpp
+ * @brief Implementation of the record boundary helpers.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "RecordBoundaries.h"
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Move an offset to the start of the next line.
+ * @param data The file contents.
+ * @param size The file size in bytes.
+ * @param pos  Any offset inside the file.
+ * @return The offset just past the next newline, or @p size if there is none.
+ */
+size_t nextLineStart(const char *data, size_t size, size_t pos)
+{
+    if (pos >= size)
+    {
+        return size;
+    }
+    const char *newline = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+    return (newline == nullptr) ? size : (newline - data) + 1;
+}
+
+/**
+ * @brief Split [begin, size) into chunks that all start on a record boundary.
+ * @param data       The file contents.
+ * @param size       The file size in bytes.
+ * @param begin      Offset of the first record (just past any header).
+ * @param chunkCount How many chunks to make.
+ * @return chunkCount + 1 ascending offsets; chunk i is [result[i], result[i + 1]).
+ */
+vector<size_t> splitAtRecordBoundaries(const char *data, size_t size, size_t begin, size_t chunkCount)
+{
+    if (chunkCount == 0)
+    {
+        chunkCount = 1;
+    }
+
+    vector<size_t> bounds(chunkCount + 1);
+    bounds[0] = begin;
+    size_t span = (size > begin) ? size - begin : 0;
+
+    for (size_t i = 1; i < chunkCount; i++)
+    {
+        // Aim for an even split, then slide forward to the next line start
+        size_t target = begin + span / chunkCount * i;
+        size_t start = (target <= begin) ? begin : nextLineStart(data, size, target - 1);
+        bounds[i] = max(start, bounds[i - 1]);
+    }
+    bounds[chunkCount] = max(size, bounds[chunkCount - 1]);
+    return bounds;
+}
+
+/**
+ * @brief Locate one record of a length-indicated file.
+ * @param data        The file contents.
+ * @param size        The file size in bytes.
+ * @param pos         Offset of the first byte of the line (the length prefix).
+ * @param recordStart Receives the offset of the record just after the prefix.
+ * @param recordEnd   Receives the offset one past the last byte of the record.
+ * @return true if a length prefix matched, false if the line is malformed.
+ */
+bool findLengthIndicatedRecord(const char *data, size_t size, size_t pos, size_t &recordStart, size_t &recordEnd)
+{
+    size_t length = 0;
+    size_t width = 0;
+
+    // Fast path: the prefix is a byte count, so it points straight at the line end.
+    // A prefix that is too long can reach a later line, which is why a match
+    // must not have a newline inside it.
+    for (width = 1; width <= 9 && pos + width <= size; width++)
+    {
+        char digit = data[pos + width - 1];
+        if (digit < '0' || digit > '9')
+        {
+            break;
+        }
+        length = length * 10 + (digit - '0');
+
+        size_t end = pos + width + length;
+        if (end > size)
+        {
+            break;
+        }
+        bool atLineEnd = end == size || data[end] == '\n' ||
+                         (data[end] == '\r' && end + 1 < size && data[end + 1] == '\n');
+        if (atLineEnd && memchr(data + pos, '\n', end - pos) == nullptr)
+        {
+            recordStart = pos + width;
+            recordEnd = end;
+            return true;
+        }
+    }
+
+    // Slow path: find the line end by scanning and work the prefix out from it
+    size_t lineEnd = nextLineStart(data, size, pos);
+    if (lineEnd > pos && data[lineEnd - 1] == '\n')
+    {
+        lineEnd--;
+    }
+    if (lineEnd > pos && data[lineEnd - 1] == '\r')
+    {
+        lineEnd--;
+    }
+
+    width = lengthPrefixWidth(data + pos, lineEnd - pos);
+    if (width == 0)
+    {
+        return false;
+    }
+    recordStart = pos + width;
+    recordEnd = lineEnd;
+    return true;
+}
+
+/**
+ * @brief Work out how many leading digits of a length-indicated line are the length.
+ * @param line       First byte of the line.
+ * @param lineLength Bytes in the line, without the line end.
+ * @return The prefix width, or 0 if no prefix matches the line.
+ */
+size_t lengthPrefixWidth(const char *line, size_t lineLength)
+{
+    // script.py counts characters, not bytes, so a record with accented names
+    // (UTF-8) is longer in bytes than its prefix says
+    size_t characters = 0;
+    bool ascii = true;
+    size_t length = 0;
+
+    for (size_t width = 1; width <= 9 && width <= lineLength; width++)
+    {
+        char digit = line[width - 1];
+        if (digit < '0' || digit > '9')
+        {
+            break;
+        }
+        length = length * 10 + (digit - '0');
+        if (length + width == lineLength)
+        {
+            return width;
+        }
+    }
+
+    for (size_t i = 0; i < lineLength; i++)
+    {
+        // Count every byte except UTF-8 continuation bytes (10xxxxxx)
+        if ((static_cast<unsigned char>(line[i]) & 0xC0) != 0x80)
+        {
+            characters++;
+        }
+        else
+        {
+            ascii = false;
+        }
+    }
+    if (ascii)
+    {
+        return 0;
+    }
+
+    length = 0;
+    for (size_t width = 1; width <= 9 && width <= lineLength; width++)
+    {
+        char digit = line[width - 1];
+        if (digit < '0' || digit > '9')
+        {
+            return 0;
+        }
+        length = length * 10 + (digit - '0');
+        if (length + width == characters)
+        {
+            return width;
+        }
+    }
+    return 0;
+}
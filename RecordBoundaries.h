@@ -0,0 +1,79 @@
+/**
+ * @file RecordBoundaries.h
+ * @brief Declares helpers for finding record boundaries in a mapped data file.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Both data formats hold one record per line and no record contains a
+ * newline, so any byte offset can be moved forward to the next record start.
+ * The length-indicated files written by script.py put the record length in
+ * front of every line, e.g. "42501,Holtsville,..." is a 42 byte record for
+ * ZIP 501, which lets a reader jump straight to the end of a record.
+ */
+
+#ifndef RECORD_BOUNDARIES_H
+#define RECORD_BOUNDARIES_H
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief Move an offset to the start of the next line.
+ * @param data The file contents.
+ * @param size The file size in bytes.
+ * @param pos  Any offset inside the file.
+ * @return The offset just past the next newline, or @p size if there is none.
+ */
+size_t nextLineStart(const char *data, size_t size, size_t pos);
+
+/**
+ * @brief Split [begin, size) into chunks that all start on a record boundary.
+ * @param data       The file contents.
+ * @param size       The file size in bytes.
+ * @param begin      Offset of the first record (just past any header).
+ * @param chunkCount How many chunks to make.
+ * @return chunkCount + 1 ascending offsets; chunk i is [result[i], result[i + 1]).
+ * @note Chunks may be empty when the file has fewer lines than chunks.
+ */
+vector<size_t> splitAtRecordBoundaries(const char *data, size_t size, size_t begin, size_t chunkCount);
+
+/**
+ * @brief Locate one record of a length-indicated file.
+ *
+ * The prefix and the ZIP code run together ("42501"), so each possible prefix
+ * width is tried from the shortest up. A too-short prefix gives a length that
+ * ends inside the record, where there is no newline, so the first width whose
+ * length lands on a line end is the right one. script.py counts characters,
+ * so lines with multi-byte UTF-8 names miss that fast path; for those the
+ * newline is found by scanning and the prefix is matched to the character count.
+ *
+ * @param data        The file contents.
+ * @param size        The file size in bytes.
+ * @param pos         Offset of the first byte of the line (the length prefix).
+ * @param recordStart Receives the offset of the record just after the prefix.
+ * @param recordEnd   Receives the offset one past the last byte of the record.
+ * @return true if a length prefix matched, false if the line is malformed.
+ * @note Lines that end in "\r\n" are accepted; recordEnd then points at the '\r'.
+ */
+bool findLengthIndicatedRecord(const char *data, size_t size, size_t pos, size_t &recordStart, size_t &recordEnd);
+
+/**
+ * @brief Work out how many leading digits of a length-indicated line are the length.
+ *
+ * Used when the line end is already known (for example from the tokenizer).
+ * The prefix is matched against the byte count first and, for lines with
+ * UTF-8 names, against the character count that script.py wrote.
+ *
+ * @param line       First byte of the line.
+ * @param lineLength Bytes in the line, without the line end.
+ * @return The prefix width, or 0 if no prefix matches the line.
+ */
+size_t lengthPrefixWidth(const char *line, size_t lineLength);
+
+#include "RecordBoundaries.cpp"
+#endif
@@ -0,0 +1,296 @@
+/**
+ * @file SpatialIndex.cpp
+ * @brief Implementation of the SpatialIndex k-d tree.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const double SPATIAL_PI = 3.14159265358979323846; /**< M_PI is not standard C++ */
+
+/**
+ * @brief Convert a latitude/longitude to a point on the unit sphere.
+ * @param lat   Latitude in degrees.
+ * @param lon   Longitude in degrees.
+ * @param point Receives x, y, z.
+ */
+void toUnitSphere(double lat, double lon, double point[3])
+{
+    const double toRadians = SPATIAL_PI / 180.0;
+    double phi = lat * toRadians;
+    double lambda = lon * toRadians;
+    point[0] = cos(phi) * cos(lambda);
+    point[1] = cos(phi) * sin(lambda);
+    point[2] = sin(phi);
+}
+
+/**
+ * @brief Squared straight-line distance between two points.
+ */
+double squaredChord(const double a[3], const double b[3])
+{
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief Turn a squared chord length on the unit sphere into miles along the surface.
+ */
+double chordToMiles(double squared)
+{
+    double half = sqrt(squared) / 2;
+    return 2 * EARTH_RADIUS_MILES * asin(min(1.0, half));
+}
+
+/**
+ * @brief Great-circle distance between two points with the haversine formula.
+ * @param lat1 Latitude of the first point in degrees.
+ * @param lon1 Longitude of the first point in degrees.
+ * @param lat2 Latitude of the second point in degrees.
+ * @param lon2 Longitude of the second point in degrees.
+ * @return The distance in miles.
+ */
+double greatCircleMiles(double lat1, double lon1, double lat2, double lon2)
+{
+    const double toRadians = SPATIAL_PI / 180.0;
+    double dLat = (lat2 - lat1) * toRadians;
+    double dLon = (lon2 - lon1) * toRadians;
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * toRadians) * cos(lat2 * toRadians) * sin(dLon / 2) * sin(dLon / 2);
+    return 2 * EARTH_RADIUS_MILES * asin(min(1.0, sqrt(a)));
+}
+
+/**
+ * @brief Build the index over every item of a list.
+ * @param list The list to index.
+ */
+SpatialIndex::SpatialIndex(const PostalList &list)
+{
+    build(list);
+}
+
+/**
+ * @brief Rebuild the index over every item of a list.
+ * @param list The list to index.
+ */
+void SpatialIndex::build(const PostalList &list)
+{
+    const PostalColumns &columns = list.getColumns();
+    const double *latitudes = columns.latitudeData();
+    const double *longitudes = columns.longitudeData();
+
+    nodes.resize(columns.size());
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        toUnitSphere(latitudes[i], longitudes[i], nodes[i].point);
+        nodes[i].index = static_cast<uint32_t>(i);
+        nodes[i].axis = 0;
+    }
+    build(0, nodes.size());
+}
+
+/**
+ * @brief Arrange nodes[lo, hi) into a subtree: the median on the widest axis goes in the middle.
+ */
+void SpatialIndex::build(size_t lo, size_t hi)
+{
+    if (hi - lo <= 1)
+    {
+        return;
+    }
+
+    // Split on the axis where the points are spread out the most
+    double low[3] = {2, 2, 2};
+    double high[3] = {-2, -2, -2};
+    for (size_t i = lo; i < hi; i++)
+    {
+        for (int a = 0; a < 3; a++)
+        {
+            low[a] = min(low[a], nodes[i].point[a]);
+            high[a] = max(high[a], nodes[i].point[a]);
+        }
+    }
+    uint8_t axis = 0;
+    for (uint8_t a = 1; a < 3; a++)
+    {
+        if (high[a] - low[a] > high[axis] - low[axis])
+        {
+            axis = a;
+        }
+    }
+
+    size_t mid = (lo + hi) / 2;
+    nth_element(nodes.begin() + lo, nodes.begin() + mid, nodes.begin() + hi,
+                [axis](const Node &a, const Node &b)
+                {
+                    return a.point[axis] < b.point[axis];
+                });
+    nodes[mid].axis = axis;
+
+    build(lo, mid);
+    build(mid + 1, hi);
+}
+
+/**
+ * @brief Collect the k nearest nodes of a subtree into a max-heap of (squared chord, index).
+ */
+void SpatialIndex::searchNearest(size_t lo, size_t hi, const double query[3], size_t k,
+                                 vector<pair<double, uint32_t>> &best) const
+{
+    if (lo >= hi)
+    {
+        return;
+    }
+
+    size_t mid = (lo + hi) / 2;
+    const Node &node = nodes[mid];
+    pair<double, uint32_t> candidate(squaredChord(node.point, query), node.index);
+
+    if (best.size() < k)
+    {
+        best.push_back(candidate);
+        push_heap(best.begin(), best.end());
+    }
+    else if (candidate < best.front())
+    {
+        pop_heap(best.begin(), best.end());
+        best.back() = candidate;
+        push_heap(best.begin(), best.end());
+    }
+
+    // Search the side the query is on first; the other side can only help if
+    // the splitting plane is closer than the worst match so far
+    double offset = query[node.axis] - node.point[node.axis];
+    size_t nearLo = (offset < 0) ? lo : mid + 1;
+    size_t nearHi = (offset < 0) ? mid : hi;
+    size_t farLo = (offset < 0) ? mid + 1 : lo;
+    size_t farHi = (offset < 0) ? hi : mid;
+
+    searchNearest(nearLo, nearHi, query, k, best);
+    if (best.size() < k || offset * offset <= best.front().first)
+    {
+        searchNearest(farLo, farHi, query, k, best);
+    }
+}
+
+/**
+ * @brief Collect every node of a subtree whose squared chord is at most @p limit.
+ */
+void SpatialIndex::searchRadius(size_t lo, size_t hi, const double query[3], double limit,
+                                vector<pair<double, uint32_t>> &found) const
+{
+    if (lo >= hi)
+    {
+        return;
+    }
+
+    size_t mid = (lo + hi) / 2;
+    const Node &node = nodes[mid];
+    double distance = squaredChord(node.point, query);
+    if (distance <= limit)
+    {
+        found.emplace_back(distance, node.index);
+    }
+
+    double offset = query[node.axis] - node.point[node.axis];
+    if (offset <= 0 || offset * offset <= limit)
+    {
+        searchRadius(lo, mid, query, limit, found);
+    }
+    if (offset >= 0 || offset * offset <= limit)
+    {
+        searchRadius(mid + 1, hi, query, limit, found);
+    }
+}
+
+/**
+ * @brief Find the k items closest to a point.
+ * @param lat Latitude in degrees.
+ * @param lon Longitude in degrees.
+ * @param k   How many items to return.
+ * @return Up to k matches, nearest first.
+ */
+vector<SpatialMatch> SpatialIndex::nearest(double lat, double lon, size_t k) const
+{
+    double query[3];
+    toUnitSphere(lat, lon, query);
+
+    vector<pair<double, uint32_t>> best;
+    best.reserve(k + 1);
+    if (k > 0)
+    {
+        searchNearest(0, nodes.size(), query, k, best);
+    }
+    sort_heap(best.begin(), best.end());
+
+    vector<SpatialMatch> matches;
+    matches.reserve(best.size());
+    for (const auto &[squared, index] : best)
+    {
+        matches.push_back({static_cast<int>(index), chordToMiles(squared)});
+    }
+    return matches;
+}
+
+/**
+ * @brief Find every item within some distance of a point.
+ * @param lat   Latitude in degrees.
+ * @param lon   Longitude in degrees.
+ * @param miles The search radius along the Earth's surface.
+ * @return The matches, nearest first.
+ */
+vector<SpatialMatch> SpatialIndex::withinRadius(double lat, double lon, double miles) const
+{
+    double query[3];
+    toUnitSphere(lat, lon, query);
+
+    // A surface distance of d is a chord of 2 sin(d / 2R) on the unit sphere
+    double angle = min(SPATIAL_PI, max(0.0, miles) / EARTH_RADIUS_MILES);
+    double chord = 2 * sin(angle / 2);
+
+    vector<pair<double, uint32_t>> found;
+    searchRadius(0, nodes.size(), query, chord * chord, found);
+    sort(found.begin(), found.end());
+
+    vector<SpatialMatch> matches;
+    matches.reserve(found.size());
+    for (const auto &[squared, index] : found)
+    {
+        matches.push_back({static_cast<int>(index), chordToMiles(squared)});
+    }
+    return matches;
+}
+
+/**
+ * @brief Find the item closest to a point (reverse geocoding).
+ * @param lat Latitude in degrees.
+ * @param lon Longitude in degrees.
+ * @return The index of the nearest item in the list, or -1 if the index is empty.
+ */
+int SpatialIndex::reverseGeocode(double lat, double lon) const
+{
+    vector<SpatialMatch> match = nearest(lat, lon, 1);
+    return match.empty() ? -1 : match[0].index;
+}
+
+/**
+ * @brief Get the number of indexed items.
+ * @return The item count at the last build.
+ */
+size_t SpatialIndex::size() const
+{
+    return nodes.size();
+}
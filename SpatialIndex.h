@@ -0,0 +1,133 @@
+/**
+ * @file SpatialIndex.h
+ * @brief Defines the SpatialIndex class for nearest-ZIP and radius searches.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The index is a k-d tree over the items' positions. Each latitude/longitude
+ * is turned into a point on the unit sphere (x, y, z). The straight-line
+ * (chord) distance between two such points grows with the great-circle
+ * distance, so the nearest points by chord are the nearest on the Earth, and
+ * the tree can prune with simple plane distances. Distances are reported in
+ * miles along the great circle.
+ */
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <vector>
+#include <cstdint>
+#include "PostalList.h"
+
+using namespace std;
+
+/**
+ * @brief One search result: an item index in the PostalList and how far away it is.
+ */
+struct SpatialMatch
+{
+    int index;    /**< Index of the item in the PostalList */
+    double miles; /**< Great-circle distance from the query point */
+};
+
+/**
+ * @brief Mean Earth radius in miles, used for every distance in this module.
+ */
+const double EARTH_RADIUS_MILES = 3958.8;
+
+/**
+ * @brief Great-circle distance between two points with the haversine formula.
+ * @param lat1 Latitude of the first point in degrees.
+ * @param lon1 Longitude of the first point in degrees.
+ * @param lat2 Latitude of the second point in degrees.
+ * @param lon2 Longitude of the second point in degrees.
+ * @return The distance in miles.
+ */
+double greatCircleMiles(double lat1, double lon1, double lat2, double lon2);
+
+/**
+ * @brief Convert a latitude/longitude to a point on the unit sphere.
+ * @param lat   Latitude in degrees.
+ * @param lon   Longitude in degrees.
+ * @param point Receives x, y, z.
+ */
+void toUnitSphere(double lat, double lon, double point[3]);
+
+class SpatialIndex
+{
+private:
+    /**
+     * @brief One tree node: a point on the unit sphere and the axis it splits.
+     */
+    struct Node
+    {
+        double point[3]; /**< x, y, z on the unit sphere */
+        uint32_t index;  /**< Index of the item in the PostalList */
+        uint8_t axis;    /**< Split axis (0, 1 or 2) */
+    };
+
+    vector<Node> nodes; /**< Implicit balanced tree: the node of [lo, hi) sits at (lo + hi) / 2 */
+
+    void build(size_t lo, size_t hi);
+    void searchNearest(size_t lo, size_t hi, const double query[3], size_t k, vector<pair<double, uint32_t>> &best) const;
+    void searchRadius(size_t lo, size_t hi, const double query[3], double limit, vector<pair<double, uint32_t>> &found) const;
+
+public:
+    /**
+     * @brief Create an empty index.
+     */
+    SpatialIndex() = default;
+
+    /**
+     * @brief Build the index over every item of a list.
+     * @param list The list to index.
+     */
+    explicit SpatialIndex(const PostalList &list);
+
+    /**
+     * @brief Rebuild the index over every item of a list.
+     * @param list The list to index.
+     * @note The index keeps item indexes, not items, so it stays usable while
+     * the list grows, but new items are not found until the next build.
+     */
+    void build(const PostalList &list);
+
+    /**
+     * @brief Find the k items closest to a point.
+     * @param lat Latitude in degrees.
+     * @param lon Longitude in degrees.
+     * @param k   How many items to return.
+     * @return Up to k matches, nearest first (ties in list order).
+     * @note About O(log N + k) for points inside the data; there is no full scan.
+     */
+    vector<SpatialMatch> nearest(double lat, double lon, size_t k) const;
+
+    /**
+     * @brief Find every item within some distance of a point.
+     * @param lat   Latitude in degrees.
+     * @param lon   Longitude in degrees.
+     * @param miles The search radius along the Earth's surface.
+     * @return The matches, nearest first (ties in list order).
+     */
+    vector<SpatialMatch> withinRadius(double lat, double lon, double miles) const;
+
+    /**
+     * @brief Find the item closest to a point (reverse geocoding).
+     * @param lat Latitude in degrees.
+     * @param lon Longitude in degrees.
+     * @return The index of the nearest item in the list, or -1 if the index is empty.
+     */
+    int reverseGeocode(double lat, double lon) const;
+
+    /**
+     * @brief Get the number of indexed items.
+     * @return The item count at the last build.
+     */
+    size_t size() const;
+};
+
+#include "SpatialIndex.cpp"
+#endif
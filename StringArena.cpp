@@ -0,0 +1,112 @@
+/**
+ * @file StringArena.cpp
+ * @brief Implementation of the StringArena class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "StringArena.h"
+#include <cstring>
+
+using namespace std;
+
+/**
+ * @brief Move constructor. The blocks change owner; views into them stay valid.
+ * @param other The arena to take the blocks from; left empty.
+ */
+StringArena::StringArena(StringArena &&other) noexcept
+{
+    *this = move(other);
+}
+
+/**
+ * @brief Move assignment. Our old blocks are freed; the other arena's blocks change owner.
+ * @param other The arena to take the blocks from; left empty.
+ * @return This arena.
+ */
+StringArena &StringArena::operator=(StringArena &&other) noexcept
+{
+    if (this != &other)
+    {
+        blocks = move(other.blocks);
+        next = other.next;
+        left = other.left;
+        blockBytes = other.blockBytes;
+        other.blocks.clear();
+        other.next = nullptr;
+        other.left = 0;
+        other.blockBytes = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Copy a string into the arena.
+ * @param value The string to copy.
+ * @return A view of the copy (an empty view for an empty string).
+ */
+string_view StringArena::store(string_view value)
+{
+    if (value.empty())
+    {
+        return string_view();
+    }
+
+    if (value.size() > left)
+    {
+        // A string longer than a quarter block gets a block of its own, so the
+        // free space left in the current block is not thrown away for it
+        if (value.size() > BLOCK_SIZE / 4)
+        {
+            blocks.emplace_back(new char[value.size()]);
+            blockBytes += value.size();
+            memcpy(blocks.back().get(), value.data(), value.size());
+            return string_view(blocks.back().get(), value.size());
+        }
+        blocks.emplace_back(new char[BLOCK_SIZE]);
+        blockBytes += BLOCK_SIZE;
+        next = blocks.back().get();
+        left = BLOCK_SIZE;
+    }
+
+    memcpy(next, value.data(), value.size());
+    string_view stored(next, value.size());
+    next += value.size();
+    left -= value.size();
+    return stored;
+}
+
+/**
+ * @brief Free every block at once.
+ */
+void StringArena::clear()
+{
+    blocks.clear();
+    next = nullptr;
+    left = 0;
+    blockBytes = 0;
+}
+
+/**
+ * @brief Get the number of blocks.
+ * @return How many blocks are allocated.
+ */
+size_t StringArena::blockCount() const
+{
+    return blocks.size();
+}
+
+/**
+ * @brief Get the heap memory the blocks use.
+ * @return Bytes in all blocks, used or not.
+ */
+size_t StringArena::memoryBytes() const
+{
+    return blockBytes + blocks.capacity() * sizeof(unique_ptr<char[]>);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file StringArena.h
+ * @brief Defines the StringArena class, bump-allocated storage for many small strings.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Strings are copied back to back into large blocks instead of getting a heap
+ * block each, so a few million names cost a few hundred allocations and are
+ * freed by releasing the blocks. Stored strings never move: a view returned
+ * by store() stays valid until the arena is cleared or destroyed, also when
+ * the arena itself is moved.
+ */
+
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <string_view>
+#include <vector>
+#include <memory>
+
+using namespace std;
+
+class StringArena
+{
+private:
+    vector<unique_ptr<char[]>> blocks; /**< Every block handed out so far */
+    char *next = nullptr;              /**< Free space in the current block */
+    size_t left = 0;                   /**< Bytes free at next */
+    size_t blockBytes = 0;             /**< Bytes in all blocks */
+
+public:
+    static const size_t BLOCK_SIZE = 64 * 1024; /**< Size of a normal block; longer strings get their own */
+
+    StringArena() = default;
+    StringArena(StringArena &&other) noexcept;
+    StringArena &operator=(StringArena &&other) noexcept;
+    StringArena(const StringArena &) = delete;
+    StringArena &operator=(const StringArena &) = delete;
+
+    /**
+     * @brief Copy a string into the arena.
+     * @param value The string to copy.
+     * @return A view of the copy (an empty view for an empty string).
+     */
+    string_view store(string_view value);
+
+    /**
+     * @brief Free every block at once.
+     * @note Every view returned by store() is invalid afterwards.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of blocks.
+     * @return How many blocks are allocated.
+     */
+    size_t blockCount() const;
+
+    /**
+     * @brief Get the heap memory the blocks use.
+     * @return Bytes in all blocks, used or not.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "StringArena.cpp"
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file StringDictionary.cpp
+ * @brief Implementation of the StringDictionary class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "StringDictionary.h"
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * @brief Copy constructor. The lookup table is rebuilt so its keys view into our own strings.
+ * @param other The dictionary to copy.
+ */
+StringDictionary::StringDictionary(const StringDictionary &other)
+{
+    *this = other;
+}
+
+/**
+ * @brief Copy assignment. The lookup table is rebuilt so its keys view into our own strings.
+ * @param other The dictionary to copy.
+ * @return This dictionary.
+ */
+StringDictionary &StringDictionary::operator=(const StringDictionary &other)
+{
+    if (this != &other)
+    {
+        text.clear();
+        values.clear();
+        ids.clear();
+        values.reserve(other.values.size());
+        ids.reserve(other.values.size());
+        for (string_view value : other.values)
+        {
+            intern(value);
+        }
+        ranks = other.ranks;
+    }
+    return *this;
+}
+
+/**
+ * @brief Get the id of a string, adding it if it is new.
+ * @param value The string to intern.
+ * @return The id.
+ */
+uint32_t StringDictionary::intern(string_view value)
+{
+    auto found = ids.find(value);
+    if (found != ids.end())
+    {
+        return found->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(values.size());
+    values.push_back(text.store(value));
+    ids.emplace(values.back(), id);
+    ranks.clear();
+    return id;
+}
+
+/**
+ * @brief Look up a string without adding it.
+ * @param value The string to find.
+ * @return Its id, or npos if it was never interned.
+ */
+uint32_t StringDictionary::find(string_view value) const
+{
+    auto found = ids.find(value);
+    return (found == ids.end()) ? npos : found->second;
+}
+
+/**
+ * @brief Get the string for an id.
+ * @param id An id returned by intern().
+ * @return The interned string.
+ */
+string_view StringDictionary::at(uint32_t id) const
+{
+    return values[id];
+}
+
+/**
+ * @brief Get the number of distinct strings.
+ * @return The number of ids handed out.
+ */
+size_t StringDictionary::size() const
+{
+    return values.size();
+}
+
+/**
+ * @brief Get the alphabetical position of every id.
+ * @return ranks[id] is the index the string would have in a sorted list.
+ */
+const vector<uint32_t> &StringDictionary::sortRanks() const
+{
+    if (ranks.size() != values.size())
+    {
+        vector<uint32_t> order(values.size());
+        for (uint32_t id = 0; id < order.size(); id++)
+        {
+            order[id] = id;
+        }
+        sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+             {
+                 return values[a] < values[b];
+             });
+
+        ranks.assign(values.size(), 0);
+        for (uint32_t position = 0; position < order.size(); position++)
+        {
+            ranks[order[position]] = position;
+        }
+    }
+    return ranks;
+}
+
+/**
+ * @brief Estimate the heap memory the dictionary uses.
+ * @return Bytes used by the strings, the lookup table and the ranks.
+ */
+size_t StringDictionary::memoryBytes() const
+{
+    size_t bytes = text.memoryBytes() + values.capacity() * sizeof(string_view) +
+                   ranks.capacity() * sizeof(uint32_t);
+    // Each hash node holds the key, the id and a next pointer, plus one bucket pointer
+    bytes += ids.size() * (sizeof(void *) + sizeof(string_view) + sizeof(uint32_t) + sizeof(size_t));
+    bytes += ids.bucket_count() * sizeof(void *);
+    return bytes;
+}
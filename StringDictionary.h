@@ -0,0 +1,91 @@
+/**
+ * @file StringDictionary.h
+ * @brief Defines the StringDictionary class for interning repeated strings.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * A StringDictionary gives every distinct string a small integer id, so a
+ * column of state or county names can be stored as ids instead of strings.
+ * There are only about 60 states and 3,000 counties in the data set.
+ * The strings themselves are kept in a StringArena, so they do not move and
+ * a view returned by at() stays valid for as long as the dictionary lives
+ * (moving the dictionary included).
+ */
+
+#ifndef STRING_DICTIONARY_H
+#define STRING_DICTIONARY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "StringArena.h"
+
+using namespace std;
+
+class StringDictionary
+{
+private:
+    StringArena text;                         /**< The characters of every interned string */
+    vector<string_view> values;               /**< Interned strings by id; they view into text */
+    unordered_map<string_view, uint32_t> ids; /**< String -> id; the keys view into text */
+    mutable vector<uint32_t> ranks;           /**< Sort position of each id (built on demand) */
+
+public:
+    static const uint32_t npos = 0xFFFFFFFFu; /**< Returned by find() for unknown strings */
+
+    StringDictionary() = default;
+    StringDictionary(const StringDictionary &other);
+    StringDictionary &operator=(const StringDictionary &other);
+    StringDictionary(StringDictionary &&other) = default;
+    StringDictionary &operator=(StringDictionary &&other) = default;
+
+    /**
+     * @brief Get the id of a string, adding it if it is new.
+     * @param value The string to intern.
+     * @return The id (ids count up from 0 in first-seen order).
+     */
+    uint32_t intern(string_view value);
+
+    /**
+     * @brief Look up a string without adding it.
+     * @param value The string to find.
+     * @return Its id, or npos if it was never interned.
+     */
+    uint32_t find(string_view value) const;
+
+    /**
+     * @brief Get the string for an id.
+     * @param id An id returned by intern().
+     * @return The interned string; valid as long as the dictionary.
+     */
+    string_view at(uint32_t id) const;
+
+    /**
+     * @brief Get the number of distinct strings.
+     * @return The number of ids handed out.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the alphabetical position of every id.
+     * @return ranks[id] is the index the string would have in a sorted list.
+     * @note Comparing ranks gives the same order as comparing the strings.
+     * The table is rebuilt on the first call after new strings are interned,
+     * so call it once before sharing the dictionary between threads.
+     */
+    const vector<uint32_t> &sortRanks() const;
+
+    /**
+     * @brief Estimate the heap memory the dictionary uses.
+     * @return Bytes used by the strings, the lookup table and the ranks.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "StringDictionary.cpp"
+#endif
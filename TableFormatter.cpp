@@ -0,0 +1,276 @@
+/**
+ * @file TableFormatter.cpp
+ * @brief Implementation of the TableFormatter class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "TableFormatter.h"
+#include "Metrics.h"
+#include <charconv>
+#include <cstdio>
+
+using namespace std;
+
+const string_view TABLE_SEPARATOR =
+    "-----------------------------------------------------------------------------------------------\n";
+
+/**
+ * @brief Create a formatter that writes to a stream.
+ * @param out        The stream, e.g. cout or an ofstream.
+ * @param format     The layout of each row.
+ * @param bufferSize How much text to collect before each write.
+ */
+TableFormatter::TableFormatter(ostream &out, OutputFormat format, size_t bufferSize) : out(out)
+{
+    this->format = format;
+    flushAt = bufferSize;
+    buffer.reserve(bufferSize + 256);
+}
+
+/**
+ * @brief Write out whatever is still buffered.
+ */
+TableFormatter::~TableFormatter()
+{
+    flush();
+}
+
+/**
+ * @brief Get the layout this formatter writes.
+ * @return The output format.
+ */
+OutputFormat TableFormatter::getFormat() const
+{
+    return format;
+}
+
+/**
+ * @brief Pad the text appended since @p start with spaces to @p width characters.
+ * Longer text is not cut, just as setw does not cut it.
+ */
+void TableFormatter::padFrom(size_t start, size_t width)
+{
+    size_t written = buffer.size() - start;
+    if (written < width)
+    {
+        buffer.append(width - written, ' ');
+    }
+}
+
+/**
+ * @brief Append text left-aligned in a field, like cout << left << setw(width).
+ */
+void TableFormatter::padded(string_view text, size_t width)
+{
+    size_t start = buffer.size();
+    buffer.append(text);
+    padFrom(start, width);
+}
+
+/**
+ * @brief Append a double: as cout prints it (%g, 6 digits) or the shortest round-trip text.
+ */
+void TableFormatter::number(double value, bool tableStyle)
+{
+    char text[32];
+    size_t length;
+#if defined(__cpp_lib_to_chars)
+    to_chars_result result = tableStyle ? to_chars(text, text + sizeof(text), value, chars_format::general, 6)
+                                        : to_chars(text, text + sizeof(text), value);
+    length = result.ptr - text;
+#else
+    length = snprintf(text, sizeof(text), tableStyle ? "%g" : "%.17g", value);
+#endif
+    buffer.append(text, length);
+}
+
+/**
+ * @brief Append a JSON string literal.
+ */
+void TableFormatter::quoted(string_view text)
+{
+    static const char HEX[] = "0123456789abcdef";
+    buffer += '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            buffer += '\\';
+            buffer += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            buffer.append("\\u00");
+            buffer += HEX[(c >> 4) & 0xF];
+            buffer += HEX[c & 0xF];
+        }
+        else
+        {
+            buffer += c;
+        }
+    }
+    buffer += '"';
+}
+
+/**
+ * @brief Write the column headings.
+ */
+void TableFormatter::writeHeader()
+{
+    switch (format)
+    {
+    case OutputFormat::Table:
+        padded("Zip Code", 10);
+        padded("Place Name", 20);
+        padded("State", 10);
+        padded("County", 30);
+        padded("Latitude", 12);
+        padded("Longitude", 12);
+        buffer += '\n';
+        buffer.append(TABLE_SEPARATOR);
+        break;
+    case OutputFormat::TSV:
+        buffer.append("zip\tplace\tstate\tcounty\tlatitude\tlongitude\n");
+        break;
+    case OutputFormat::CSV:
+        buffer.append("zip,place,state,county,latitude,longitude\n");
+        break;
+    case OutputFormat::JSONLines:
+        break;
+    }
+}
+
+/**
+ * @brief Write one record.
+ * @param zip       ZIP code.
+ * @param place     Place name.
+ * @param state     State abbreviation.
+ * @param county    County name.
+ * @param latitude  Latitude.
+ * @param longitude Longitude.
+ */
+void TableFormatter::writeRow(int zip, string_view place, string_view state, string_view county, double latitude, double longitude)
+{
+    char zipText[16];
+    string_view zipField(zipText, to_chars(zipText, zipText + sizeof(zipText), zip).ptr - zipText);
+
+    switch (format)
+    {
+    case OutputFormat::Table:
+    {
+        padded(zipField, 10);
+        padded(place, 20);
+        padded(state, 10);
+        padded(county, 30);
+        size_t start = buffer.size();
+        number(latitude, true);
+        padFrom(start, 12);
+        start = buffer.size();
+        number(longitude, true);
+        padFrom(start, 12);
+        break;
+    }
+    case OutputFormat::TSV:
+    case OutputFormat::CSV:
+    {
+        char separator = (format == OutputFormat::TSV) ? '\t' : ',';
+        buffer.append(zipField);
+        for (string_view text : {place, state, county})
+        {
+            buffer += separator;
+            // CSV fields with a comma, quote or line break are quoted, quotes doubled
+            if (format == OutputFormat::CSV && text.find_first_of(",\"\r\n") != string_view::npos)
+            {
+                buffer += '"';
+                for (char c : text)
+                {
+                    buffer.append(c == '"' ? 2 : 1, c);
+                }
+                buffer += '"';
+            }
+            else if (format == OutputFormat::TSV && text.find_first_of("\t\r\n") != string_view::npos)
+            {
+                // TSV has no quoting, so tabs and line breaks inside a field become spaces
+                for (char c : text)
+                {
+                    buffer += (c == '\t' || c == '\r' || c == '\n') ? ' ' : c;
+                }
+            }
+            else
+            {
+                buffer.append(text);
+            }
+        }
+        buffer += separator;
+        number(latitude, false);
+        buffer += separator;
+        number(longitude, false);
+        break;
+    }
+    case OutputFormat::JSONLines:
+        buffer.append("{\"zip\":");
+        buffer.append(zipField);
+        buffer.append(",\"place\":");
+        quoted(place);
+        buffer.append(",\"state\":");
+        quoted(state);
+        buffer.append(",\"county\":");
+        quoted(county);
+        buffer.append(",\"latitude\":");
+        number(latitude, false);
+        buffer.append(",\"longitude\":");
+        number(longitude, false);
+        buffer += '}';
+        break;
+    }
+    buffer += '\n';
+
+    if (buffer.size() >= flushAt)
+    {
+        flush();
+    }
+}
+
+/**
+ * @brief Write the dashed line that separates rows in table mode.
+ */
+void TableFormatter::writeSeparator()
+{
+    if (format == OutputFormat::Table)
+    {
+        buffer.append(TABLE_SEPARATOR);
+    }
+}
+
+/**
+ * @brief Write text as is.
+ * @param text The text, e.g. a title line.
+ */
+void TableFormatter::writeText(string_view text)
+{
+    buffer.append(text);
+    if (buffer.size() >= flushAt)
+    {
+        flush();
+    }
+}
+
+/**
+ * @brief Hand the buffered text to the stream (without flushing the stream itself).
+ */
+void TableFormatter::flush()
+{
+    if (!buffer.empty())
+    {
+        out.write(buffer.data(), buffer.size());
+        Metrics::add(MetricCounter::BytesWritten, buffer.size());
+        buffer.clear();
+    }
+}
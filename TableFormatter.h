@@ -0,0 +1,115 @@
+/**
+ * @file TableFormatter.h
+ * @brief Defines the TableFormatter class, a buffered writer for postal records.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Printing each row through cout << setw(...) << endl flushes the stream on
+ * every line. TableFormatter instead renders rows into one reusable buffer
+ * (padding and number formatting done by hand) and hands the buffer to the
+ * stream in large chunks. The table layout is byte-for-byte the one
+ * PostalCodeItem::printInfo() has always printed; TSV, CSV and JSON lines
+ * go through the same buffer.
+ * PostalCodeItem::printInfo(TableFormatter &) writes one item through it.
+ */
+
+#ifndef TABLE_FORMATTER_H
+#define TABLE_FORMATTER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/**
+ * @brief The output layouts TableFormatter can write.
+ */
+enum class OutputFormat
+{
+    Table,    /**< Fixed-width columns, as printInfo() prints them */
+    TSV,      /**< Tab-separated values with a header row (tabs in fields become spaces) */
+    CSV,      /**< Comma-separated values (RFC 4180 quoting) with a header row */
+    JSONLines /**< One JSON object per line */
+};
+
+class TableFormatter
+{
+private:
+    ostream &out;        /**< Where the buffer goes */
+    OutputFormat format; /**< Layout of each row */
+    string buffer;       /**< Rendered text not yet written */
+    size_t flushAt;      /**< Write the buffer out once it grows past this size */
+
+    void padFrom(size_t start, size_t width);
+    void padded(string_view text, size_t width);
+    void number(double value, bool tableStyle);
+    void quoted(string_view text);
+
+public:
+    /**
+     * @brief Create a formatter that writes to a stream.
+     * @param out        The stream, e.g. cout or an ofstream.
+     * @param format     The layout of each row.
+     * @param bufferSize How much text to collect before each write.
+     */
+    explicit TableFormatter(ostream &out = cout, OutputFormat format = OutputFormat::Table, size_t bufferSize = 1 << 16);
+
+    /**
+     * @brief Write out whatever is still buffered.
+     */
+    ~TableFormatter();
+
+    TableFormatter(const TableFormatter &) = delete;
+    TableFormatter &operator=(const TableFormatter &) = delete;
+
+    /**
+     * @brief Get the layout this formatter writes.
+     * @return The output format.
+     */
+    OutputFormat getFormat() const;
+
+    /**
+     * @brief Write the column headings.
+     * @note Table: the heading line and a separator line, as main1/main2
+     * print them. TSV/CSV: one line of column names. JSON lines: nothing.
+     */
+    void writeHeader();
+
+    /**
+     * @brief Write one record.
+     * @param zip       ZIP code.
+     * @param place     Place name.
+     * @param state     State abbreviation.
+     * @param county    County name.
+     * @param latitude  Latitude.
+     * @param longitude Longitude.
+     * @note In table mode the coordinates use 6 significant digits like
+     * cout does; the other formats write the shortest text that reads back
+     * as the same double.
+     */
+    void writeRow(int zip, string_view place, string_view state, string_view county, double latitude, double longitude);
+
+    /**
+     * @brief Write the dashed line that separates rows in table mode.
+     * @note Does nothing in the other formats.
+     */
+    void writeSeparator();
+
+    /**
+     * @brief Write text as is.
+     * @param text The text, e.g. a title line.
+     */
+    void writeText(string_view text);
+
+    /**
+     * @brief Hand the buffered text to the stream (without flushing the stream itself).
+     */
+    void flush();
+};
+
+#include "TableFormatter.cpp"
+#endif
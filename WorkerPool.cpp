@@ -0,0 +1,140 @@
+/**
+ * @file WorkerPool.cpp
+ * @brief Implementation of the WorkerPool class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "WorkerPool.h"
+#include "ParallelFor.h"
+
+using namespace std;
+
+/**
+ * @brief Start the workers.
+ * @param threadCount How many threads (0 = one per hardware thread).
+ */
+WorkerPool::WorkerPool(unsigned threadCount)
+{
+    unsigned count = workerCount(threadCount);
+    for (unsigned t = 0; t < count; t++)
+    {
+        threads.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+/**
+ * @brief Finish the queued tasks and stop the workers.
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+}
+
+/**
+ * @brief Take tasks off the queue until the pool stops.
+ */
+void WorkerPool::work()
+{
+    while (true)
+    {
+        function<void()> next;
+        {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&]()
+                      { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return;
+            }
+            next = move(tasks.front());
+            tasks.pop_front();
+        }
+        next();
+    }
+}
+
+/**
+ * @brief Run task(0) .. task(taskCount - 1) on the workers and wait for all of them.
+ * @param taskCount How many tasks to run.
+ * @param task      The work for one task number.
+ */
+void WorkerPool::run(size_t taskCount, const function<void(size_t)> &task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    mutex doneLock;
+    condition_variable doneWake;
+    size_t remaining = taskCount;
+    exception_ptr failure;
+    {
+        lock_guard<mutex> guard(lock);
+        for (size_t i = 0; i < taskCount; i++)
+        {
+            tasks.push_back([&, i]()
+                            {
+                                // An exception must not end the worker or leave the caller waiting
+                                exception_ptr thrown;
+                                try
+                                {
+                                    task(i);
+                                }
+                                catch (...)
+                                {
+                                    thrown = current_exception();
+                                }
+                                lock_guard<mutex> doneGuard(doneLock);
+                                if (thrown && !failure)
+                                {
+                                    failure = thrown;
+                                }
+                                if (--remaining == 0)
+                                {
+                                    doneWake.notify_one();
+                                }
+                            });
+        }
+    }
+    if (taskCount == 1)
+    {
+        wake.notify_one();
+    }
+    else
+    {
+        wake.notify_all();
+    }
+
+    unique_lock<mutex> doneGuard(doneLock);
+    doneWake.wait(doneGuard, [&]()
+                  { return remaining == 0; });
+    if (failure)
+    {
+        rethrow_exception(failure);
+    }
+}
+
+/**
+ * @brief Get the number of workers.
+ * @return The thread count.
+ */
+size_t WorkerPool::size() const
+{
+    return threads.size();
+}
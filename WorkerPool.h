@@ -0,0 +1,75 @@
+/**
+ * @file WorkerPool.h
+ * @brief Defines the WorkerPool class, a fixed set of threads that run batches of tasks.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * parallelFor() starts its threads on every call, which is fine for a load
+ * that runs once. A server answers small batches all day, so its threads are
+ * started once here and wait for work. Several callers may hand in batches at
+ * the same time; the tasks share one queue and each caller waits only for
+ * its own batch.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <functional>
+#include <exception>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+class WorkerPool
+{
+private:
+    vector<thread> threads;         /**< The workers */
+    deque<function<void()>> tasks;  /**< Tasks not yet started */
+    mutex lock;                     /**< Guards tasks and stopping */
+    condition_variable wake;        /**< Signalled when a task is queued or the pool stops */
+    bool stopping = false;          /**< Set by the destructor */
+
+    void work();
+
+public:
+    /**
+     * @brief Start the workers.
+     * @param threadCount How many threads (0 = one per hardware thread).
+     */
+    explicit WorkerPool(unsigned threadCount = 0);
+
+    /**
+     * @brief Finish the queued tasks and stop the workers.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    /**
+     * @brief Run task(0) .. task(taskCount - 1) on the workers and wait for all of them.
+     * @param taskCount How many tasks to run.
+     * @param task      The work for one task number. It must be safe to call concurrently.
+     * @note Safe to call from several threads at once. Do not call it from a
+     * task: the caller blocks until its batch is done. If tasks throw, the
+     * rest of the batch still runs and the first exception is rethrown here;
+     * the workers carry on.
+     */
+    void run(size_t taskCount, const function<void(size_t)> &task);
+
+    /**
+     * @brief Get the number of workers.
+     * @return The thread count.
+     */
+    size_t size() const;
+};
+
+#include "WorkerPool.cpp"
+#endif
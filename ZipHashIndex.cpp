@@ -0,0 +1,369 @@
+/**
+ * @file ZipHashIndex.cpp
+ * @brief Implementation of the ZipHashIndex class and its builder.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "ZipHashIndex.h"
+#include "FieldScanner.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+const char ZIP_HASH_MAGIC[8] = {'Z', 'I', 'P', 'M', 'P', 'H', '\0', '\0'};
+const uint32_t MAX_PILOT = 1u << 24; /**< A bucket that needs more tries than this restarts the build with a new seed */
+
+/**
+ * @brief Scramble 64 bits (the splitmix64 finalizer); every input bit affects every output bit.
+ */
+uint64_t mixBits(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief Hash a ZIP code with a seed. Different ZIP codes never get the same hash.
+ */
+uint64_t zipHash(int zip, uint64_t seed)
+{
+    return mixBits(static_cast<uint64_t>(static_cast<uint32_t>(zip)) ^ seed);
+}
+
+/**
+ * @brief Map 32 hash bits onto 0 .. range-1 with a multiply instead of a division.
+ */
+uint64_t scaleHash(uint64_t bits, uint64_t range)
+{
+    return ((bits & 0xFFFFFFFFull) * range) >> 32;
+}
+
+/**
+ * @brief The bucket of a key hash (from its high bits).
+ */
+uint64_t hashBucket(uint64_t hash, uint64_t bucketCount)
+{
+    return scaleHash(hash >> 32, bucketCount);
+}
+
+/**
+ * @brief The slot of a key hash under a bucket's pilot.
+ */
+uint64_t hashSlot(uint64_t hash, uint32_t pilot, uint64_t slotCount)
+{
+    return scaleHash(mixBits(hash ^ (pilot * 0x9E3779B97F4A7C15ull)), slotCount);
+}
+
+/**
+ * @brief Create a closed index.
+ */
+ZipHashIndex::ZipHashIndex()
+{
+    header = nullptr;
+    pilots = nullptr;
+    offsetWords = nullptr;
+}
+
+/**
+ * @brief Build a minimal perfect hash over some entries and write it.
+ * @param fileName The index file (replaced if it exists).
+ * @param entries  The records; for a ZIP code that appears twice the first record is kept.
+ * @param dataName The data file they point into, for isStale().
+ * @return true if the whole file was written.
+ */
+bool ZipHashIndex::write(const string &fileName, const vector<ZipIndexEntry> &entries, const string &dataName)
+{
+    // One key per ZIP code, keeping the first record of each
+    vector<ZipIndexEntry> keys(entries);
+    stable_sort(keys.begin(), keys.end(), [](const ZipIndexEntry &a, const ZipIndexEntry &b)
+                {
+                    return a.zip < b.zip;
+                });
+    keys.erase(std::unique(keys.begin(), keys.end(), [](const ZipIndexEntry &a, const ZipIndexEntry &b)
+                             {
+                                 return a.zip == b.zip;
+                             }),
+                 keys.end());
+
+    const uint64_t keyCount = keys.size();
+    const uint64_t bucketCount = max<uint64_t>(1, (keyCount + 4) / 5);
+    vector<uint32_t> bucketPilots(bucketCount, 0);
+    vector<uint64_t> slotOffsets(keyCount, 0);
+    uint64_t seed = 0;
+
+    for (uint64_t attempt = 0; keyCount > 0; attempt++)
+    {
+        seed = mixBits(attempt + 0x5A17C0DEull);
+
+        // Group the keys by bucket (counting sort), then visit the biggest buckets first
+        vector<uint64_t> hashes(keyCount);
+        vector<uint32_t> bucketStart(bucketCount + 1, 0);
+        for (uint64_t i = 0; i < keyCount; i++)
+        {
+            hashes[i] = zipHash(keys[i].zip, seed);
+            bucketStart[hashBucket(hashes[i], bucketCount) + 1]++;
+        }
+        for (uint64_t b = 0; b < bucketCount; b++)
+        {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        vector<uint32_t> members(keyCount);
+        vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+        for (uint64_t i = 0; i < keyCount; i++)
+        {
+            members[fill[hashBucket(hashes[i], bucketCount)]++] = static_cast<uint32_t>(i);
+        }
+        vector<uint32_t> buckets(bucketCount);
+        for (uint32_t b = 0; b < bucketCount; b++)
+        {
+            buckets[b] = b;
+        }
+        stable_sort(buckets.begin(), buckets.end(), [&](uint32_t a, uint32_t b)
+                    {
+                        return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+                    });
+
+        // Try pilots until every key of the bucket lands on its own free slot
+        vector<uint8_t> taken(keyCount, 0);
+        vector<uint64_t> placed;
+        bool failed = false;
+        for (uint32_t b : buckets)
+        {
+            if (bucketStart[b] == bucketStart[b + 1])
+            {
+                break; // the rest are empty
+            }
+            uint32_t pilot = 0;
+            for (; pilot < MAX_PILOT; pilot++)
+            {
+                placed.clear();
+                for (uint32_t m = bucketStart[b]; m < bucketStart[b + 1]; m++)
+                {
+                    uint64_t slot = hashSlot(hashes[members[m]], pilot, keyCount);
+                    if (taken[slot])
+                    {
+                        break;
+                    }
+                    taken[slot] = 1;
+                    placed.push_back(slot);
+                }
+                if (placed.size() == bucketStart[b + 1] - bucketStart[b])
+                {
+                    break;
+                }
+                for (uint64_t slot : placed)
+                {
+                    taken[slot] = 0;
+                }
+            }
+            if (pilot == MAX_PILOT)
+            {
+                failed = true;
+                break;
+            }
+            bucketPilots[b] = pilot;
+            for (size_t m = 0; m < placed.size(); m++)
+            {
+                slotOffsets[placed[m]] = keys[members[bucketStart[b] + m]].offset;
+            }
+        }
+        if (!failed)
+        {
+            break;
+        }
+    }
+
+    // Pack the offsets with just as many bits as the largest one needs
+    uint64_t largest = 0;
+    for (uint64_t offset : slotOffsets)
+    {
+        largest = max(largest, offset);
+    }
+    uint32_t bits = 1;
+    while (bits < 64 && (largest >> bits) != 0)
+    {
+        bits++;
+    }
+    vector<uint64_t> words((keyCount * bits + 63) / 64 + 1, 0);
+    for (uint64_t slot = 0; slot < keyCount; slot++)
+    {
+        uint64_t position = slot * bits;
+        uint64_t shift = position % 64;
+        words[position / 64] |= slotOffsets[slot] << shift;
+        if (shift + bits > 64)
+        {
+            words[position / 64 + 1] |= slotOffsets[slot] >> (64 - shift);
+        }
+    }
+
+    ZipHashHeader head = {};
+    memcpy(head.magic, ZIP_HASH_MAGIC, sizeof(head.magic));
+    head.version = ZIP_HASH_VERSION;
+    head.offsetBits = bits;
+    head.keyCount = keyCount;
+    head.bucketCount = bucketCount;
+    head.seed = seed;
+    if (!fileStamp(dataName, head.dataSize, head.dataModified))
+    {
+        head.dataSize = 0;
+        head.dataModified = -1;
+    }
+
+    const char padding[8] = {};
+    size_t pilotBytes = bucketCount * sizeof(uint32_t);
+    return replaceFile(fileName, {string_view(reinterpret_cast<const char *>(&head), sizeof(head)),
+                                  string_view(reinterpret_cast<const char *>(bucketPilots.data()), pilotBytes),
+                                  string_view(padding, (8 - (sizeof(head) + pilotBytes) % 8) % 8),
+                                  string_view(reinterpret_cast<const char *>(words.data()),
+                                              words.size() * sizeof(uint64_t))});
+}
+
+/**
+ * @brief Map a hash index file and check its header.
+ * @param fileName The index file.
+ * @return true if it is a version-1 hash index whose size matches its header.
+ */
+bool ZipHashIndex::open(const string &fileName)
+{
+    close();
+    if (!file.open(fileName, AccessPattern::Random) || file.size() < sizeof(ZipHashHeader))
+    {
+        close();
+        return false;
+    }
+
+    const ZipHashHeader *head = reinterpret_cast<const ZipHashHeader *>(file.data());
+    bool valid = memcmp(head->magic, ZIP_HASH_MAGIC, sizeof(head->magic)) == 0 &&
+                 head->version == ZIP_HASH_VERSION &&
+                 head->offsetBits >= 1 && head->offsetBits <= 64 &&
+                 head->bucketCount >= 1 && head->bucketCount <= file.size() &&
+                 head->keyCount <= file.size() * 8 && head->keyCount <= 0xFFFFFFFFull;
+    size_t wordsStart = 0;
+    if (valid)
+    {
+        size_t pilotEnd = sizeof(ZipHashHeader) + head->bucketCount * sizeof(uint32_t);
+        wordsStart = (pilotEnd + 7) / 8 * 8;
+        size_t wordCount = (head->keyCount * head->offsetBits + 63) / 64 + 1;
+        valid = file.size() == wordsStart + wordCount * sizeof(uint64_t);
+    }
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    header = head;
+    pilots = reinterpret_cast<const uint32_t *>(file.data() + sizeof(ZipHashHeader));
+    offsetWords = reinterpret_cast<const uint64_t *>(file.data() + wordsStart);
+    return true;
+}
+
+/**
+ * @brief Unmap the index.
+ */
+void ZipHashIndex::close()
+{
+    file.close();
+    header = nullptr;
+    pilots = nullptr;
+    offsetWords = nullptr;
+}
+
+/**
+ * @brief Check whether an index is open.
+ * @return true after a successful open().
+ */
+bool ZipHashIndex::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Check whether the data file changed since the index was built.
+ * @param dataName The length-indicated data file.
+ * @return true if its size or modification time differ, or it cannot be read.
+ */
+bool ZipHashIndex::isStale(const string &dataName) const
+{
+    uint64_t dataSize;
+    int64_t modified;
+    if (!isOpen() || !fileStamp(dataName, dataSize, modified))
+    {
+        return true;
+    }
+    return dataSize != header->dataSize || modified != header->dataModified;
+}
+
+/**
+ * @brief Get the number of ZIP codes in the index.
+ * @return N (0 when closed).
+ */
+size_t ZipHashIndex::size() const
+{
+    return isOpen() ? header->keyCount : 0;
+}
+
+/**
+ * @brief Get the size of the index file.
+ * @return Bytes (0 when closed).
+ */
+size_t ZipHashIndex::fileBytes() const
+{
+    return isOpen() ? file.size() : 0;
+}
+
+/**
+ * @brief Read the packed offset of a slot.
+ */
+uint64_t ZipHashIndex::offsetAt(uint64_t slot) const
+{
+    uint32_t bits = header->offsetBits;
+    uint64_t position = slot * bits;
+    uint64_t shift = position % 64;
+    uint64_t value = offsetWords[position / 64] >> shift;
+    if (shift + bits > 64)
+    {
+        value |= offsetWords[position / 64 + 1] << (64 - shift);
+    }
+    return (bits == 64) ? value : value & ((1ull << bits) - 1);
+}
+
+/**
+ * @brief Get the offset of the record a ZIP code maps to.
+ * @param zip The ZIP code.
+ * @return Offset in the data file just past the record's length prefix, or NOT_FOUND if the index is empty.
+ */
+uint64_t ZipHashIndex::find(int zip) const
+{
+    if (size() == 0)
+    {
+        return NOT_FOUND;
+    }
+    uint64_t hash = zipHash(zip, header->seed);
+    uint32_t pilot = pilots[hashBucket(hash, header->bucketCount)];
+    return offsetAt(hashSlot(hash, pilot, header->keyCount));
+}
+
+/**
+ * @brief Check that a record read at find(zip) really is that ZIP code.
+ * @param record The record text, starting at the offset find() returned.
+ * @param zip    The ZIP code looked up.
+ * @return true if the record's first field is @p zip.
+ */
+bool ZipHashIndex::matches(string_view record, int zip)
+{
+    int found = 0;
+    return parseInteger(record.substr(0, record.find(',')), found) && found == zip;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file ZipHashIndex.h
+ * @brief Defines the ZipHashIndex class, a minimal perfect hash from ZIP code to record offset.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The data set is rebuilt nightly and never changes in between, so the set
+ * of ZIP codes is known when the index is built. A minimal perfect hash gives
+ * each of the N ZIP codes its own slot in 0 .. N-1, and the index stores
+ * only what is needed to compute that slot plus the slot's record offset:
+ * no keys at all.
+ *
+ * The hash is built with "hash and displace" (as in CHD and PTHash). Keys are
+ * hashed into buckets of about five; the buckets are placed largest first,
+ * and for each one the builder tries pilot values until
+ * slot = hash(key, pilot) scaled to 0 .. N-1 lands every key of the bucket
+ * on a free slot.
+ * A lookup is one hash, one read of the bucket's pilot, one read of the
+ * packed offset, and then one read of the data file. Because the keys are
+ * not stored, a ZIP code that is not in the set still maps to some slot;
+ * the caller checks the record it reads (see matches()).
+ *
+ * File layout (version 1, little-endian):
+ * - ZipHashHeader: magic "ZIPMPH\0\0", version, bits per offset, key count,
+ *   bucket count, hash seed, and the data file's size and modification time.
+ * - bucketCount uint32 pilots.
+ * - The record offsets of slots 0 .. N-1, offsetBits bits each, packed into
+ *   uint64 words (plus one spare word), starting on an 8-byte boundary.
+ */
+
+#ifndef ZIP_HASH_INDEX_H
+#define ZIP_HASH_INDEX_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+#include "ZipIndexFile.h"
+
+using namespace std;
+
+/**
+ * @brief The fixed header at the start of a hash index file.
+ */
+struct ZipHashHeader
+{
+    char magic[8];        /**< "ZIPMPH\0\0" */
+    uint32_t version;     /**< ZIP_HASH_VERSION */
+    uint32_t offsetBits;  /**< Width of each packed offset */
+    uint64_t keyCount;    /**< N, the number of distinct ZIP codes (and slots) */
+    uint64_t bucketCount; /**< Number of pilots */
+    uint64_t seed;        /**< Seed the builder settled on */
+    uint64_t dataSize;    /**< Size of the data file the index was built from */
+    int64_t dataModified; /**< Its modification time (seconds since 1970) */
+};
+
+const uint32_t ZIP_HASH_VERSION = 1;
+
+class ZipHashIndex
+{
+private:
+    MappedFile file;             /**< The mapped index */
+    const ZipHashHeader *header; /**< Start of the mapping (nullptr when closed) */
+    const uint32_t *pilots;      /**< One pilot per bucket */
+    const uint64_t *offsetWords; /**< The packed offsets */
+
+    uint64_t offsetAt(uint64_t slot) const;
+
+public:
+    static const uint64_t NOT_FOUND = ~0ull; /**< Returned by find() when the index is empty or closed */
+
+    /**
+     * @brief Create a closed index.
+     */
+    ZipHashIndex();
+
+    ZipHashIndex(const ZipHashIndex &) = delete;
+    ZipHashIndex &operator=(const ZipHashIndex &) = delete;
+
+    /**
+     * @brief Build a minimal perfect hash over some entries and write it.
+     * @param fileName The index file (replaced if it exists, see replaceFile()).
+     * @param entries  The records, e.g. from ZipIndexFile::scan(). For a ZIP
+     *                 code that appears twice the first record is kept.
+     * @param dataName The data file they point into, for isStale().
+     * @return true if the whole file was written.
+     * @note Expected build time is linear; about 100 ms for the US data (see benchmarkHashIndex).
+     */
+    static bool write(const string &fileName, const vector<ZipIndexEntry> &entries, const string &dataName);
+
+    /**
+     * @brief Map a hash index file and check its header.
+     * @param fileName The index file.
+     * @return true if it is a version-1 hash index whose size matches its header.
+     */
+    bool open(const string &fileName);
+
+    /**
+     * @brief Unmap the index.
+     */
+    void close();
+
+    /**
+     * @brief Check whether an index is open.
+     * @return true after a successful open().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Check whether the data file changed since the index was built.
+     * @param dataName The length-indicated data file.
+     * @return true if its size or modification time differ, or it cannot be read.
+     */
+    bool isStale(const string &dataName) const;
+
+    /**
+     * @brief Get the number of ZIP codes in the index.
+     * @return N (0 when closed).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the size of the index file.
+     * @return Bytes (0 when closed).
+     */
+    size_t fileBytes() const;
+
+    /**
+     * @brief Get the offset of the record a ZIP code maps to.
+     * @param zip The ZIP code.
+     * @return Offset in the data file just past the record's length prefix,
+     * or NOT_FOUND if the index is empty.
+     * @note For a ZIP code that is not in the index this is some other
+     * record; check it with matches().
+     */
+    uint64_t find(int zip) const;
+
+    /**
+     * @brief Check that a record read at find(zip) really is that ZIP code.
+     * @param record The record text, starting at the offset find() returned.
+     * @param zip    The ZIP code looked up.
+     * @return true if the record's first field is @p zip.
+     */
+    static bool matches(string_view record, int zip);
+};
+
+#include "ZipHashIndex.cpp"
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file ZipIndexFile.cpp
+ * @brief Implementation of the ZipIndexFile class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "ZipIndexFile.h"
+#include "RecordBoundaries.h"
+#include "ParallelFor.h"
+#include "FieldScanner.h"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+using namespace std;
+
+const char ZIP_INDEX_MAGIC[8] = {'Z', 'I', 'P', 'I', 'D', 'X', '\0', '\0'};
+
+/**
+ * @brief Create a closed index.
+ */
+ZipIndexFile::ZipIndexFile()
+{
+    header = nullptr;
+    entries = nullptr;
+}
+
+/**
+ * @brief Find every record of a length-indicated data file.
+ * @param data        The mapped data file.
+ * @param size        Its size in bytes.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ * @return One entry per record, in file order.
+ */
+vector<ZipIndexEntry> ZipIndexFile::scan(const char *data, size_t size, unsigned threadCount)
+{
+    // Cut the records after the header into chunks and split them in parallel.
+    // Merging the chunks in order keeps records with the same ZIP in file order.
+    size_t begin = nextLineStart(data, size, 0);
+    unsigned threads = workerCount(threadCount);
+    size_t chunkCount = (threads == 1) ? 1 : threads * 4;
+    vector<size_t> bounds = splitAtRecordBoundaries(data, size, begin, chunkCount);
+    vector<vector<ZipIndexEntry>> found(chunkCount);
+
+    parallelFor(chunkCount, threads, [&](size_t chunk)
+                {
+                    RecordTokenizer tokenizer(data, bounds[chunk], bounds[chunk + 1]);
+                    string_view fields[6];
+                    int count = 0;
+                    while (tokenizer.next(fields, 6, count))
+                    {
+                        int last = min(count, 6) - 1;
+                        const char *lineStart = fields[0].data();
+                        size_t lineLength = (fields[last].data() + fields[last].size()) - lineStart;
+                        size_t width = lengthPrefixWidth(lineStart, lineLength);
+                        int zip = 0;
+                        if (width == 0 || !parseInteger(fields[0].substr(width), zip))
+                        {
+                            continue;
+                        }
+                        found[chunk].push_back({zip, static_cast<uint32_t>(lineLength - width),
+                                                static_cast<uint64_t>(lineStart + width - data)});
+                    }
+                });
+
+    vector<ZipIndexEntry> entries;
+    for (const auto &chunk : found)
+    {
+        entries.insert(entries.end(), chunk.begin(), chunk.end());
+    }
+    return entries;
+}
+
+/**
+ * @brief Sort entries and write them as an index file.
+ * @param fileName The index file (replaced if it exists).
+ * @param entries  The entries in data-file order; sorted here.
+ * @param dataName The data file they point into, for isStale().
+ * @return true if the whole file was written.
+ */
+bool ZipIndexFile::write(const string &fileName, vector<ZipIndexEntry> entries, const string &dataName)
+{
+    stable_sort(entries.begin(), entries.end(), [](const ZipIndexEntry &a, const ZipIndexEntry &b)
+                {
+                    return a.zip < b.zip;
+                });
+
+    ZipIndexHeader head = {};
+    memcpy(head.magic, ZIP_INDEX_MAGIC, sizeof(head.magic));
+    head.version = ZIP_INDEX_VERSION;
+    head.entrySize = sizeof(ZipIndexEntry);
+    head.entryCount = entries.size();
+    if (!fileStamp(dataName, head.dataSize, head.dataModified))
+    {
+        head.dataSize = 0;
+        head.dataModified = -1;
+    }
+
+    return replaceFile(fileName, {string_view(reinterpret_cast<const char *>(&head), sizeof(head)),
+                                  string_view(reinterpret_cast<const char *>(entries.data()),
+                                              entries.size() * sizeof(ZipIndexEntry))});
+}
+
+/**
+ * @brief Map an index file and check its header.
+ * @param fileName The index file.
+ * @return true if it is a version-2 index whose size matches its entry count.
+ */
+bool ZipIndexFile::open(const string &fileName)
+{
+    close();
+    if (!file.open(fileName, AccessPattern::Random) || file.size() < sizeof(ZipIndexHeader))
+    {
+        close();
+        return false;
+    }
+
+    const ZipIndexHeader *head = reinterpret_cast<const ZipIndexHeader *>(file.data());
+    if (memcmp(head->magic, ZIP_INDEX_MAGIC, sizeof(head->magic)) != 0 ||
+        head->version != ZIP_INDEX_VERSION ||
+        head->entrySize != sizeof(ZipIndexEntry) ||
+        head->entryCount > (file.size() - sizeof(ZipIndexHeader)) / sizeof(ZipIndexEntry) ||
+        file.size() != sizeof(ZipIndexHeader) + head->entryCount * sizeof(ZipIndexEntry))
+    {
+        close();
+        return false;
+    }
+
+    header = head;
+    entries = reinterpret_cast<const ZipIndexEntry *>(file.data() + sizeof(ZipIndexHeader));
+    return true;
+}
+
+/**
+ * @brief Unmap the index.
+ */
+void ZipIndexFile::close()
+{
+    file.close();
+    header = nullptr;
+    entries = nullptr;
+}
+
+/**
+ * @brief Check whether an index is open.
+ * @return true after a successful open().
+ */
+bool ZipIndexFile::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Check whether the data file changed since the index was built.
+ * @param dataName The length-indicated data file.
+ * @return true if its size or modification time differ, or it cannot be read.
+ */
+bool ZipIndexFile::isStale(const string &dataName) const
+{
+    uint64_t dataSize;
+    int64_t modified;
+    if (!isOpen() || !fileStamp(dataName, dataSize, modified))
+    {
+        return true;
+    }
+    return dataSize != header->dataSize || modified != header->dataModified;
+}
+
+/**
+ * @brief Get the number of entries.
+ * @return The entry count (0 when closed).
+ */
+size_t ZipIndexFile::size() const
+{
+    return isOpen() ? header->entryCount : 0;
+}
+
+/**
+ * @brief Get the sorted entries.
+ * @return Pointer to size() entries (nullptr when closed).
+ */
+const ZipIndexEntry *ZipIndexFile::data() const
+{
+    return entries;
+}
+
+/**
+ * @brief Find the entry of a ZIP code.
+ * @param zip The ZIP code.
+ * @return The first entry with that ZIP code, or nullptr.
+ */
+const ZipIndexEntry *ZipIndexFile::find(int zip) const
+{
+    const ZipIndexEntry *last = entries + size();
+    const ZipIndexEntry *found = lower_bound(entries, last, zip, [](const ZipIndexEntry &entry, int key)
+                                             {
+                                                 return entry.zip < key;
+                                             });
+    return (found != last && found->zip == zip) ? found : nullptr;
+}
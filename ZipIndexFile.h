@@ -0,0 +1,145 @@
+/**
+ * @file ZipIndexFile.h
+ * @brief Defines the ZipIndexFile class, the sorted on-disk ZIP index used by make_index.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * The index maps each ZIP code to where its record sits in the
+ * length-indicated data file. It is a small header followed by fixed-width
+ * entries sorted by ZIP code, so a lookup maps the file and binary-searches
+ * the entries in place: nothing is read into memory first, and opening the
+ * index costs the same no matter how many entries it has.
+ *
+ * File layout (version 2, little-endian):
+ * - ZipIndexHeader: magic "ZIPIDX\0\0", version, entry size, entry count,
+ *   and the size and modification time of the data file it was built from.
+ * - entryCount ZipIndexEntry records (16 bytes each) sorted by ZIP code;
+ *   records with the same ZIP code keep their file order.
+ *
+ * Version 1 (the old indexfile.bin) was a list of (length byte, key,
+ * offset) entries whose keys still carried the record-length prefix.
+ * open() rejects it, so make_index rebuilds the index.
+ */
+
+#ifndef ZIP_INDEX_FILE_H
+#define ZIP_INDEX_FILE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+
+using namespace std;
+
+/**
+ * @brief One index entry: a ZIP code and the bytes of its record.
+ */
+struct ZipIndexEntry
+{
+    int32_t zip;     /**< The ZIP code as a number (501 for "00501") */
+    uint32_t length; /**< Record length in bytes, without the prefix and the line break */
+    uint64_t offset; /**< Offset of the record in the data file, just past its length prefix */
+};
+
+/**
+ * @brief The fixed header at the start of an index file.
+ */
+struct ZipIndexHeader
+{
+    char magic[8];        /**< "ZIPIDX\0\0" */
+    uint32_t version;     /**< ZIP_INDEX_VERSION */
+    uint32_t entrySize;   /**< sizeof(ZipIndexEntry) */
+    uint64_t entryCount;  /**< Number of entries */
+    uint64_t dataSize;    /**< Size of the data file the index was built from */
+    int64_t dataModified; /**< Its modification time (seconds since 1970) */
+};
+
+const uint32_t ZIP_INDEX_VERSION = 2;
+
+class ZipIndexFile
+{
+private:
+    MappedFile file;              /**< The mapped index */
+    const ZipIndexHeader *header; /**< Start of the mapping (nullptr when closed) */
+    const ZipIndexEntry *entries; /**< The sorted entries */
+
+public:
+    /**
+     * @brief Create a closed index.
+     */
+    ZipIndexFile();
+
+    ZipIndexFile(const ZipIndexFile &) = delete;
+    ZipIndexFile &operator=(const ZipIndexFile &) = delete;
+
+    /**
+     * @brief Find every record of a length-indicated data file.
+     * @param data        The mapped data file.
+     * @param size        Its size in bytes.
+     * @param threadCount Worker threads (0 = one per hardware thread).
+     * @return One entry per record, in file order; lines that do not parse are skipped.
+     * @note The key is the first field minus the record-length prefix ("42501" -> 501).
+     */
+    static vector<ZipIndexEntry> scan(const char *data, size_t size, unsigned threadCount = 0);
+
+    /**
+     * @brief Sort entries and write them as an index file.
+     * @param fileName The index file (replaced if it exists, see replaceFile()).
+     * @param entries  The entries in data-file order; sorted here.
+     * @param dataName The data file they point into, for isStale().
+     * @return true if the whole file was written.
+     */
+    static bool write(const string &fileName, vector<ZipIndexEntry> entries, const string &dataName);
+
+    /**
+     * @brief Map an index file and check its header.
+     * @param fileName The index file.
+     * @return true if it is a version-2 index whose size matches its entry count.
+     */
+    bool open(const string &fileName);
+
+    /**
+     * @brief Unmap the index.
+     */
+    void close();
+
+    /**
+     * @brief Check whether an index is open.
+     * @return true after a successful open().
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Check whether the data file changed since the index was built.
+     * @param dataName The length-indicated data file.
+     * @return true if its size or modification time differ from the recorded
+     * ones, or it cannot be read.
+     */
+    bool isStale(const string &dataName) const;
+
+    /**
+     * @brief Get the number of entries.
+     * @return The entry count (0 when closed).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the sorted entries.
+     * @return Pointer to size() entries (nullptr when closed).
+     */
+    const ZipIndexEntry *data() const;
+
+    /**
+     * @brief Find the entry of a ZIP code.
+     * @param zip The ZIP code.
+     * @return The first entry with that ZIP code, or nullptr.
+     * @note Binary search over the mapped entries: O(log N) and nothing is loaded.
+     */
+    const ZipIndexEntry *find(int zip) const;
+};
+
+#include "ZipIndexFile.cpp"
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file ZipTable.cpp
+ * @brief Implementation of the ZipTable class.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * @version 1.0
+ * @date 2025-10-16
+ */
+
+#include "ZipTable.h"
+
+using namespace std;
+
+/**
+ * @brief Record the row of a ZIP code.
+ * @param zip The key.
+ * @param row The row that holds it.
+ */
+void ZipTable::insert(int zip, int row)
+{
+    if (zip >= 0 && zip < DENSE_LIMIT)
+    {
+        // The array is only allocated once a 5-digit key shows up
+        if (dense.empty())
+        {
+            dense.assign(DENSE_LIMIT, -1);
+        }
+        if (dense[zip] < 0)
+        {
+            dense[zip] = row;
+        }
+        return;
+    }
+    sparse.emplace(zip, row); // keeps the existing row if the key is there
+}
+
+/**
+ * @brief Look up the row of a ZIP code.
+ * @param zip The key.
+ * @return The row, or -1 if the key was never inserted.
+ */
+int ZipTable::find(int zip) const
+{
+    if (zip >= 0 && zip < DENSE_LIMIT)
+    {
+        return dense.empty() ? -1 : dense[zip];
+    }
+    auto found = sparse.find(zip);
+    return (found == sparse.end()) ? -1 : found->second;
+}
+
+/**
+ * @brief Remove every key.
+ */
+void ZipTable::clear()
+{
+    vector<int32_t>().swap(dense);
+    sparse.clear();
+}
+
+/**
+ * @brief Get the number of keys stored in the hash map.
+ * @return Keys outside the dense range.
+ */
+size_t ZipTable::sparseSize() const
+{
+    return sparse.size();
+}
+
+/**
+ * @brief Estimate the memory the table uses.
+ * @return Bytes of heap memory for the array and the hash map.
+ */
+size_t ZipTable::memoryBytes() const
+{
+    // Each hash node holds the key, the row and a next pointer, plus one bucket pointer
+    return dense.capacity() * sizeof(int32_t) +
+           sparse.size() * (sizeof(void *) + sizeof(int) + sizeof(int32_t) + sizeof(size_t)) +
+           sparse.bucket_count() * sizeof(void *);
+}
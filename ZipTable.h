@@ -0,0 +1,72 @@
+/**
+ * @file ZipTable.h
+ * @brief Defines the ZipTable class, a constant-time ZIP code to row lookup.
+ * @author
+ *  Asfaw, Abel,
+ *  Farah, Mahad,
+ *  Kariniemi, Carson,
+ *  Rogers, Mitchell
+ *  Tran, Minh Quan
+ * Five-digit ZIP codes fit in 0-99999, so the table is a plain array with one
+ * slot per possible ZIP code (direct addressing): a lookup is one array read.
+ * Keys outside that range, such as ZIP+4 codes stored as 9-digit numbers,
+ * go to a hash map instead.
+ */
+
+#ifndef ZIP_TABLE_H
+#define ZIP_TABLE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+class ZipTable
+{
+private:
+    vector<int32_t> dense;              /**< Row of each 5-digit ZIP code, -1 if absent */
+    unordered_map<int, int32_t> sparse; /**< Row of each key outside the dense range */
+
+public:
+    static const int DENSE_LIMIT = 100000; /**< Keys 0 .. DENSE_LIMIT-1 use the array */
+
+    ZipTable() = default;
+
+    /**
+     * @brief Record the row of a ZIP code.
+     * @param zip The key.
+     * @param row The row that holds it.
+     * @note If the key is already present the first row is kept, matching a
+     * front-to-back linear search.
+     */
+    void insert(int zip, int row);
+
+    /**
+     * @brief Look up the row of a ZIP code.
+     * @param zip The key.
+     * @return The row, or -1 if the key was never inserted.
+     */
+    int find(int zip) const;
+
+    /**
+     * @brief Remove every key.
+     * @note The dense array is released too.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of keys stored in the hash map.
+     * @return Keys outside the dense range.
+     */
+    size_t sparseSize() const;
+
+    /**
+     * @brief Estimate the memory the table uses.
+     * @return Bytes of heap memory for the array and the hash map.
+     */
+    size_t memoryBytes() const;
+};
+
+#include "ZipTable.cpp"
+#endif
@@ -0,0 +1,2106 @@
+/**
+ * @file benchmark.cpp
+ * @brief Timing driver for the postal code loaders and lookups.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Each benchmark runs the operation several times and reports the best and the
+ * average wall time, so one slow run (cold cache, scheduler noise) does not
+ * decide the result. Run it from the folder that holds the CSV files.
+ *
+ * Usage: benchmark [csvFile] [lengthIndicatedFile] [repeats]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include <chrono>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <set>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "SpatialIndex.h"
+#include "DistanceMatrix.h"
+#include "PostalSnapshot.h"
+#include "ZipIndexFile.h"
+#include "ZipHashIndex.h"
+#include "RecordBatch.h"
+#include "PostalBlockFile.h"
+#include "LiveDataset.h"
+#include "ParallelFor.h"
+#include "OrderBy.h"
+#include "Metrics.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+/** Heap allocations made so far by the whole program, counted by the operator new below */
+atomic<size_t> allocationCount(0);
+
+/**
+ * @brief Count every heap allocation, so benchmarks can report how many a path makes.
+ * @param size Bytes requested.
+ * @return The allocated block.
+ */
+void *operator new(size_t size)
+{
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void *block = malloc(size ? size : 1);
+    if (block == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return block;
+}
+
+// GCC cannot see that these blocks come from the malloc above and warns about the free
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+/**
+ * @brief Release a block from the counting operator new.
+ * @param block The block.
+ */
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+/**
+ * @brief Release a block from the counting operator new (sized form).
+ * @param block The block.
+ */
+void operator delete(void *block, size_t) noexcept
+{
+    free(block);
+}
+
+/**
+ * @brief Best and average time of a repeated benchmark, in milliseconds.
+ */
+struct Timing
+{
+    double best;    /**< Fastest run */
+    double average; /**< Mean over all runs */
+};
+
+/**
+ * @brief Run a function @p repeats times and time each run.
+ * @param repeats How many times to run it.
+ * @param body    The work to time.
+ * @return The best and average run time in milliseconds.
+ */
+Timing timeRuns(int repeats, const function<void()> &body)
+{
+    Timing timing = {1e300, 0};
+    for (int i = 0; i < repeats; i++)
+    {
+        auto start = chrono::steady_clock::now();
+        body();
+        chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - start;
+        timing.best = min(timing.best, elapsed.count());
+        timing.average += elapsed.count() / repeats;
+    }
+    return timing;
+}
+
+/**
+ * @brief Print one benchmark result line.
+ * @param name   What was measured.
+ * @param timing The measured times.
+ */
+void printTiming(const string &name, const Timing &timing)
+{
+    cout << left << setw(36) << name
+         << "best " << setw(10) << timing.best
+         << "avg " << setw(10) << timing.average << " ms" << endl;
+}
+
+/**
+ * @brief Check that two lists hold the same items in the same order.
+ * @param a The first list.
+ * @param b The second list.
+ * @return true if every field of every item matches.
+ */
+bool sameItems(const PostalList &a, const PostalList &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (int i = 0; i < a.size(); i++)
+    {
+        const PostalCodeItem &x = a.getItem(i);
+        const PostalCodeItem &y = b.getItem(i);
+        if (x.getZip() != y.getZip() || x.getPlaceView() != y.getPlaceView() ||
+            x.getStateView() != y.getStateView() || x.getCountyView() != y.getCountyView() ||
+            x.getLatitude() != y.getLatitude() || x.getLongitude() != y.getLongitude())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Compare the getline loader with the memory-mapped loader.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many loads to time for each loader.
+ */
+void benchmarkLoaders(const string &fileName, int repeats)
+{
+    PostalList streamList;
+    PostalList mappedList;
+    inputCSVtoListStream(streamList, fileName);
+    inputCSVtoList(mappedList, fileName);
+
+    cout << "Loading " << fileName << " (" << mappedList.size() << " rows, "
+         << (sameItems(streamList, mappedList) ? "loaders agree" : "LOADERS DISAGREE") << ")" << endl;
+
+    Timing stream = timeRuns(repeats, [&]()
+                             {
+                                 PostalList list;
+                                 inputCSVtoListStream(list, fileName);
+                             });
+    Timing mapped = timeRuns(repeats, [&]()
+                             {
+                                 PostalList list;
+                                 inputCSVtoList(list, fileName);
+                             });
+
+    printTiming("inputCSVtoListStream (getline)", stream);
+    printTiming("inputCSVtoList (mapped)", mapped);
+    cout << "Speedup (best): " << stream.best / mapped.best << "x" << endl
+         << endl;
+}
+
+/**
+ * @brief Time the parallel loaders at 1, 2, 4, ... threads.
+ * @param fileName       The CSV file to load.
+ * @param indicatedFile  The length-indicated twin of @p fileName.
+ * @param repeats        How many loads to time for each setting.
+ */
+void benchmarkParallelLoaders(const string &fileName, const string &indicatedFile, int repeats)
+{
+    PostalList reference;
+    inputCSVtoList(reference, fileName);
+
+    unsigned maxThreads = max(workerCount(0), 4u);
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        PostalList csvList;
+        PostalList indicatedList;
+        inputCSVtoListParallel(csvList, fileName, threads);
+        inputLengthIndicatedToList(indicatedList, indicatedFile, threads);
+        bool agree = sameItems(reference, csvList) && sameItems(reference, indicatedList);
+
+        Timing csv = timeRuns(repeats, [&]()
+                              {
+                                  PostalList list;
+                                  inputCSVtoListParallel(list, fileName, threads);
+                              });
+        Timing indicated = timeRuns(repeats, [&]()
+                                    {
+                                        PostalList list;
+                                        inputLengthIndicatedToList(list, indicatedFile, threads);
+                                    });
+
+        cout << threads << " thread(s)" << (agree ? "" : " (RESULTS DISAGREE)") << endl;
+        printTiming("  inputCSVtoListParallel", csv);
+        printTiming("  inputLengthIndicatedToList", indicated);
+    }
+    cout << "(" << workerCount(0) << " hardware thread(s) on this machine)" << endl
+         << endl;
+}
+
+/**
+ * @brief Measure the delimiter scanner, the tokenizer and the number parsers in bytes per second.
+ * @param fileName The file to scan.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkTokenizer(const string &fileName, int repeats)
+{
+    MappedFile file(fileName);
+    if (!file.isOpen())
+    {
+        return;
+    }
+    const char *data = file.data();
+    size_t size = file.size();
+    double megabytes = size / (1024.0 * 1024.0);
+    const size_t blockSize = 64 * 1024;
+    vector<uint32_t> marks(blockSize);
+
+    cout << "Scanning " << fileName << " (" << size << " bytes)" << endl;
+    ScanPath paths[] = {ScanPath::Scalar, ScanPath::SSE2, ScanPath::AVX2};
+    for (ScanPath path : paths)
+    {
+        if (path > bestScanPath())
+        {
+            continue;
+        }
+        size_t found = 0;
+        Timing timing = timeRuns(repeats, [&]()
+                                 {
+                                     found = 0;
+                                     for (size_t at = 0; at < size; at += blockSize)
+                                     {
+                                         found += scanDelimiters(data + at, min(blockSize, size - at), marks.data(), path);
+                                     }
+                                 });
+        cout << left << setw(36) << (string("scanDelimiters (") + scanPathName(path) + ")")
+             << setw(10) << megabytes / (timing.best / 1000) << " MB/s  (" << found << " delimiters)" << endl;
+    }
+
+    string_view fields[6];
+    int fieldCount = 0;
+    vector<string_view> latitudes;
+    Timing split = timeRuns(repeats, [&]()
+                            {
+                                latitudes.clear();
+                                RecordTokenizer tokenizer(data, 0, size);
+                                while (tokenizer.next(fields, 6, fieldCount))
+                                {
+                                    latitudes.push_back(fields[4]);
+                                }
+                            });
+    cout << left << setw(36) << "RecordTokenizer (all fields)"
+         << setw(10) << megabytes / (split.best / 1000) << " MB/s" << endl;
+
+    // Number parsing on the real latitude column (the header row fails both ways)
+    size_t latitudeBytes = 0;
+    for (const auto &field : latitudes)
+    {
+        latitudeBytes += field.size();
+    }
+    double numberMegabytes = latitudeBytes / (1024.0 * 1024.0);
+    double sink = 0;
+    Timing fast = timeRuns(repeats, [&]()
+                           {
+                               double value = 0;
+                               for (const auto &field : latitudes)
+                               {
+                                   if (parseDecimal(field, value))
+                                   {
+                                       sink += value;
+                                   }
+                               }
+                           });
+    Timing slow = timeRuns(repeats, [&]()
+                           {
+                               for (const auto &field : latitudes)
+                               {
+                                   try
+                                   {
+                                       sink += stod(string(field));
+                                   }
+                                   catch (const exception &)
+                                   {
+                                   }
+                               }
+                           });
+    cout << left << setw(36) << "parseDecimal"
+         << setw(10) << numberMegabytes / (fast.best / 1000) << " MB/s" << endl;
+    cout << left << setw(36) << "stod(string(field))"
+         << setw(10) << numberMegabytes / (slow.best / 1000) << " MB/s" << endl;
+    cout << "(checksum " << sink << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Compare the item layout with the columnar layout: memory and a ZIP-only scan.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many scans to time.
+ */
+void benchmarkColumns(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const PostalColumns &columns = list.getColumns();
+
+    size_t itemBytes = list.itemMemoryBytes();
+    size_t columnBytes = columns.memoryBytes();
+    cout << "Memory for " << list.size() << " rows:" << endl;
+    cout << left << setw(36) << "  PostalCodeItem vector" << itemBytes << " bytes ("
+         << static_cast<double>(itemBytes) / list.size() << " per row)" << endl;
+    cout << left << setw(36) << "  PostalColumns" << columnBytes << " bytes ("
+         << static_cast<double>(columnBytes) / list.size() << " per row, "
+         << columns.stateDictionary().size() << " states, "
+         << columns.countyDictionary().size() << " counties, "
+         << columns.placeDictionary().size() << " places)" << endl;
+
+    // Count the rows in a ZIP range, once through the items and once through the ZIP column
+    long long count = 0;
+    Timing rowScan = timeRuns(repeats, [&]()
+                              {
+                                  for (int i = 0; i < list.size(); i++)
+                                  {
+                                      PostalCodeItem item = list.getItem(i);
+                                      count += (item.getZip() >= 55000 && item.getZip() <= 55999);
+                                  }
+                              });
+    Timing columnScan = timeRuns(repeats, [&]()
+                                 {
+                                     const int32_t *zips = columns.zipData();
+                                     for (size_t i = 0; i < columns.size(); i++)
+                                     {
+                                         count += (zips[i] >= 55000 && zips[i] <= 55999);
+                                     }
+                                 });
+    printTiming("  ZIP range count via getItem()", rowScan);
+    printTiming("  ZIP range count via zip column", columnScan);
+    cout << "(checksum " << count << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Build a larger list from a real one by adding ZIP+4 style keys.
+ *
+ * The real rows come first with their 5-digit codes. The rest repeat the
+ * real rows with keys zip * 10000 + n, like ZIP+4 codes stored as numbers,
+ * which all land in the hashed part of the ZIP table.
+ *
+ * @param source The real list.
+ * @param rows   How many rows the result should have.
+ * @param out    Receives the rows.
+ */
+void makeScaledList(const PostalList &source, size_t rows, PostalList &out)
+{
+    size_t n = source.size();
+    for (size_t i = 0; i < rows; i++)
+    {
+        PostalCodeItem item = source.getItem(static_cast<int>(i % n));
+        if (i >= n)
+        {
+            item.setZip(item.getZip() * 10000 + static_cast<int>(i / n));
+        }
+        out.addItem(item);
+    }
+}
+
+/**
+ * @brief Compare findByZip with the ZIP table against the linear search.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkZipLookup(const string &fileName, int repeats)
+{
+    PostalList real;
+    inputCSVtoList(real, fileName);
+
+    for (size_t rows : {static_cast<size_t>(real.size()), static_cast<size_t>(1000000)})
+    {
+        PostalList list;
+        if (rows == static_cast<size_t>(real.size()))
+        {
+            inputCSVtoList(list, fileName);
+        }
+        else
+        {
+            makeScaledList(real, rows, list);
+        }
+
+        // Half of the keys are present, half are misses
+        vector<int> keys;
+        for (size_t i = 0; i < 20000; i++)
+        {
+            size_t row = (i * 7919) % rows;
+            int zip = list.getColumns().zipData()[row];
+            keys.push_back((i % 2 == 0) ? zip : -zip - 1);
+        }
+
+        long long found = 0;
+        Timing table = timeRuns(repeats, [&]()
+                                {
+                                    for (int zip : keys)
+                                    {
+                                        found += (list.findByZip(zip) != nullptr);
+                                    }
+                                });
+
+        // The linear search is far slower, so it gets fewer keys
+        list.setZipTableEnabled(false);
+        size_t linearKeys = (rows > 100000) ? 200 : 2000;
+        Timing linear = timeRuns(max(1, repeats / 5), [&]()
+                                 {
+                                     for (size_t i = 0; i < linearKeys; i++)
+                                     {
+                                         found += (list.findByZip(keys[i]) != nullptr);
+                                     }
+                                 });
+        list.setZipTableEnabled(true);
+
+        double tableNs = table.best * 1e6 / keys.size();
+        double linearNs = linear.best * 1e6 / linearKeys;
+        cout << "findByZip over " << rows << " rows (50% hits):" << endl;
+        cout << left << setw(36) << "  ZIP table" << setw(10) << tableNs << " ns/lookup" << endl;
+        cout << left << setw(36) << "  linear search" << setw(10) << linearNs << " ns/lookup ("
+             << linearNs / tableNs << "x slower)" << endl;
+        (void)found;
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Measure what the Metrics hooks cost on loads and ZIP lookups, switched off and on.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many runs to time.
+ */
+void benchmarkMetrics(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    vector<int> keys;
+    for (int i = 0; i < 100000; i++)
+    {
+        int zip = list.getColumns().zipData()[(i * 7919) % list.size()];
+        keys.push_back((i % 2 == 0) ? zip : zip + 100000);
+    }
+
+    long long found = 0;
+    auto lookups = [&]()
+    {
+        for (int zip : keys)
+        {
+            found += (list.findByZip(zip) != nullptr);
+        }
+    };
+    auto load = [&]()
+    {
+        PostalList fresh;
+        inputCSVtoList(fresh, fileName);
+        found += fresh.size();
+    };
+
+    Metrics::enable(false);
+    Timing lookupsOff = timeRuns(repeats, lookups);
+    Timing loadOff = timeRuns(max(1, repeats / 4), load);
+    Metrics::enable(true);
+    Timing lookupsOn = timeRuns(repeats, lookups);
+    Timing loadOn = timeRuns(max(1, repeats / 4), load);
+    Metrics::enable(false);
+    Metrics::reset();
+
+    cout << "Metrics hooks (off / on):" << endl;
+    cout << left << setw(36) << "  findByZip, 50% hits" << lookupsOff.best * 1e6 / keys.size() << " / "
+         << lookupsOn.best * 1e6 / keys.size() << " ns/lookup" << endl;
+    cout << left << setw(36) << "  inputCSVtoList" << loadOff.best << " / " << loadOn.best << " ms" << endl
+         << endl;
+    (void)found;
+}
+
+/**
+ * @brief Compare make_index's old load-everything index with the mapped sorted index, per startup.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many startups to time.
+ * @note Writes scratch index files next to the CSV files and removes them afterwards.
+ */
+void benchmarkIndexFile(const string &fileName, int repeats)
+{
+    PostalList real;
+    inputCSVtoList(real, fileName);
+    const string oldScratch = "benchmark_index_v1.tmp";
+    const string newScratch = "benchmark_index_v2.tmp";
+
+    cout << "make_index startup + one lookup (old: read all into unordered_map, new: map + binary search):" << endl;
+    for (size_t rows : {static_cast<size_t>(real.size()), static_cast<size_t>(1000000)})
+    {
+        PostalList list;
+        makeScaledList(real, rows, list);
+        const int32_t *zips = list.getColumns().zipData();
+
+        // Version 1: length byte, key, 8-byte offset per entry
+        vector<ZipIndexEntry> entries;
+        {
+            ofstream old(oldScratch, ios::binary);
+            for (size_t i = 0; i < rows; i++)
+            {
+                string key = to_string(zips[i]);
+                uint8_t length = static_cast<uint8_t>(key.size());
+                uint64_t offset = i;
+                old.write(reinterpret_cast<const char *>(&length), 1);
+                old.write(key.data(), length);
+                old.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+                entries.push_back({zips[i], 0, offset});
+            }
+        }
+        ZipIndexFile::write(newScratch, entries, fileName);
+        int probe = zips[rows / 2];
+
+        long long total = 0;
+        Timing loaded = timeRuns(max(1, repeats / 5), [&]()
+                                 {
+                                     unordered_map<string, uint64_t> index;
+                                     ifstream in(oldScratch, ios::binary);
+                                     uint8_t length;
+                                     while (in.read(reinterpret_cast<char *>(&length), 1))
+                                     {
+                                         string key(length, '\0');
+                                         uint64_t offset;
+                                         in.read(&key[0], length);
+                                         in.read(reinterpret_cast<char *>(&offset), sizeof(offset));
+                                         index[key] = offset;
+                                     }
+                                     total += index[to_string(probe)];
+                                 });
+        Timing mapped = timeRuns(repeats, [&]()
+                                 {
+                                     ZipIndexFile index;
+                                     index.open(newScratch);
+                                     const ZipIndexEntry *entry = index.find(probe);
+                                     total += (entry != nullptr) ? entry->offset : 0;
+                                 });
+
+        cout << "  " << rows << " entries (checksum " << total << ")" << endl;
+        printTiming("    old format", loaded);
+        printTiming("    sorted fixed-width, mapped", mapped);
+    }
+    remove(oldScratch.c_str());
+    remove(newScratch.c_str());
+    cout << endl;
+}
+
+/**
+ * @brief Compare ZIP lookups through a hash table, the sorted index and the minimal perfect hash, and their sizes.
+ * @param indicatedFile The length-indicated file to index.
+ * @param repeats       How many passes to time.
+ * @note Writes scratch index files next to the data file and removes them afterwards.
+ */
+void benchmarkHashIndex(const string &indicatedFile, int repeats)
+{
+    MappedFile data(indicatedFile, AccessPattern::Random);
+    if (!data.isOpen())
+    {
+        cout << "Skipping hash index benchmark: cannot open " << indicatedFile << endl
+             << endl;
+        return;
+    }
+    const string sortedScratch = "benchmark_index_sorted.tmp";
+    const string hashScratch = "benchmark_index_mph.tmp";
+
+    vector<ZipIndexEntry> entries = ZipIndexFile::scan(data.data(), data.size());
+    ZipIndexFile::write(sortedScratch, entries, indicatedFile);
+    Timing build = timeRuns(1, [&]()
+                            {
+                                ZipHashIndex::write(hashScratch, entries, indicatedFile);
+                            });
+    ZipIndexFile sorted;
+    ZipHashIndex hashed;
+    sorted.open(sortedScratch);
+    hashed.open(hashScratch);
+    unordered_map<int, uint64_t> table;
+    size_t oldBytes = 0; // length byte, key text, 8-byte offset
+    for (const auto &entry : entries)
+    {
+        table.emplace(entry.zip, entry.offset);
+        oldBytes += 1 + to_string(entry.zip).size() + sizeof(uint64_t);
+    }
+
+    // Every ZIP must come back with its first record; misses must be rejected
+    size_t wrong = 0;
+    for (const auto &entry : entries)
+    {
+        uint64_t offset = hashed.find(entry.zip);
+        if (offset != table[entry.zip] || sorted.find(entry.zip)->offset != offset)
+        {
+            wrong++;
+        }
+    }
+
+    // Half hits, half ZIP codes that are not in the file
+    vector<int> probes;
+    for (int zip = 0; zip < 100000; zip += 2)
+    {
+        probes.push_back(zip);
+    }
+    size_t misses = 0;
+    auto hashRecord = [&](int zip)
+    {
+        uint64_t offset = hashed.find(zip);
+        string_view record = (offset < data.size()) ? string_view(data.data() + offset, min<size_t>(16, data.size() - offset)) : string_view();
+        return ZipHashIndex::matches(record, zip) ? offset : 0;
+    };
+    for (int zip : probes)
+    {
+        misses += (table.count(zip) == 0);
+        if ((hashRecord(zip) != 0) != (table.count(zip) != 0))
+        {
+            wrong++;
+        }
+    }
+
+    uint64_t total = 0;
+    Timing mapTime = timeRuns(repeats, [&]()
+                              {
+                                  for (int zip : probes)
+                                  {
+                                      auto found = table.find(zip);
+                                      total += (found != table.end()) ? found->second : 0;
+                                  }
+                              });
+    Timing sortedTime = timeRuns(repeats, [&]()
+                                 {
+                                     for (int zip : probes)
+                                     {
+                                         const ZipIndexEntry *entry = sorted.find(zip);
+                                         total += (entry != nullptr) ? entry->offset : 0;
+                                     }
+                                 });
+    Timing hashTime = timeRuns(repeats, [&]()
+                               {
+                                   for (int zip : probes)
+                                   {
+                                       total += hashRecord(zip);
+                                   }
+                               });
+
+    size_t keys = hashed.size();
+    cout << "make_index lookups, " << probes.size() << " ZIP codes (" << misses << " misses), "
+         << keys << " keys:" << endl;
+    printTiming("  build minimal perfect hash", build);
+    printTiming("  unordered_map<int, offset>", mapTime);
+    printTiming("  sorted index, binary search", sortedTime);
+    printTiming("  perfect hash + record check", hashTime);
+    cout << "  bytes per key: old format " << double(oldBytes) / keys
+         << ", sorted " << double(sorted.size() * sizeof(ZipIndexEntry) + sizeof(ZipIndexHeader)) / keys
+         << ", perfect hash " << double(hashed.fileBytes()) / keys << endl;
+    cout << "  wrong lookups: " << wrong << " (checksum " << total << ")" << endl
+         << endl;
+
+    sorted.close();
+    hashed.close();
+    remove(sortedScratch.c_str());
+    remove(hashScratch.c_str());
+}
+
+/**
+ * @brief Compare fetching many records one by one, as make_index used to, with one RecordBatch.
+ * @param indicatedFile The length-indicated file to read.
+ * @param repeats       How many passes to time.
+ */
+void benchmarkBatchFetch(const string &indicatedFile, int repeats)
+{
+    MappedFile data(indicatedFile, AccessPattern::Random);
+    if (!data.isOpen())
+    {
+        cout << "Skipping batch fetch benchmark: cannot open " << indicatedFile << endl
+             << endl;
+        return;
+    }
+    vector<ZipIndexEntry> entries = ZipIndexFile::scan(data.data(), data.size());
+
+    // 100k requests in scattered order; every tenth one is not in the file
+    vector<ZipIndexEntry> requests;
+    for (size_t i = 0; i < 100000; i++)
+    {
+        if (i % 10 == 9)
+        {
+            requests.push_back({0, 0, RecordBatch::MISSING});
+        }
+        else
+        {
+            requests.push_back(entries[(i * 7919) % entries.size()]);
+        }
+    }
+
+    // Old way: seek to each record, read its line and split it into strings
+    size_t total = 0;
+    Timing oneByOne = timeRuns(max(1, repeats / 5), [&]()
+                               {
+                                   ifstream in(indicatedFile, ios::binary);
+                                   string line;
+                                   for (const auto &request : requests)
+                                   {
+                                       if (request.offset == RecordBatch::MISSING)
+                                       {
+                                           continue;
+                                       }
+                                       in.seekg(request.offset);
+                                       getline(in, line);
+                                       vector<string> fields;
+                                       stringstream fieldStream(line);
+                                       string field;
+                                       while (getline(fieldStream, field, ','))
+                                       {
+                                           fields.push_back(field);
+                                       }
+                                       total += fields.size();
+                                   }
+                               });
+    RecordBatch batch;
+    Timing batched = timeRuns(repeats, [&]()
+                              {
+                                  batch.fetch(data, requests);
+                                  for (size_t i = 0; i < batch.size(); i++)
+                                  {
+                                      total += batch.record(i).size();
+                                  }
+                              });
+
+    // The batch must give back exactly each request's bytes, in request order
+    size_t wrong = 0;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        string_view expected;
+        if (requests[i].offset != RecordBatch::MISSING)
+        {
+            expected = string_view(data.data() + requests[i].offset, requests[i].length);
+        }
+        if (batch.found(i) != (requests[i].offset != RecordBatch::MISSING) || batch.record(i) != expected)
+        {
+            wrong++;
+        }
+    }
+
+    cout << "Fetch " << requests.size() << " records in scattered order (" << batch.runCount() << " runs read):" << endl;
+    printTiming("  seekg + getline + split per ZIP", oneByOne);
+    printTiming("  RecordBatch, in file order", batched);
+    cout << "  wrong records: " << wrong << " (checksum " << total << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Ask the kernel to forget its cached copy of a file, so the next read comes from disk.
+ * @param fileName The file.
+ * @return false where that is not supported.
+ */
+bool dropFromPageCache(const string &fileName)
+{
+#ifndef _WIN32
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool dropped = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+    ::close(fd);
+    return dropped;
+#else
+    (void)fileName;
+    return false;
+#endif
+}
+
+/**
+ * @brief Compare the block file with the length-indicated text: size, point lookups and full scans.
+ * @param indicatedFile The length-indicated file to convert.
+ * @param repeats       How many passes to time.
+ * @return false if the block file did not read back intact.
+ * @note Writes a scratch block file next to the data file and removes it afterwards.
+ */
+bool benchmarkBlockFile(const string &indicatedFile, int repeats)
+{
+    PostalList list;
+    inputLengthIndicatedToList(list, indicatedFile);
+    if (list.size() == 0)
+    {
+        cout << "Skipping block file benchmark: no records in " << indicatedFile << endl
+             << endl;
+        return true;
+    }
+    const string scratch = "benchmark_blocks.tmp";
+    Timing build = timeRuns(1, [&]()
+                            {
+                                PostalBlockFile::write(scratch, list);
+                            });
+    PostalBlockFile blocks;
+    blocks.open(scratch);
+    MappedFile text(indicatedFile);
+
+    // Every 41st ZIP code, plus as many that are not in the file
+    vector<int> probes;
+    ItemRange byZip = list.sortedByZip();
+    for (size_t i = 0; i < byZip.size(); i += 41)
+    {
+        probes.push_back(byZip[i].getZip());
+        probes.push_back(byZip[i].getZip() + 100000);
+    }
+    size_t hits = 0;
+    PostalCodeItem item;
+    Timing lookups = timeRuns(repeats, [&]()
+                              {
+                                  hits = 0;
+                                  for (int zip : probes)
+                                  {
+                                      hits += blocks.find(zip, item);
+                                  }
+                              });
+
+    // Full scans, warm and then with both files dropped from the page cache first
+    double total = 0;
+    auto scanText = [&]()
+    {
+        MappedFile file(indicatedFile);
+        parseLengthIndicatedLines(file.data(), nextLineStart(file.data(), file.size(), 0), file.size(),
+                                  [&](const PostalCodeItem &found)
+                                  {
+                                      total += found.getLatitude();
+                                  });
+    };
+    auto scanBlocks = [&]()
+    {
+        PostalBlockFile file;
+        file.open(scratch);
+        file.scan([&](const BlockRow &row)
+                  {
+                      total += row.latitude;
+                  });
+    };
+    auto coldRuns = [&](const function<void()> &body)
+    {
+        Timing cold = {1e300, 0};
+        for (int i = 0; i < max(1, repeats / 5); i++)
+        {
+            dropFromPageCache(indicatedFile);
+            dropFromPageCache(scratch);
+            Timing once = timeRuns(1, body);
+            cold.best = min(cold.best, once.best);
+            cold.average += once.best / max(1, repeats / 5);
+        }
+        return cold;
+    };
+    int loaded = 0;
+    Timing load = timeRuns(repeats, [&]()
+                           {
+                               PostalList reloaded;
+                               loaded = blocks.addTo(reloaded);
+                           });
+    Timing warmText = timeRuns(repeats, scanText);
+    Timing warmBlocks = timeRuns(repeats, scanBlocks);
+    Timing coldText = coldRuns(scanText);
+    Timing coldBlocks = coldRuns(scanBlocks);
+
+    cout << "Block file: " << blocks.size() << " records in " << blocks.blockCount() << " blocks, "
+         << blocks.fileBytes() << " bytes vs " << text.size() << " bytes of text ("
+         << double(text.size()) / blocks.fileBytes() << "x smaller)" << endl;
+    printTiming("  write block file", build);
+    cout << "  " << probes.size() << " point lookups (" << hits << " hits), one block each:" << endl;
+    printTiming("    PostalBlockFile::find", lookups);
+    cout << "  load into a list (" << loaded << " records" << (loaded == list.size() ? "" : ", WRONG") << "):" << endl;
+    printTiming("    PostalBlockFile::addTo", load);
+    cout << "  full scan (checksum " << total << "):" << endl;
+    printTiming("    text, warm cache", warmText);
+    printTiming("    blocks, warm cache", warmBlocks);
+    printTiming("    text, cold cache", coldText);
+    printTiming("    blocks, cold cache", coldBlocks);
+
+    // Coordinates with 8 or 9 decimals give scaled deltas wider than 32 bits
+    bool exact = true;
+    for (double digits : {1e8, 1e9})
+    {
+        PostalList precise;
+        precise.addItem(PostalCodeItem(10001, "New York", "NY", "New York", 40.12345678, -73.04512345));
+        precise.addItem(PostalCodeItem(10002, "New York", "NY", "New York", -4012345678 / digits, 17304512345 / digits));
+        blocks.close();
+        exact = exact && PostalBlockFile::write(scratch, precise) && blocks.open(scratch) && blocks.size() == 2;
+        size_t row = 0;
+        bool same = true;
+        exact = exact && blocks.scan([&](const BlockRow &found)
+                                     {
+                                         const PostalCodeItem &item = precise.getItem(static_cast<int>(row++));
+                                         same = same && found.latitude == item.getLatitude() &&
+                                                found.longitude == item.getLongitude();
+                                     }) &&
+                same;
+    }
+    cout << "  8 and 9 decimal coordinates read back " << (exact ? "exactly" : "WRONG") << endl
+         << endl;
+
+    blocks.close();
+    remove(scratch.c_str());
+    return loaded == list.size() && exact;
+}
+
+/**
+ * @brief Compare ZIP range queries on the sorted index with a full scan.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkZipRange(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+
+    Timing build = timeRuns(1, [&]()
+                            {
+                                list.sortedByZip(); // first query builds the index
+                            });
+
+    long long total = 0;
+    Timing indexed = timeRuns(repeats, [&]()
+                              {
+                                  for (int low = 0; low < 100000; low += 1000)
+                                  {
+                                      for (const auto &item : list.findZipRange(low, low + 999))
+                                      {
+                                          total += item.getZip();
+                                      }
+                                  }
+                              });
+    Timing scanned = timeRuns(repeats, [&]()
+                              {
+                                  const int32_t *zips = list.getColumns().zipData();
+                                  for (int low = 0; low < 100000; low += 1000)
+                                  {
+                                      for (int i = 0; i < list.size(); i++)
+                                      {
+                                          if (zips[i] >= low && zips[i] <= low + 999)
+                                          {
+                                              total += zips[i];
+                                          }
+                                      }
+                                  }
+                              });
+
+    cout << "100 ZIP range queries (" << list.findByPrefix("554").size() << " rows match prefix 554):" << endl;
+    printTiming("  build sorted ZIP index", build);
+    printTiming("  findZipRange", indexed);
+    printTiming("  full scan of the ZIP column", scanned);
+    cout << "(checksum " << total << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Compare state and county lookups on the posting lists with a full scan.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkPostings(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const PostalColumns &columns = list.getColumns();
+    const string scratch = "benchmark_postings.tmp";
+    list.saveSnapshot(scratch, fileName);
+    PostalSnapshot snapshot;
+    snapshot.open(scratch);
+
+    // Every (state, county) pair once
+    vector<pair<string, string>> queries;
+    set<pair<uint32_t, uint32_t>> seen;
+    for (size_t row = 0; row < columns.size(); row++)
+    {
+        if (seen.insert({columns.stateIdData()[row], columns.countyIdData()[row]}).second)
+        {
+            queries.push_back({string(columns.state(row)), string(columns.county(row))});
+        }
+    }
+
+    // The scan is slow, so it only answers every 16th query; the others are checked on the same ones
+    long long scanTotal = 0;
+    long long listTotal = 0;
+    long long snapshotTotal = 0;
+    const size_t sampleStep = 16;
+    size_t sampled = (queries.size() + sampleStep - 1) / sampleStep;
+    Timing scanned = timeRuns(max(1, repeats / 5), [&]()
+                              {
+                                  scanTotal = 0;
+                                  for (size_t q = 0; q < queries.size(); q += sampleStep)
+                                  {
+                                      const auto &query = queries[q];
+                                      for (int i = 0; i < list.size(); i++)
+                                      {
+                                          const PostalCodeItem &item = list.getItem(i);
+                                          if (item.getState() == query.first && item.getCounty() == query.second)
+                                          {
+                                              scanTotal += i;
+                                          }
+                                      }
+                                  }
+                              });
+    vector<uint32_t> rows;
+    Timing listed = timeRuns(repeats, [&]()
+                             {
+                                 listTotal = 0;
+                                 for (const auto &query : queries)
+                                 {
+                                     ItemRange found = list.findByStateAndCounty(query.first, query.second, rows);
+                                     for (size_t i = 0; i < found.size(); i++)
+                                     {
+                                         listTotal += found.indexAt(i);
+                                     }
+                                 }
+                             });
+    Timing mapped = timeRuns(repeats, [&]()
+                             {
+                                 snapshotTotal = 0;
+                                 for (const auto &query : queries)
+                                 {
+                                     snapshot.findByStateAndCounty(query.first, query.second, rows);
+                                     for (uint32_t row : rows)
+                                     {
+                                         snapshotTotal += row;
+                                     }
+                                 }
+                             });
+    size_t stateRows = 0;
+    Timing byState = timeRuns(repeats, [&]()
+                              {
+                                  stateRows = 0;
+                                  for (const auto &query : queries)
+                                  {
+                                      stateRows += list.findByState(query.first).size();
+                                  }
+                              });
+
+    long long sampleTotal = 0;
+    for (size_t q = 0; q < queries.size(); q += sampleStep)
+    {
+        ItemRange found = list.findByStateAndCounty(queries[q].first, queries[q].second, rows);
+        for (size_t i = 0; i < found.size(); i++)
+        {
+            sampleTotal += found.indexAt(i);
+        }
+    }
+
+    bool same = scanTotal == sampleTotal && listTotal == snapshotTotal;
+    cout << queries.size() << " state AND county queries (" << (same ? "all three agree" : "RESULTS DIFFER")
+         << ", posting lists use " << list.postingMemoryBytes() << " bytes):" << endl;
+    cout << "  full scan with string compares, " << sampled << " of them: "
+         << scanned.best * queries.size() / sampled << " ms for all, estimated" << endl;
+    printTiming("  full scan, sampled queries only", scanned);
+    printTiming("  PostalList posting lists", listed);
+    printTiming("  PostalSnapshot posting lists", mapped);
+    printTiming("  findByState alone", byState);
+    cout << "  " << queries.size() * 1000 / listed.best << " queries/s from the list, "
+         << queries.size() * 1000 / mapped.best << " from the snapshot" << endl;
+    cout << "(checksum " << stateRows << ")" << endl
+         << endl;
+
+    snapshot.close();
+    remove(scratch.c_str());
+}
+
+/**
+ * @brief Compare place-name autocomplete on the prefix index with a scan of getPlace() copies.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkAutocomplete(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const string scratch = "benchmark_autocomplete.tmp";
+    list.saveSnapshot(scratch, fileName);
+    PostalSnapshot snapshot;
+    snapshot.open(scratch);
+
+    // Lower-cased 2-5 letter prefixes of every 50th place name, each with the state it came from
+    vector<pair<string, string>> queries;
+    for (int i = 0; i < list.size(); i += 50)
+    {
+        const PostalCodeItem &item = list.getItem(i);
+        string prefix = item.getPlace().substr(0, 2 + queries.size() % 4);
+        transform(prefix.begin(), prefix.end(), prefix.begin(), [](unsigned char c)
+                  { return static_cast<char>(tolower(c)); });
+        queries.push_back({prefix, item.getState()});
+    }
+    const size_t limit = 10;
+
+    // The scan keeps every match, then keeps the first ten by name and ZIP
+    long long scanTotal = 0;
+    long long listTotal = 0;
+    long long snapshotTotal = 0;
+    Timing scanned = timeRuns(max(1, repeats / 5), [&]()
+                              {
+                                  scanTotal = 0;
+                                  vector<pair<string, int>> matches;
+                                  for (const auto &query : queries)
+                                  {
+                                      matches.clear();
+                                      for (int i = 0; i < list.size(); i++)
+                                      {
+                                          string place = list.getItem(i).getPlace();
+                                          if (hasFoldedPrefix(place, query.first))
+                                          {
+                                              matches.push_back({place, list.getItem(i).getZip()});
+                                          }
+                                      }
+                                      size_t kept = min(limit, matches.size());
+                                      partial_sort(matches.begin(), matches.begin() + kept, matches.end(),
+                                                   [](const pair<string, int> &a, const pair<string, int> &b)
+                                                   {
+                                                       int order = compareFolded(a.first, b.first);
+                                                       if (order != 0)
+                                                       {
+                                                           return order < 0;
+                                                       }
+                                                       return a.first != b.first ? a.first < b.first : a.second < b.second;
+                                                   });
+                                      for (size_t m = 0; m < kept; m++)
+                                      {
+                                          scanTotal += matches[m].second;
+                                      }
+                                  }
+                              });
+    vector<PlaceMatch> found;
+    Timing listed = timeRuns(repeats, [&]()
+                             {
+                                 listTotal = 0;
+                                 for (const auto &query : queries)
+                                 {
+                                     list.completePlace(query.first, limit, found);
+                                     for (const PlaceMatch &match : found)
+                                     {
+                                         listTotal += match.zip;
+                                     }
+                                 }
+                             });
+    Timing mapped = timeRuns(repeats, [&]()
+                             {
+                                 snapshotTotal = 0;
+                                 for (const auto &query : queries)
+                                 {
+                                     snapshot.completePlace(query.first, limit, found);
+                                     for (const PlaceMatch &match : found)
+                                     {
+                                         snapshotTotal += match.zip;
+                                     }
+                                 }
+                             });
+    long long stateTotal = 0;
+    Timing filtered = timeRuns(repeats, [&]()
+                               {
+                                   stateTotal = 0;
+                                   for (const auto &query : queries)
+                                   {
+                                       list.completePlace(query.first, limit, found, query.second);
+                                       stateTotal += static_cast<long long>(found.size());
+                                   }
+                               });
+
+    bool same = scanTotal == listTotal && listTotal == snapshotTotal;
+    cout << queries.size() << " place prefix queries, top " << limit << " each ("
+         << (same ? "all three agree" : "RESULTS DIFFER") << "):" << endl;
+    printTiming("  scan of getPlace() copies", scanned);
+    printTiming("  PostalList prefix index", listed);
+    printTiming("  PostalSnapshot prefix index", mapped);
+    printTiming("  PostalList, filtered by state", filtered);
+    cout << "  " << listed.best * 1000000 / queries.size() << " ns per query from the list, "
+         << mapped.best * 1000000 / queries.size() << " from the snapshot" << endl;
+    cout << "(checksum " << stateTotal << ")" << endl
+         << endl;
+
+    snapshot.close();
+    remove(scratch.c_str());
+}
+
+/**
+ * @brief Time typo-tolerant place and county search per query and compare it with a scan of every item.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkFuzzy(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const int maxDistance = 2;
+    const size_t limit = 10;
+
+    // One typo in every 40th place name (a dropped or changed letter), every 80th county name
+    vector<string> queries = {"Holtsvile", "Sufolk"};
+    for (int i = 0; i < list.size(); i += 40)
+    {
+        const PostalCodeItem &item = list.getItem(i);
+        string name = (i % 80 == 0) ? item.getCounty() : item.getPlace();
+        if (name.size() < 4)
+        {
+            continue;
+        }
+        size_t at = name.size() / 2;
+        if (queries.size() % 2)
+        {
+            name.erase(at, 1);
+        }
+        else
+        {
+            name[at] = name[at] == 'x' ? 'y' : 'x';
+        }
+        queries.push_back(name);
+    }
+
+    // The scan copies both names of every item and computes the same distance
+    auto scanBest = [&](const string &query)
+    {
+        string folded = query;
+        transform(folded.begin(), folded.end(), folded.begin(), [](unsigned char c)
+                  { return static_cast<char>(tolower(c)); });
+        int best = maxDistance + 1;
+        for (int i = 0; i < list.size(); i++)
+        {
+            best = min(best, boundedEditDistance(folded, list.getItem(i).getPlace(), maxDistance));
+            best = min(best, boundedEditDistance(folded, list.getItem(i).getCounty(), maxDistance));
+        }
+        return best;
+    };
+    const size_t sampleStep = 10;
+    size_t sampled = 0;
+    size_t agree = 0;
+    vector<FuzzyMatch> found;
+    Timing scanned = timeRuns(1, [&]()
+                              {
+                                  for (size_t q = 0; q < queries.size(); q += sampleStep)
+                                  {
+                                      int best = scanBest(queries[q]);
+                                      list.fuzzySearch(queries[q], limit, found, maxDistance);
+                                      int indexed = found.empty() ? maxDistance + 1 : found[0].distance;
+                                      agree += best == indexed;
+                                      sampled++;
+                                  }
+                              });
+
+    // Time every query on its own so the tail shows
+    vector<double> micros;
+    size_t hits = 0;
+    for (int r = 0; r < repeats; r++)
+    {
+        for (const string &query : queries)
+        {
+            auto start = chrono::steady_clock::now();
+            list.fuzzySearch(query, limit, found, maxDistance);
+            chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - start;
+            micros.push_back(elapsed.count());
+            hits += !found.empty();
+        }
+    }
+    sort(micros.begin(), micros.end());
+    auto percentile = [&](double p)
+    { return micros[min(micros.size() - 1, static_cast<size_t>(p * micros.size()))]; };
+
+    list.fuzzySearch("Holtsvile", 3, found, maxDistance);
+    cout << queries.size() << " one-typo place/county queries, up to " << maxDistance << " edits, top " << limit
+         << " (" << agree << " of " << sampled << " sampled best distances match a full scan):" << endl;
+    cout << "  full scan of getPlace()/getCounty() copies: " << scanned.best / sampled << " ms per query" << endl;
+    cout << "  trigram index: p50 " << percentile(0.50) << " us, p99 " << percentile(0.99) << " us, max "
+         << micros.back() << " us (" << hits / repeats << " queries with a match)" << endl;
+    for (const FuzzyMatch &match : found)
+    {
+        cout << "  \"Holtsvile\" -> " << match.item->getPlace() << ", " << match.item->getState() << " "
+             << match.item->getZip() << " (distance " << match.distance << ", score " << match.score << ")" << endl;
+    }
+    cout << endl;
+}
+
+/**
+ * @brief Measure ZIP lookups through a LiveDataset with and without reloads running beside them.
+ * @param fileName The CSV file to load.
+ * @param repeats  Unused; each phase runs for a fixed time.
+ */
+void benchmarkHotReload(const string &fileName, int repeats)
+{
+    (void)repeats;
+    PostalList first;
+    inputCSVtoList(first, fileName);
+    vector<int> zips;
+    for (int i = 0; i < first.size(); i += 7)
+    {
+        zips.push_back(first.getItem(i).getZip());
+    }
+    const int expectedSize = first.size();
+    LiveDataset live(move(first));
+
+    // Readers look up ZIP codes for a fixed time; each lookup takes and drops a Reader
+    auto readFor = [&](double seconds, size_t &lookups, size_t &torn)
+    {
+        atomic<bool> done(false);
+        atomic<size_t> total(0);
+        atomic<size_t> bad(0);
+        vector<thread> readers;
+        unsigned count = workerCount(0);
+        for (unsigned t = 0; t < count; t++)
+        {
+            readers.emplace_back([&, t]()
+                                 {
+                                     size_t mine = 0;
+                                     size_t i = t;
+                                     while (!done.load(memory_order_relaxed))
+                                     {
+                                         LiveDataset::Reader reader = live.read();
+                                         bad += reader->list.size() != expectedSize ||
+                                                reader->list.findByZip(zips[i % zips.size()]) == nullptr;
+                                         i += 13;
+                                         mine++;
+                                     }
+                                     total += mine;
+                                 });
+        }
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        done = true;
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+        lookups = total;
+        torn = bad;
+    };
+
+    size_t quietLookups = 0;
+    size_t quietBad = 0;
+    readFor(1.0, quietLookups, quietBad);
+
+    // The same, while another thread keeps loading and publishing new copies
+    atomic<bool> reloading(true);
+    int reloads = 0;
+    thread reloader([&]()
+                    {
+                        while (reloading)
+                        {
+                            PostalList next;
+                            inputCSVtoList(next, fileName);
+                            live.publish(move(next));
+                            reloads++;
+                        }
+                    });
+    size_t busyLookups = 0;
+    size_t busyBad = 0;
+    readFor(1.0, busyLookups, busyBad);
+    reloading = false;
+    reloader.join();
+    size_t waiting = live.reclaim();
+
+    cout << "LiveDataset lookups on " << workerCount(0) << " reader threads ("
+         << (quietBad + busyBad == 0 ? "no torn or missing reads" : "READS WENT WRONG") << "):" << endl;
+    cout << "  without reloads: " << quietLookups << " lookups/s" << endl;
+    cout << "  with " << reloads << " reloads published in the same second: " << busyLookups << " lookups/s" << endl;
+    cout << "  retired datasets not yet freed afterwards: " << waiting << endl
+         << endl;
+}
+
+/**
+ * @brief Compare sorting item copies, sorting a permutation and radix sorting it, then walking the cached views.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many sorts to time.
+ */
+void benchmarkSortedViews(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const int32_t *zips = list.getColumns().zipData();
+
+    // What printSortedByZip used to do: copy every item, strings included, and sort the copies
+    vector<PostalCodeItem> copies;
+    Timing copySort = timeRuns(repeats, [&]()
+                               {
+                                   copies.clear();
+                                   for (int i = 0; i < list.size(); i++)
+                                   {
+                                       copies.push_back(list.getItem(i));
+                                   }
+                                   sort(copies.begin(), copies.end(),
+                                        [](const PostalCodeItem &a, const PostalCodeItem &b)
+                                        {
+                                            return a.getZip() < b.getZip();
+                                        });
+                               });
+
+    vector<uint32_t> order;
+    vector<uint32_t> keys;
+    Timing comparisonSort = timeRuns(repeats, [&]()
+                                     {
+                                         order.resize(list.size());
+                                         for (uint32_t i = 0; i < order.size(); i++)
+                                         {
+                                             order[i] = i;
+                                         }
+                                         stable_sort(order.begin(), order.end(),
+                                                     [zips](uint32_t a, uint32_t b)
+                                                     {
+                                                         return zips[a] < zips[b];
+                                                     });
+                                     });
+    Timing radix = timeRuns(repeats, [&]()
+                            {
+                                order.resize(list.size());
+                                keys.resize(list.size());
+                                for (uint32_t i = 0; i < order.size(); i++)
+                                {
+                                    order[i] = i;
+                                    keys[i] = static_cast<uint32_t>(zips[i]);
+                                }
+                                radixSortRows(order, keys);
+                            });
+
+    long long total = 0;
+    Timing byState = timeRuns(1, [&]()
+                              {
+                                  total += list.sortedByState().size(); // first call builds both views
+                              });
+    Timing walk = timeRuns(repeats, [&]()
+                           {
+                               for (const auto &item : list.sortedByZip())
+                               {
+                                   total += item.getZip();
+                               }
+                               for (const auto &item : list.sortedByState())
+                               {
+                                   total += item.getZip();
+                               }
+                           });
+
+    cout << "Sorted views over " << list.size() << " rows:" << endl;
+    printTiming("  copy items + sort by ZIP", copySort);
+    printTiming("  stable_sort permutation by ZIP", comparisonSort);
+    printTiming("  radix sort permutation by ZIP", radix);
+    printTiming("  build ZIP + state views", byState);
+    printTiming("  walk both cached views", walk);
+    cout << "(checksum " << total << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Count heap allocations on the load, sort and read paths, with copying and with zero-copy accessors.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many sorts to time.
+ */
+void benchmarkZeroCopy(const string &fileName, int repeats)
+{
+    size_t before = allocationCount;
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    size_t serialLoad = allocationCount - before;
+
+    before = allocationCount;
+    PostalList parallel;
+    inputCSVtoListParallel(parallel, fileName);
+    size_t parallelLoad = allocationCount - before;
+
+    // Order rows by state and then ZIP with a comparison sort, reading the fields two ways
+    vector<uint32_t> order(list.size());
+    auto resetOrder = [&]()
+    {
+        for (uint32_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+    };
+    size_t copyingAllocations = 0;
+    Timing copying = timeRuns(repeats, [&]()
+                              {
+                                  resetOrder();
+                                  before = allocationCount;
+                                  // What a by-value getItem and string getters cost: whole item copies per comparison
+                                  sort(order.begin(), order.end(), [&list](uint32_t a, uint32_t b)
+                                       {
+                                           PostalCodeItem x = list.getItem(a);
+                                           PostalCodeItem y = list.getItem(b);
+                                           string xState = x.getState();
+                                           string yState = y.getState();
+                                           return xState != yState ? xState < yState : x.getZip() < y.getZip();
+                                       });
+                                  copyingAllocations = allocationCount - before;
+                              });
+    size_t viewAllocations = 0;
+    Timing views = timeRuns(repeats, [&]()
+                            {
+                                resetOrder();
+                                before = allocationCount;
+                                sort(order.begin(), order.end(), [&list](uint32_t a, uint32_t b)
+                                     {
+                                         const PostalCodeItem &x = list.getItem(a);
+                                         const PostalCodeItem &y = list.getItem(b);
+                                         string_view xState = x.getStateView();
+                                         string_view yState = y.getStateView();
+                                         return xState != yState ? xState < yState : x.getZip() < y.getZip();
+                                     });
+                                viewAllocations = allocationCount - before;
+                            });
+
+    // The read path once the views are built: lookups, sorted walks and plain iteration
+    list.sortedByState();
+    size_t total = 0;
+    before = allocationCount;
+    for (const PostalCodeItem &item : list)
+    {
+        total += list.findByZip(item.getZip()) != nullptr;
+    }
+    for (const PostalCodeItem &item : list.sortedByState())
+    {
+        total += item.getPlaceView().size() + item.getStateView().size() + item.getCountyView().size();
+    }
+    for (int i = 0; i < list.size(); i++)
+    {
+        total += list.getItem(i).getCountyView().size();
+    }
+    size_t readAllocations = allocationCount - before;
+
+    cout << "Heap allocations over " << list.size() << " rows:" << endl;
+    cout << left << setw(48) << "  inputCSVtoList" << serialLoad << " ("
+         << static_cast<double>(serialLoad) / list.size() << " per row)" << endl;
+    cout << left << setw(48) << "  inputCSVtoListParallel" << parallelLoad << " ("
+         << static_cast<double>(parallelLoad) / parallel.size() << " per row)" << endl;
+    cout << left << setw(48) << "  sort by state, item copies + string getters" << copyingAllocations
+         << " (best " << copying.best << " ms)" << endl;
+    cout << left << setw(48) << "  sort by state, references + string_views" << viewAllocations
+         << " (best " << views.best << " ms)" << endl;
+    cout << left << setw(48) << "  findByZip + sorted walk + getItem walk" << readAllocations << endl;
+    cout << "(checksum " << total << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Compare comparator sorts with the normalized-key ORDER BY engine, full and top-K.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many sorts to time.
+ * @note Checks that every engine order matches a stable comparator sort.
+ */
+void benchmarkOrderBy(const string &fileName, int repeats)
+{
+    PostalList real;
+    inputCSVtoList(real, fileName);
+    const size_t rows = 1000000;
+    PostalList list;
+    list.reserve(rows);
+    makeScaledList(real, rows, list);
+
+    // A stable comparator over the items, reading the fields through string_views
+    auto compareItems = [](const vector<SortField> &fields, const PostalCodeItem &x, const PostalCodeItem &y)
+    {
+        for (const SortField &field : fields)
+        {
+            int order = 0;
+            switch (field.column)
+            {
+            case SortColumn::Zip:
+                order = (x.getZip() > y.getZip()) - (x.getZip() < y.getZip());
+                break;
+            case SortColumn::Place:
+                order = x.getPlaceView().compare(y.getPlaceView());
+                break;
+            case SortColumn::State:
+                order = x.getStateView().compare(y.getStateView());
+                break;
+            case SortColumn::County:
+                order = x.getCountyView().compare(y.getCountyView());
+                break;
+            case SortColumn::Latitude:
+                order = (x.getLatitude() > y.getLatitude()) - (x.getLatitude() < y.getLatitude());
+                break;
+            case SortColumn::Longitude:
+                order = (x.getLongitude() > y.getLongitude()) - (x.getLongitude() < y.getLongitude());
+                break;
+            }
+            if (order != 0)
+            {
+                return field.descending ? order > 0 : order < 0;
+            }
+        }
+        return false;
+    };
+
+    cout << "ORDER BY over " << rows << " rows:" << endl;
+    for (const char *orderBy : {"county, place, lat desc", "state, zip desc", "lon, lat"})
+    {
+        vector<SortField> fields;
+        parseOrderBy(orderBy, fields);
+        vector<uint32_t> order(rows);
+
+        Timing comparator = timeRuns(repeats, [&]()
+                                     {
+                                         for (uint32_t i = 0; i < rows; i++)
+                                         {
+                                             order[i] = i;
+                                         }
+                                         stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                                                     {
+                                                         return compareItems(fields, list.getItem(a), list.getItem(b));
+                                                     });
+                                     });
+        vector<uint32_t> sorted;
+        Timing engine = timeRuns(repeats, [&]()
+                                 {
+                                     list.sortedBy(fields, sorted);
+                                 });
+        bool same = sorted == order;
+
+        vector<uint32_t> top;
+        Timing topK = timeRuns(repeats, [&]()
+                               {
+                                   list.sortedBy(fields, top, 100);
+                               });
+        same = same && equal(top.begin(), top.end(), order.begin());
+
+        cout << "  \"" << orderBy << "\"" << (same ? "" : "  MISMATCH") << endl;
+        printTiming("    comparator stable_sort", comparator);
+        printTiming("    normalized keys", engine);
+        printTiming("    normalized keys, first 100", topK);
+    }
+
+    // A few million rows on one thread and on every thread
+    vector<SortField> fields;
+    parseOrderBy("county, place, lat desc", fields);
+    vector<uint32_t> serial;
+    vector<uint32_t> parallel;
+    Timing oneThread = timeRuns(repeats, [&]()
+                                {
+                                    orderRows(list.getColumns(), fields, 0, serial, 1);
+                                });
+    Timing allThreads = timeRuns(repeats, [&]()
+                                 {
+                                     orderRows(list.getColumns(), fields, 0, parallel, 4);
+                                 });
+    cout << "  4 threads vs 1" << (serial == parallel ? "" : "  MISMATCH") << endl;
+    printTiming("    1 thread", oneThread);
+    printTiming("    4 threads", allThreads);
+    cout << "(" << thread::hardware_concurrency() << " hardware thread(s) on this machine)" << endl
+         << endl;
+}
+
+/**
+ * @brief Compare items that point into a list's string pool with items that
+ * own their strings: heap allocations, memory and the time to build and free
+ * a few million of them.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many builds and teardowns to time.
+ */
+void benchmarkStringPool(const string &fileName, int repeats)
+{
+    PostalList real;
+    inputCSVtoList(real, fileName);
+    const PostalColumns &columns = real.getColumns();
+    const size_t rows = 4000000;
+    size_t n = real.size();
+
+    // Pooled items view the names in the list's dictionaries, the way PostalList stores them
+    auto buildPooled = [&](vector<PostalCodeItem> &out)
+    {
+        out.reserve(rows);
+        for (size_t i = 0; i < rows; i++)
+        {
+            const PostalCodeItem &item = real.getItem(static_cast<int>(i % n));
+            out.push_back(PostalCodeItem::withSharedStrings(item.getZip(), columns.place(i % n), columns.state(i % n),
+                                                            columns.county(i % n), item.getLatitude(),
+                                                            item.getLongitude()));
+        }
+    };
+    auto buildOwned = [&](vector<PostalCodeItem> &out)
+    {
+        out.reserve(rows);
+        for (size_t i = 0; i < rows; i++)
+        {
+            out.push_back(real.getItem(static_cast<int>(i % n)));
+        }
+    };
+
+    for (bool pooled : {true, false})
+    {
+        vector<PostalCodeItem> items;
+        size_t allocations = 0;
+        Timing build = {1e300, 0};
+        Timing teardown = {1e300, 0};
+        for (int run = 0; run < repeats; run++)
+        {
+            size_t before = allocationCount;
+            auto start = chrono::steady_clock::now();
+            pooled ? buildPooled(items) : buildOwned(items);
+            auto built = chrono::steady_clock::now();
+            allocations = allocationCount - before;
+            vector<PostalCodeItem>().swap(items);
+            auto freed = chrono::steady_clock::now();
+
+            chrono::duration<double, milli> buildTime = built - start;
+            chrono::duration<double, milli> teardownTime = freed - built;
+            build.best = min(build.best, buildTime.count());
+            build.average += buildTime.count() / repeats;
+            teardown.best = min(teardown.best, teardownTime.count());
+            teardown.average += teardownTime.count() / repeats;
+        }
+
+        // Bytes: the item array, plus one text block per owned item
+        size_t bytes = rows * sizeof(PostalCodeItem);
+        for (size_t i = 0; i < rows && !pooled; i++)
+        {
+            const PostalCodeItem &item = real.getItem(static_cast<int>(i % n));
+            bytes += item.getPlaceView().size() + item.getStateView().size() + item.getCountyView().size();
+        }
+
+        cout << (pooled ? "Items viewing the string pool" : "Items owning their strings") << " (" << rows
+             << " rows):" << endl;
+        cout << left << setw(36) << "  heap allocations" << allocations << endl;
+        cout << left << setw(36) << "  memory" << bytes / (1024 * 1024) << " MiB" << endl;
+        printTiming("  build", build);
+        printTiming("  free", teardown);
+    }
+    cout << "(the pool itself: " << columns.memoryBytes() / 1024 << " KiB of columns and names for " << n
+         << " rows)" << endl
+         << endl;
+}
+
+/**
+ * @brief Compare printing the table with cout-style setw/endl against TableFormatter.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many full dumps to time.
+ * @note Writes to a scratch file next to the CSV files and removes it afterwards.
+ */
+void benchmarkFormatter(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+    const string scratch = "benchmark_output.tmp";
+
+    // The way printSortedByZip used to print: setw per field and endl per line
+    Timing streamed = timeRuns(repeats, [&]()
+                               {
+                                   ofstream out(scratch);
+                                   for (const auto &item : list.sortedByZip())
+                                   {
+                                       out << left << setw(10) << item.getZip()
+                                           << setw(20) << item.getPlace()
+                                           << setw(10) << item.getState()
+                                           << setw(30) << item.getCounty()
+                                           << setw(12) << item.getLatitude()
+                                           << setw(12) << item.getLongitude()
+                                           << endl;
+                                       out << "-----------------------------------------------------------------------------------------------" << endl;
+                                   }
+                               });
+    ifstream streamedFile(scratch);
+    string streamedText((istreambuf_iterator<char>(streamedFile)), istreambuf_iterator<char>());
+
+    cout << "Printing " << list.size() << " rows sorted by ZIP to a file:" << endl;
+    printTiming("  setw + endl", streamed);
+
+    const pair<OutputFormat, const char *> formats[] = {{OutputFormat::Table, "  TableFormatter, table"},
+                                                        {OutputFormat::TSV, "  TableFormatter, TSV"},
+                                                        {OutputFormat::CSV, "  TableFormatter, CSV"},
+                                                        {OutputFormat::JSONLines, "  TableFormatter, JSON lines"}};
+    for (const auto &[format, name] : formats)
+    {
+        Timing timing = timeRuns(repeats, [&]()
+                                 {
+                                     ofstream out(scratch);
+                                     TableFormatter formatter(out, format);
+                                     list.printSortedByZip(formatter);
+                                 });
+        printTiming(name, timing);
+
+        if (format == OutputFormat::Table)
+        {
+            ifstream tableFile(scratch);
+            string tableText((istreambuf_iterator<char>(tableFile)), istreambuf_iterator<char>());
+            cout << "  table output " << (tableText == streamedText ? "is byte-identical" : "DIFFERS") << endl;
+        }
+    }
+    remove(scratch.c_str());
+    cout << endl;
+}
+
+/**
+ * @brief Compare parsing the CSV with opening a binary snapshot, up to the first ZIP lookup.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many startups to time.
+ * @note Writes a scratch snapshot next to the CSV files and removes it afterwards.
+ */
+void benchmarkSnapshot(const string &fileName, int repeats)
+{
+    const string scratch = "benchmark_snapshot.tmp";
+    PostalList source;
+    inputCSVtoList(source, fileName);
+    Timing save = timeRuns(1, [&]()
+                           {
+                               source.saveSnapshot(scratch, fileName);
+                           });
+    int probe = source.getItem(source.size() / 2).getZip();
+
+    long long total = 0;
+    Timing parsed = timeRuns(repeats, [&]()
+                             {
+                                 PostalList list;
+                                 inputCSVtoList(list, fileName);
+                                 total += list.findIndexByZip(probe);
+                             });
+    Timing mapped = timeRuns(repeats, [&]()
+                             {
+                                 PostalSnapshot snapshot;
+                                 snapshot.open(scratch);
+                                 total += snapshot.findIndexByZip(probe);
+                             });
+
+    PostalSnapshot snapshot;
+    bool opened = snapshot.open(scratch);
+    Timing verify = timeRuns(repeats, [&]()
+                             {
+                                 total += snapshot.verify();
+                             });
+    Timing materialize = timeRuns(max(1, repeats / 5), [&]()
+                                  {
+                                      PostalList list;
+                                      total += list.addSnapshot(snapshot);
+                                  });
+
+    // The snapshot must print exactly what the list prints
+    ostringstream fromList;
+    ostringstream fromSnapshot;
+    {
+        TableFormatter listFormatter(fromList);
+        TableFormatter snapshotFormatter(fromSnapshot);
+        source.printSortedByState(listFormatter);
+        snapshot.printSortedByState(snapshotFormatter);
+    }
+    bool same = opened && snapshot.verify() && !snapshot.isStale(fileName) && fromList.str() == fromSnapshot.str();
+
+    cout << "Startup to first findByZip (" << (same ? "snapshot matches the CSV" : "SNAPSHOT DIFFERS") << "):" << endl;
+    printTiming("  parse CSV into PostalList", parsed);
+    printTiming("  open snapshot", mapped);
+    printTiming("  write snapshot", save);
+    printTiming("  verify snapshot checksum", verify);
+    printTiming("  snapshot into PostalList", materialize);
+    cout << "(checksum " << total << ")" << endl
+         << endl;
+
+    snapshot.close();
+    remove(scratch.c_str());
+}
+
+/**
+ * @brief Brute-force k nearest items: the distance to every item, then a partial sort.
+ * @param list The list to search.
+ * @param lat  Latitude in degrees.
+ * @param lon  Longitude in degrees.
+ * @param k    How many items to return.
+ * @return The k nearest (distance, index) pairs, nearest first.
+ */
+vector<pair<double, int>> bruteForceNearest(const PostalList &list, double lat, double lon, size_t k)
+{
+    const double *latitudes = list.getColumns().latitudeData();
+    const double *longitudes = list.getColumns().longitudeData();
+    vector<pair<double, int>> all(list.size());
+    for (int i = 0; i < list.size(); i++)
+    {
+        all[i] = {greatCircleMiles(lat, lon, latitudes[i], longitudes[i]), i};
+    }
+    k = min(k, all.size());
+    partial_sort(all.begin(), all.begin() + k, all.end());
+    all.resize(k);
+    return all;
+}
+
+/**
+ * @brief Compare the k-d tree with brute force for nearest and radius searches.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many passes to time.
+ */
+void benchmarkSpatial(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+
+    SpatialIndex index;
+    Timing build = timeRuns(1, [&]()
+                            {
+                                index.build(list);
+                            });
+
+    // Query at the positions of spread-out items, nudged off the exact point
+    vector<pair<double, double>> points;
+    for (int i = 0; i < list.size(); i += list.size() / 500)
+    {
+        PostalCodeItem item = list.getItem(i);
+        points.emplace_back(item.getLatitude() + 0.01, item.getLongitude() - 0.01);
+    }
+
+    // Check the tree against brute force on distances (equal distances may list different items)
+    size_t mismatches = 0;
+    for (const auto &[lat, lon] : points)
+    {
+        vector<SpatialMatch> fast = index.nearest(lat, lon, 10);
+        vector<pair<double, int>> slow = bruteForceNearest(list, lat, lon, 10);
+        for (size_t i = 0; i < slow.size(); i++)
+        {
+            if (i >= fast.size() || fabs(fast[i].miles - slow[i].first) > 1e-6)
+            {
+                mismatches++;
+            }
+        }
+        size_t inRadius = 0;
+        const double *latitudes = list.getColumns().latitudeData();
+        const double *longitudes = list.getColumns().longitudeData();
+        for (int i = 0; i < list.size(); i++)
+        {
+            inRadius += greatCircleMiles(lat, lon, latitudes[i], longitudes[i]) <= 25;
+        }
+        mismatches += (inRadius != index.withinRadius(lat, lon, 25).size());
+    }
+
+    long long total = 0;
+    Timing nearestTree = timeRuns(repeats, [&]()
+                                  {
+                                      for (const auto &[lat, lon] : points)
+                                      {
+                                          total += index.nearest(lat, lon, 10).size();
+                                      }
+                                  });
+    Timing radiusTree = timeRuns(repeats, [&]()
+                                 {
+                                     for (const auto &[lat, lon] : points)
+                                     {
+                                         total += index.withinRadius(lat, lon, 25).size();
+                                     }
+                                 });
+    Timing nearestBrute = timeRuns(max(1, repeats / 5), [&]()
+                                   {
+                                       for (const auto &[lat, lon] : points)
+                                       {
+                                           total += bruteForceNearest(list, lat, lon, 10).size();
+                                       }
+                                   });
+
+    double perQuery = 1000.0 / points.size(); // ms per batch -> us per query
+    cout << "Spatial search, " << points.size() << " queries over " << list.size() << " rows"
+         << (mismatches == 0 ? " (matches brute force)" : " (MISMATCHES WITH BRUTE FORCE)") << ":" << endl;
+    printTiming("  build k-d tree", build);
+    cout << left << setw(36) << "  nearest(k=10), k-d tree" << setw(10) << nearestTree.best * perQuery << " us/query" << endl;
+    cout << left << setw(36) << "  withinRadius(25 mi), k-d tree" << setw(10) << radiusTree.best * perQuery << " us/query" << endl;
+    cout << left << setw(36) << "  nearest(k=10), brute force" << setw(10) << nearestBrute.best * perQuery << " us/query" << endl;
+    cout << "(checksum " << total << ")" << endl
+         << endl;
+}
+
+/**
+ * @brief Time each distance kernel on an origin x destination matrix and check it against the haversine.
+ * @param fileName The CSV file to load.
+ * @param repeats  How many matrices to time for each kernel.
+ */
+void benchmarkDistances(const string &fileName, int repeats)
+{
+    PostalList list;
+    inputCSVtoList(list, fileName);
+
+    // 1000 origins and 1000 destinations spread over the whole list
+    const int side = 1000;
+    vector<int> origins;
+    vector<int> destinations;
+    for (int i = 0; i < side; i++)
+    {
+        origins.push_back(list.getItem(i * (list.size() / side)).getZip());
+        destinations.push_back(list.getItem((i * (list.size() / side) + list.size() / (2 * side)) % list.size()).getZip());
+    }
+
+    // Reference distances from the scalar haversine
+    vector<double> reference(origins.size() * destinations.size());
+    const double *latitudes = list.getColumns().latitudeData();
+    const double *longitudes = list.getColumns().longitudeData();
+    Timing haversine = timeRuns(max(1, repeats / 5), [&]()
+                                {
+                                    for (size_t i = 0; i < origins.size(); i++)
+                                    {
+                                        int from = list.findIndexByZip(origins[i]);
+                                        for (size_t j = 0; j < destinations.size(); j++)
+                                        {
+                                            int to = list.findIndexByZip(destinations[j]);
+                                            reference[i * destinations.size() + j] =
+                                                greatCircleMiles(latitudes[from], longitudes[from], latitudes[to], longitudes[to]);
+                                        }
+                                    }
+                                });
+
+    double pairs = double(origins.size()) * destinations.size();
+    cout << "Distance matrix, " << origins.size() << " x " << destinations.size() << " ZIP codes (best kernel: "
+         << distancePathName(bestDistancePath()) << "):" << endl;
+    cout << left << setw(36) << "  haversine loop" << setw(10) << pairs / haversine.best / 1000 << " M pairs/s" << endl;
+
+    DistancePath paths[] = {DistancePath::Scalar, DistancePath::AVX2, DistancePath::AVX512};
+    for (DistancePath path : paths)
+    {
+        vector<double> distances;
+        Timing timing = timeRuns(repeats, [&]()
+                                 {
+                                     distances = distanceMatrix(list, origins, destinations, 1, path);
+                                 });
+
+        double worst = 0;
+        double worstRelative = 0;
+        for (size_t i = 0; i < distances.size(); i++)
+        {
+            double error = fabs(distances[i] - reference[i]);
+            worst = max(worst, error);
+            if (reference[i] > 1)
+            {
+                worstRelative = max(worstRelative, error / reference[i]);
+            }
+        }
+        cout << left << setw(36) << string("  ") + distancePathName(path) + ", 1 thread"
+             << setw(10) << pairs / timing.best / 1000 << " M pairs/s"
+             << "  max error " << worst << " mi (relative " << worstRelative << ")" << endl;
+    }
+
+    Timing threaded = timeRuns(repeats, [&]()
+                               {
+                                   distanceMatrix(list, origins, destinations);
+                               });
+    cout << left << setw(36) << "  best kernel, all threads" << setw(10) << pairs / threaded.best / 1000 << " M pairs/s" << endl;
+
+    // Unknown ZIP codes must come back as NaN, known ones must not
+    vector<double> pair = pairDistances(list, {origins[0], -1, origins[1]}, {destinations[0], destinations[1], 0});
+    bool nanOk = !isnan(pair[0]) && isnan(pair[1]) && isnan(pair[2]);
+    cout << "  unknown ZIP codes give NaN: " << (nanOk ? "yes" : "NO") << endl
+         << endl;
+}
+
+/**
+ * @brief Runs the benchmarks.
+ * @param argc Argument count.
+ * @param argv Optional CSV file, length-indicated file and repeat count.
+ * @return 0 if everything went fine, 1 if a file format did not read back intact.
+ */
+int main(int argc, char *argv[])
+{
+    string fileName = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    string indicatedFile = (argc > 2) ? argv[2] : "us_postal_codes_length_indicated_header_record.txt";
+    int repeats = (argc > 3) ? stoi(argv[3]) : 20;
+    bool intact = true;
+
+    benchmarkLoaders(fileName, repeats);
+    benchmarkParallelLoaders(fileName, indicatedFile, repeats);
+    benchmarkTokenizer(fileName, repeats);
+    benchmarkColumns(fileName, repeats);
+    benchmarkZipLookup(fileName, repeats);
+    benchmarkMetrics(fileName, repeats);
+    benchmarkIndexFile(fileName, repeats);
+    benchmarkHashIndex(indicatedFile, repeats);
+    benchmarkBatchFetch(indicatedFile, repeats);
+    intact = benchmarkBlockFile(indicatedFile, repeats) && intact;
+    benchmarkZipRange(fileName, repeats);
+    benchmarkPostings(fileName, repeats);
+    benchmarkAutocomplete(fileName, repeats);
+    benchmarkFuzzy(fileName, repeats);
+    benchmarkHotReload(fileName, repeats);
+    benchmarkSortedViews(fileName, repeats);
+    benchmarkZeroCopy(fileName, repeats);
+    benchmarkStringPool(fileName, repeats);
+    benchmarkOrderBy(fileName, repeats);
+    benchmarkFormatter(fileName, repeats);
+    benchmarkSnapshot(fileName, repeats);
+    benchmarkSpatial(fileName, repeats);
+    benchmarkDistances(fileName, repeats);
+
+    return intact ? 0 : 1;
+}
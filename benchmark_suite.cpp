@@ -0,0 +1,534 @@
+/**
+ * @file benchmark_suite.cpp
+ * @brief Repeatable load, lookup, print and index benchmarks with JSON results.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Runs the same set of benchmarks on every dataset and writes one JSON
+ * document to standard output, so two runs can be compared to spot
+ * regressions. Progress goes to standard error.
+ *
+ * The datasets are the sorted and the row-randomized copies of the real file,
+ * plus synthetic datasets of any size, each one written once in ZIP order and
+ * once shuffled. Synthetic rows repeat the real rows with keys
+ * zip * 10000 + n (like ZIP+4 codes stored as numbers), so every key is
+ * unique. They are written as CSV and length-indicated scratch files next to
+ * the real ones and removed afterwards.
+ *
+ * What is measured on each dataset:
+ *  - macro: inputCSVtoList, the first printSortedByZip / printSortedByState
+ *    on a fresh list (sort included), the same prints again (sort cached),
+ *    and make_index's build (scan and write) and load (open and one lookup).
+ *  - micro: findByZip and ZipIndexFile::find, separately for hits and misses.
+ *
+ * Printed output goes to a stream that discards it, so the numbers cover the
+ * formatting but not the terminal.
+ *
+ * Usage: benchmark_suite [repeats] [syntheticRows...]
+ *        e.g. benchmark_suite 5 1000000 10000000 50000000 > results.json
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <cstdio>
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "ZipIndexFile.h"
+#include "MappedFile.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+/**
+ * @brief One line of the JSON results.
+ */
+struct BenchmarkResult
+{
+    string name;    /**< What was measured, e.g. "lookup/findByZip/hit" */
+    string kind;    /**< "macro" (whole operation) or "micro" (per call) */
+    string dataset; /**< Dataset name */
+    string order;   /**< "sorted" or "randomized" */
+    size_t rows;    /**< Rows in the dataset */
+    string unit;    /**< "ms" per run or "ns" per call */
+    double best;    /**< Fastest run */
+    double average; /**< Mean over all runs */
+    int runs;       /**< How many runs were timed */
+};
+
+/**
+ * @brief Best and average of a set of timed runs.
+ */
+struct Samples
+{
+    double best = 1e300; /**< Fastest run so far */
+    double total = 0;    /**< Sum of all runs */
+    int runs = 0;        /**< Runs added */
+
+    /**
+     * @brief Add one run.
+     * @param value The run's time.
+     */
+    void add(double value)
+    {
+        best = min(best, value);
+        total += value;
+        runs++;
+    }
+};
+
+/**
+ * @brief A stream buffer that throws everything away.
+ */
+class NullBuffer : public streambuf
+{
+protected:
+    int overflow(int c) override
+    {
+        return traits_type::not_eof(c);
+    }
+
+    streamsize xsputn(const char *, streamsize count) override
+    {
+        return count;
+    }
+};
+
+/**
+ * @brief A dataset the suite runs on: its files and how its rows are ordered.
+ */
+struct BenchmarkDataset
+{
+    string name;          /**< Name in the results */
+    string order;         /**< "sorted" or "randomized" */
+    string csvFile;       /**< The CSV copy */
+    string indicatedFile; /**< The length-indicated copy, for make_index */
+    size_t generatedRows; /**< Rows to generate for a synthetic dataset, 0 for the real files */
+};
+
+/**
+ * @brief Milliseconds since a start time.
+ * @param start When the run started.
+ * @return The elapsed time in milliseconds.
+ */
+double millisecondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Add a result built from timed runs.
+ * @param results Receives the result.
+ * @param data    The dataset it was measured on.
+ * @param rows    Rows in the dataset.
+ * @param name    What was measured.
+ * @param kind    "macro" or "micro".
+ * @param unit    "ms" or "ns".
+ * @param samples The runs.
+ */
+void addResult(vector<BenchmarkResult> &results, const BenchmarkDataset &data, size_t rows,
+               const string &name, const string &kind, const string &unit, const Samples &samples)
+{
+    results.push_back({name, kind, data.name, data.order, rows, unit,
+                       samples.best, samples.total / max(1, samples.runs), samples.runs});
+}
+
+/**
+ * @brief Time lookups of one key set, reported per call.
+ * @param repeats How many passes over the keys to time.
+ * @param keys    The keys to look up.
+ * @param find    Looks up one key; returns whether it was found.
+ * @param found   Receives how many keys were found in the last pass.
+ * @return The per-call times in nanoseconds.
+ */
+template <typename Find>
+Samples timeLookups(int repeats, const vector<int> &keys, Find find, size_t &found)
+{
+    Samples samples;
+    for (int r = 0; r < repeats; r++)
+    {
+        found = 0;
+        auto start = chrono::steady_clock::now();
+        for (int zip : keys)
+        {
+            found += find(zip);
+        }
+        samples.add(millisecondsSince(start) * 1e6 / keys.size());
+    }
+    return samples;
+}
+
+/**
+ * @brief Pick ZIP codes to look up: some that are in the list and some that are not.
+ * @param list   The loaded dataset.
+ * @param count  How many keys of each kind.
+ * @param hits   Receives keys that are present, in random order.
+ * @param misses Receives keys between the smallest and largest ZIP that are absent.
+ */
+void pickLookupKeys(const PostalList &list, size_t count, vector<int> &hits, vector<int> &misses)
+{
+    mt19937_64 random(331);
+    const int32_t *zips = list.getColumns().zipData();
+    size_t rows = list.size();
+    int lowest = *min_element(zips, zips + rows);
+    int highest = *max_element(zips, zips + rows);
+
+    uniform_int_distribution<size_t> anyRow(0, rows - 1);
+    uniform_int_distribution<int> anyZip(lowest, highest);
+    for (size_t i = 0; i < count; i++)
+    {
+        hits.push_back(zips[anyRow(random)]);
+    }
+    // Dense ranges may hold no gaps at all; give up on misses there rather than loop forever
+    for (size_t tries = 0; misses.size() < count && tries < count * 100; tries++)
+    {
+        int zip = anyZip(random);
+        if (list.findByZip(zip) == nullptr)
+        {
+            misses.push_back(zip);
+        }
+    }
+}
+
+/**
+ * @brief Run every benchmark on one dataset.
+ * @param data    The dataset.
+ * @param repeats How many runs to time for each benchmark.
+ * @param results Receives the results.
+ * @return false if the dataset could not be loaded.
+ */
+bool runDataset(const BenchmarkDataset &data, int repeats, vector<BenchmarkResult> &results)
+{
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+
+    // Each run loads a fresh list, so the first prints also pay for building the sort order
+    Samples load;
+    Samples firstByZip;
+    Samples firstByState;
+    PostalList list;
+    for (int r = 0; r < repeats; r++)
+    {
+        list = PostalList();
+        auto start = chrono::steady_clock::now();
+        inputCSVtoList(list, data.csvFile);
+        load.add(millisecondsSince(start));
+        if (list.size() == 0)
+        {
+            cerr << "Error: no records read from " << data.csvFile << endl;
+            return false;
+        }
+
+        TableFormatter formatter(nullStream);
+        start = chrono::steady_clock::now();
+        list.printSortedByZip(formatter);
+        formatter.flush();
+        firstByZip.add(millisecondsSince(start));
+
+        start = chrono::steady_clock::now();
+        list.printSortedByState(formatter);
+        formatter.flush();
+        firstByState.add(millisecondsSince(start));
+    }
+    size_t rows = list.size();
+    addResult(results, data, rows, "load/inputCSVtoList", "macro", "ms", load);
+    addResult(results, data, rows, "print/printSortedByZip/first", "macro", "ms", firstByZip);
+    addResult(results, data, rows, "print/printSortedByState/first", "macro", "ms", firstByState);
+
+    // The sort orders are cached now, so these are the formatting alone
+    Samples byZip;
+    Samples byState;
+    for (int r = 0; r < repeats; r++)
+    {
+        TableFormatter formatter(nullStream);
+        auto start = chrono::steady_clock::now();
+        list.printSortedByZip(formatter);
+        formatter.flush();
+        byZip.add(millisecondsSince(start));
+
+        start = chrono::steady_clock::now();
+        list.printSortedByState(formatter);
+        formatter.flush();
+        byState.add(millisecondsSince(start));
+    }
+    addResult(results, data, rows, "print/printSortedByZip/cached", "macro", "ms", byZip);
+    addResult(results, data, rows, "print/printSortedByState/cached", "macro", "ms", byState);
+
+    vector<int> hits;
+    vector<int> misses;
+    pickLookupKeys(list, 100000, hits, misses);
+    size_t found = 0;
+    auto findInList = [&list](int zip)
+    {
+        return list.findByZip(zip) != nullptr;
+    };
+    addResult(results, data, rows, "lookup/findByZip/hit", "micro", "ns",
+              timeLookups(repeats, hits, findInList, found));
+    if (found != hits.size())
+    {
+        cerr << "Error: findByZip missed present keys in " << data.csvFile << endl;
+        return false;
+    }
+    if (!misses.empty())
+    {
+        addResult(results, data, rows, "lookup/findByZip/miss", "micro", "ns",
+                  timeLookups(repeats, misses, findInList, found));
+    }
+
+    // make_index: scan the length-indicated file and write the sorted index, then map it
+    MappedFile indicated(data.indicatedFile);
+    if (!indicated.isOpen())
+    {
+        cerr << "Error: unable to open " << data.indicatedFile << endl;
+        return false;
+    }
+    string indexFile = data.indicatedFile + ".benchmark_index.bin";
+    Samples build;
+    Samples open;
+    ZipIndexFile index;
+    for (int r = 0; r < repeats; r++)
+    {
+        index.close();
+        auto start = chrono::steady_clock::now();
+        ZipIndexFile::write(indexFile, ZipIndexFile::scan(indicated.data(), indicated.size()), data.indicatedFile);
+        build.add(millisecondsSince(start));
+
+        start = chrono::steady_clock::now();
+        bool opened = index.open(indexFile) && index.find(hits[0]) != nullptr;
+        open.add(millisecondsSince(start));
+        if (!opened)
+        {
+            cerr << "Error: unable to read back " << indexFile << endl;
+            remove(indexFile.c_str());
+            return false;
+        }
+    }
+    addResult(results, data, rows, "make_index/build", "macro", "ms", build);
+    addResult(results, data, rows, "make_index/load", "macro", "ms", open);
+
+    auto findInIndex = [&index](int zip)
+    {
+        return index.find(zip) != nullptr;
+    };
+    addResult(results, data, rows, "make_index/lookup/hit", "micro", "ns",
+              timeLookups(repeats, hits, findInIndex, found));
+    if (!misses.empty())
+    {
+        addResult(results, data, rows, "make_index/lookup/miss", "micro", "ns",
+                  timeLookups(repeats, misses, findInIndex, found));
+    }
+    index.close();
+    remove(indexFile.c_str());
+    return true;
+}
+
+/**
+ * @brief Write a synthetic dataset as a CSV file and a length-indicated file.
+ *
+ * Row i repeats real row i % n. Copy 0 keeps the real ZIP code; copy c > 0
+ * gets zip * 10000 + c. Sorted output lists the rows by that key; randomized
+ * output shuffles them with a fixed seed, so every run writes the same files.
+ *
+ * @param sourceFile    The real CSV file.
+ * @param rows          How many rows to write.
+ * @param shuffled      true for random row order, false for ZIP order.
+ * @param csvFile       The CSV file to write.
+ * @param indicatedFile The length-indicated file to write.
+ * @return true if both files were written.
+ */
+bool writeSyntheticDataset(const string &sourceFile, size_t rows, bool shuffled,
+                           const string &csvFile, const string &indicatedFile)
+{
+    ifstream source(sourceFile);
+    string header;
+    if (!getline(source, header))
+    {
+        return false;
+    }
+
+    // Keep each real row as its ZIP code and the text after it, in ZIP order
+    vector<pair<int, string>> real;
+    string line;
+    while (getline(source, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        size_t comma = line.find(',');
+        int zip = 0;
+        if (comma != string::npos && parseInteger(string_view(line).substr(0, comma), zip))
+        {
+            real.emplace_back(zip, line.substr(comma));
+        }
+    }
+    if (real.empty())
+    {
+        return false;
+    }
+    stable_sort(real.begin(), real.end(), [](const pair<int, string> &a, const pair<int, string> &b)
+                {
+                    return a.first < b.first;
+                });
+    size_t n = real.size();
+
+    ofstream csv(csvFile, ios::binary);
+    ofstream indicated(indicatedFile, ios::binary);
+    string csvBuffer;
+    string indicatedBuffer;
+    auto writeLine = [&](const string &text)
+    {
+        csvBuffer.append(text).push_back('\n');
+        indicatedBuffer.append(to_string(text.size())).append(text).push_back('\n');
+        if (csvBuffer.size() >= (1 << 20))
+        {
+            csv << csvBuffer;
+            indicated << indicatedBuffer;
+            csvBuffer.clear();
+            indicatedBuffer.clear();
+        }
+    };
+    auto writeRow = [&](size_t i)
+    {
+        const pair<int, string> &row = real[i % n];
+        size_t copy = i / n;
+        long long key = (copy == 0) ? row.first : static_cast<long long>(row.first) * 10000 + copy;
+        writeLine(to_string(key) + row.second);
+    };
+
+    writeLine(header);
+    if (shuffled)
+    {
+        vector<uint32_t> order(rows);
+        for (size_t i = 0; i < rows; i++)
+        {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        shuffle(order.begin(), order.end(), mt19937_64(331));
+        for (uint32_t i : order)
+        {
+            writeRow(i);
+        }
+    }
+    else
+    {
+        // Copy 0 of every row (the real codes) sorts below every zip * 10000 + c key
+        for (size_t r = 0; r < n && r < rows; r++)
+        {
+            writeRow(r);
+        }
+        for (size_t r = 0; r < n; r++)
+        {
+            for (size_t i = r + n; i < rows; i += n)
+            {
+                writeRow(i);
+            }
+        }
+    }
+    csv << csvBuffer;
+    indicated << indicatedBuffer;
+    return static_cast<bool>(csv.flush()) && static_cast<bool>(indicated.flush());
+}
+
+/**
+ * @brief Write the results as one JSON document.
+ * @param out     Where to write it.
+ * @param repeats The repeat count the suite ran with.
+ * @param results The results.
+ */
+void writeJSON(ostream &out, int repeats, const vector<BenchmarkResult> &results)
+{
+    out << "{\n"
+        << "  \"suite\": \"benchmark_suite\",\n"
+        << "  \"repeats\": " << repeats << ",\n"
+        << "  \"hardwareThreads\": " << thread::hardware_concurrency() << ",\n"
+        << "  \"results\": [\n";
+    out << setprecision(6);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+        out << "    {\"name\": \"" << result.name << "\", \"kind\": \"" << result.kind
+            << "\", \"dataset\": \"" << result.dataset << "\", \"order\": \"" << result.order
+            << "\", \"rows\": " << result.rows << ", \"unit\": \"" << result.unit
+            << "\", \"best\": " << result.best << ", \"average\": " << result.average
+            << ", \"runs\": " << result.runs << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n"
+        << "}\n";
+}
+
+/**
+ * @brief Runs the suite and prints the results as JSON.
+ * @param argc Argument count.
+ * @param argv Optional repeat count, then the row counts of the synthetic datasets.
+ * @return 0 if every dataset ran, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    int repeats = (argc > 1) ? max(1, stoi(argv[1])) : 5;
+    vector<size_t> syntheticRows;
+    for (int i = 2; i < argc; i++)
+    {
+        syntheticRows.push_back(stoull(argv[i]));
+    }
+    if (argc <= 2)
+    {
+        syntheticRows.push_back(1000000);
+    }
+
+    vector<BenchmarkDataset> datasets = {
+        {"us_postal_codes", "sorted", "us_postal_codes.csv",
+         "us_postal_codes_length_indicated_header_record.txt", 0},
+        {"us_postal_codes", "randomized", "us_postal_codes_ROWS_RANDOMIZED.csv",
+         "us_postal_codes_ROWS_RANDOMIZED_length_indicated_header_record.txt", 0}};
+    for (size_t rows : syntheticRows)
+    {
+        for (string order : {"sorted", "randomized"})
+        {
+            string base = "synthetic_" + to_string(rows) + "_" + order;
+            datasets.push_back({"synthetic_" + to_string(rows), order, base + ".csv",
+                                base + "_length_indicated_header_record.txt", rows});
+        }
+    }
+
+    vector<BenchmarkResult> results;
+    bool ok = true;
+    for (const BenchmarkDataset &data : datasets)
+    {
+        cerr << "Running " << data.name << " (" << data.order << ")" << endl;
+        // Synthetic files are written just before their run and removed after it
+        if (data.generatedRows > 0 &&
+            !writeSyntheticDataset(datasets[0].csvFile, data.generatedRows, data.order == "randomized",
+                                   data.csvFile, data.indicatedFile))
+        {
+            cerr << "Error: unable to write " << data.csvFile << endl;
+            ok = false;
+            continue;
+        }
+        ok = runDataset(data, repeats, results) && ok;
+        if (data.generatedRows > 0)
+        {
+            remove(data.csvFile.c_str());
+            remove(data.indicatedFile.c_str());
+        }
+    }
+
+    writeJSON(cout, repeats, results);
+    return ok ? 0 : 1;
+}
@@ -27,6 +27,7 @@
 #include <string>
 #include "PostalCodeItem.h"
 #include "PostalList.h"
+#include "Metrics.h"
 #include "readCSV.cpp"
 
 using namespace std;
@@ -36,36 +37,61 @@ using namespace std;
  *
  * This main1.cpp will print the postal sorted by zip code.
  *
+ * @param argc Argument count.
+ * @param argv Optional --stats, --stats=json or --stats=prometheus to write
+ * phase timings and counters to standard error at the end.
  * @return 0 if everything went fine.
  *
  * @pre The file @c us_postal_codes.csv is in the same folder and has the expected columns.
  * @post We write the header and then one row per state to standard output.
  */
-int main()
+int main(int argc, char *argv[])
 {
+    // --stats turns on the phase timers and counters
+    bool stats = false;
+    MetricsFormat statsFormat = MetricsFormat::JSON;
+    for (int i = 1; i < argc; i++)
+    {
+        stats = parseStatsFlag(argv[i], statsFormat) || stats;
+    }
+
     // Create a variable for csv file name
     string fileName = "us_postal_codes.csv";
 
+    // Collect the output in one buffer instead of flushing cout on every line
+    TableFormatter formatter(cout);
+
+    // Display the header with the appropriate table
+    formatter.writeText("A table of all the postal sorted by zip:\n\n");
+    formatter.writeHeader();
+
+    // Use the binary snapshot (see make_snapshot) when it is up to date and intact; it needs no parsing
+    PostalSnapshot snapshot;
+    if (snapshot.open(PostalSnapshot::nameFor(fileName)) && !snapshot.isStale(fileName) && snapshot.verify())
+    {
+        snapshot.printSortedByZip(formatter);
+        formatter.flush();
+        if (stats)
+        {
+            Metrics::write(cerr, statsFormat);
+        }
+        return 0;
+    }
+
     // Create an instance for PostalList
     PostalList myPostalList;
 
     // Input the data from the CSV file to the postal list
     inputCSVtoList(myPostalList, fileName);
 
-    // Display the header with the appropriate table
-    cout << "A table of all the postal sorted by zip:" << endl
-         << endl;
-    cout << left << setw(10) << "Zip Code"
-         << setw(20) << "Place Name"
-         << setw(10) << "State"
-         << setw(30) << "County"
-         << setw(12) << "Latitude"
-         << setw(12) << "Longitude"
-         << endl;
-    cout << "-----------------------------------------------------------------------------------------------" << endl;
-
     // Display the table sorted by zip
-    myPostalList.printSortedByZip();
+    myPostalList.printSortedByZip(formatter);
+    formatter.flush();
+
+    if (stats)
+    {
+        Metrics::write(cerr, statsFormat);
+    }
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+/**
+ * @file make_blocks.cpp
+ * @brief Converts a postal code CSV or length-indicated file into a compressed block file.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Loads the input once, writes a PostalBlockFile next to it (same name,
+ * ".zblk" extension) unless another output name is given, and reads every
+ * record back to check it. Files ending in ".txt" are read as the
+ * length-indicated format, everything else as CSV.
+ *
+ * Usage: make_blocks [inputFile] [blockFile]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "PostalBlockFile.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+/**
+ * @brief Converts one input file to a block file and checks the result.
+ * @param argc Argument count.
+ * @param argv Optional input file and block file names.
+ * @return 0 if the block file was written and reads back intact, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    string inputFile = (argc > 1) ? argv[1] : "us_postal_codes_length_indicated_header_record.txt";
+    string blockFile = (argc > 2) ? argv[2] : PostalBlockFile::nameFor(inputFile);
+    bool lengthIndicated = inputFile.size() >= 4 && inputFile.compare(inputFile.size() - 4, 4, ".txt") == 0;
+
+    PostalList list;
+    int rejected = lengthIndicated ? inputLengthIndicatedToList(list, inputFile)
+                                   : inputCSVtoList(list, inputFile);
+    if (list.size() == 0)
+    {
+        cerr << "Error: no records read from " << inputFile << endl;
+        return 1;
+    }
+
+    if (!PostalBlockFile::write(blockFile, list))
+    {
+        cerr << "Error: unable to write " << blockFile << endl;
+        return 1;
+    }
+
+    // Every record must come back in ZIP order with the same values
+    PostalBlockFile blocks;
+    ItemRange expected = list.sortedByZip();
+    size_t row = 0;
+    bool same = true;
+    bool readBack = blocks.open(blockFile) && blocks.size() == expected.size() &&
+                    blocks.scan([&](const BlockRow &found)
+                                {
+                                    const PostalCodeItem &item = expected[row++];
+                                    same = same && found.zip == item.getZip() && found.place == item.getPlaceView() &&
+                                           found.state == item.getStateView() && found.county == item.getCountyView() &&
+                                           found.latitude == item.getLatitude() && found.longitude == item.getLongitude();
+                                });
+    if (!readBack || !same)
+    {
+        cerr << "Error: " << blockFile << " did not read back correctly" << endl;
+        return 1;
+    }
+
+    // Loading it back into a list must give every record too
+    PostalList reloaded;
+    if (blocks.addTo(reloaded) != list.size())
+    {
+        cerr << "Error: " << blockFile << " did not load back into a list" << endl;
+        return 1;
+    }
+
+    cout << "Wrote " << blockFile << ": " << blocks.size() << " records in " << blocks.blockCount()
+         << " blocks, " << blocks.fileBytes() << " bytes";
+    if (rejected > 0)
+    {
+        cout << " (" << rejected << " malformed lines skipped)";
+    }
+    cout << endl;
+    return 0;
+}
@@ -1,124 +1,189 @@
 #include <iostream>
 #include <fstream>
-#include <unordered_map>
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <filesystem>
+#include <string_view>
+#include <charconv>
+#include "MappedFile.h"
+#include "FieldScanner.h"
+#include "ZipIndexFile.h"
+#include "ZipHashIndex.h"
+#include "RecordBatch.h"
+#include "Metrics.h"
 
 const std::string DATA_FILE = "us_postal_codes_length_indicated_header_record.txt";
 const std::string INDEX_FILE = "indexfile.bin";
+const std::string HASH_INDEX_FILE = "indexfile_mph.bin";
+const unsigned MAX_THREADS = 1024;
 
-std::vector<std::string> split(const std::string &s, char delimiter) {
-    std::vector<std::string> result;
-    size_t start = 0, end;
-    while ((end = s.find(delimiter, start)) != std::string::npos) {
-        result.push_back(s.substr(start, end - start));
-        start = end + 1;
-    }
-    result.push_back(s.substr(start));
-    return result;
+void printUsage() {
+    std::cerr << "Usage: make_index [-T<threads>] [-Z<zip>]... [-F<file>] [-H] [--stats[=json|prometheus]]\n"
+              << "  -T<threads>  threads used to build the index, 1 to " << MAX_THREADS << " (default: all cores)\n";
 }
 
-void printRecord(const std::string &line) {
-    auto fields = split(line, ',');
+void printRecord(std::string_view record) {
+    RecordTokenizer tokenizer(record.data(), 0, record.size());
+    std::string_view fields[6];
+    int count = 0;
+    tokenizer.next(fields, 6, count);
     const char *labels[] = {"Zip Code", "Place Name", "State", "County", "Lat", "Long"};
 
-    for (size_t i = 0; i < fields.size() && i < 6; ++i) {
+    for (int i = 0; i < count && i < 6; ++i) {
         std::cout << labels[i] << ": " << fields[i] << "\n";
     }
     std::cout << "\n";
 }
 
-int main(int argc, char *argv[]) {
-    std::unordered_map<std::string, std::streampos> index;
-
-    if (std::filesystem::exists(INDEX_FILE)) {
-        std::ifstream idx(INDEX_FILE, std::ios::binary);
-        if (!idx.is_open()) {
-            std::cerr << "Error: unable to open " << INDEX_FILE << "\n";
-            return 1;
-        }
-
-        while (true) {
-            uint8_t len;
-            if (!idx.read(reinterpret_cast<char*>(&len), sizeof(len))) break;
-            std::string zip(len, '\0');
-            idx.read(zip.data(), len);
-            uint64_t offset;
-            idx.read(reinterpret_cast<char*>(&offset), sizeof(offset));
-            index[zip] = static_cast<std::streampos>(offset);
-        }
-
-        idx.close();
-        std::cout << "Loaded existing index file: " << INDEX_FILE
-                  << " (" << index.size() << " entries)\n";
-    } else {
-        std::cout << "Index not found, building new one...\n";
-
-        std::ifstream data(DATA_FILE, std::ios::binary);
-        if (!data.is_open()) {
-            std::cerr << "Error: unable to open " << DATA_FILE << "\n";
-            return 1;
-        }
-
-        std::string header;
-        std::getline(data, header);
-        std::string line;
-        while (true) {
-            std::streampos pos = data.tellg();
-            if (!std::getline(data, line)) break;
-            if (line.empty()) continue;
-            if (!line.empty() && line.back() == '\r')
-                line.pop_back();
-
-            std::string zip = line.substr(0, line.find(','));
-            index[zip] = pos;
+// Where each requested ZIP's record is in the data file; unknown ZIPs get RecordBatch::MISSING
+std::vector<ZipIndexEntry> locateInSorted(const ZipIndexFile &index, const std::vector<std::string> &zips) {
+    std::vector<ZipIndexEntry> requests(zips.size(), {0, 0, RecordBatch::MISSING});
+    for (size_t i = 0; i < zips.size(); ++i) {
+        if (!parseInteger(zips[i], requests[i].zip))
+            continue;
+        const ZipIndexEntry *entry;
+        {
+            LatencyTimer timer(MetricHistogram::IndexLookup);
+            entry = index.find(requests[i].zip);
         }
-        data.close();
+        if (entry != nullptr)
+            requests[i] = *entry;
+    }
+    return requests;
+}
 
-        std::ofstream idx(INDEX_FILE, std::ios::binary);
-        for (const auto &[zip, offset] : index) {
-            uint8_t len = static_cast<uint8_t>(zip.size());
-            uint64_t off = static_cast<uint64_t>(offset);
-            idx.write(reinterpret_cast<const char*>(&len), sizeof(len));
-            idx.write(zip.data(), len);
-            idx.write(reinterpret_cast<const char*>(&off), sizeof(off));
+// The hash index has no record lengths, so each record is read to the end of its line
+std::vector<ZipIndexEntry> locateInHash(const ZipHashIndex &index, const std::vector<std::string> &zips) {
+    std::vector<ZipIndexEntry> requests(zips.size(), {0, 0, RecordBatch::MISSING});
+    for (size_t i = 0; i < zips.size(); ++i) {
+        if (parseInteger(zips[i], requests[i].zip)) {
+            LatencyTimer timer(MetricHistogram::IndexLookup);
+            requests[i].offset = index.find(requests[i].zip);
         }
-        idx.close();
+    }
+    return requests;
+}
 
-        std::cout << "Index built and written to " << INDEX_FILE
+// Open an index file, rebuilding it from the data file if it is missing, old or out of date
+template <typename Index, typename Write>
+bool openIndex(Index &index, const std::string &fileName, Write write) {
+    bool opened;
+    {
+        PhaseTimer timer(MetricPhase::Read);
+        opened = index.open(fileName) && !index.isStale(DATA_FILE);
+    }
+    if (opened) {
+        std::cout << "Loaded existing index file: " << fileName
                   << " (" << index.size() << " entries)\n";
+        return true;
+    }
+    std::cout << "Index not found or out of date, building new one...\n";
+    index.close();
+    bool built;
+    {
+        PhaseTimer timer(MetricPhase::IndexBuild);
+        built = write() && index.open(fileName);
+    }
+    if (!built) {
+        std::cerr << "Error: unable to write " << fileName << "\n";
+        return false;
     }
+    std::cout << "Index built and written to " << fileName
+              << " (" << index.size() << " entries)\n";
+    return true;
+}
 
+int main(int argc, char *argv[]) {
+    // -T<n> sets the number of threads used to build the index (default: all cores)
+    // -Z<zip> looks up one ZIP code; -F<file> looks up every ZIP code listed in a file
+    // -H uses the minimal perfect hash index instead of the sorted one
+    // --stats (or --stats=json / --stats=prometheus) writes timings and counters to stderr at the end
+    unsigned threadCount = 0;
+    bool useHash = false;
+    bool stats = false;
+    MetricsFormat statsFormat = MetricsFormat::JSON;
     std::vector<std::string> zips;
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
-        if (arg.rfind("-Z", 0) == 0)
+        if (arg.rfind("-T", 0) == 0) {
+            const char *first = arg.data() + 2;
+            const char *last = arg.data() + arg.size();
+            std::from_chars_result result = std::from_chars(first, last, threadCount);
+            if (result.ec != std::errc() || result.ptr != last || threadCount == 0 || threadCount > MAX_THREADS) {
+                std::cerr << "Error: bad thread count " << arg << "\n";
+                printUsage();
+                return 1;
+            }
+        } else if (arg.rfind("-Z", 0) == 0)
             zips.push_back(arg.substr(2));
+        else if (arg.rfind("-F", 0) == 0) {
+            std::ifstream list(arg.substr(2));
+            if (!list) {
+                std::cerr << "Error: unable to open " << arg.substr(2) << "\n";
+                return 1;
+            }
+            std::string zip;
+            while (list >> zip)
+                zips.push_back(zip);
+        } else if (arg == "-H")
+            useHash = true;
+        else if (parseStatsFlag(arg, statsFormat))
+            stats = true;
     }
 
-    std::ifstream data(DATA_FILE, std::ios::binary);
-    if (!data.is_open()) {
+    MappedFile data;
+    {
+        PhaseTimer timer(MetricPhase::Read);
+        data.open(DATA_FILE, AccessPattern::Random);
+    }
+    if (!data.isOpen()) {
         std::cerr << "Error: unable to open " << DATA_FILE << "\n";
         return 1;
     }
+    Metrics::add(MetricCounter::BytesRead, data.size());
+
+    // The index is mapped, not loaded, so opening it costs the same at any size.
+    // Every ZIP is resolved first; the records are then read in one pass in file order.
+    std::vector<ZipIndexEntry> requests;
+    if (useHash) {
+        ZipHashIndex index;
+        if (!openIndex(index, HASH_INDEX_FILE, [&]() {
+                return ZipHashIndex::write(HASH_INDEX_FILE, ZipIndexFile::scan(data.data(), data.size(), threadCount),
+                                           DATA_FILE);
+            }))
+            return 1;
+        requests = locateInHash(index, zips);
+    } else {
+        ZipIndexFile index;
+        if (!openIndex(index, INDEX_FILE, [&]() {
+                return ZipIndexFile::write(INDEX_FILE, ZipIndexFile::scan(data.data(), data.size(), threadCount),
+                                           DATA_FILE);
+            }))
+            return 1;
+        requests = locateInSorted(index, zips);
+    }
 
-    for (const auto &zip : zips) {
-        if (index.find(zip) == index.end()) {
-            std::cout << zip << " not found.\n\n";
-            continue;
+    RecordBatch batch;
+    {
+        PhaseTimer timer(MetricPhase::Read);
+        batch.fetch(data, requests);
+    }
+    {
+        PhaseTimer timer(MetricPhase::Output);
+        for (size_t i = 0; i < zips.size(); ++i) {
+            // The hash index maps unknown ZIPs to some record, so check that it is the right one
+            if (!batch.found(i) || (useHash && !ZipHashIndex::matches(batch.record(i), requests[i].zip))) {
+                Metrics::add(MetricCounter::IndexMisses);
+                std::cout << zips[i] << " not found.\n\n";
+                continue;
+            }
+            Metrics::add(MetricCounter::IndexHits);
+            printRecord(batch.record(i));
         }
-
-        data.clear();
-        data.seekg(index[zip]);
-        std::string line;
-        std::getline(data, line);
-        if (!line.empty() && line.back() == '\r')
-            line.pop_back();
-
-        printRecord(line);
+        std::cout.flush();
     }
 
+    if (stats)
+        Metrics::write(std::cerr, statsFormat);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,79 @@
+/**
+ * @file make_snapshot.cpp
+ * @brief Converts a postal code CSV or length-indicated file into a binary snapshot.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Loads the input once, then writes a PostalSnapshot file next to it (same
+ * name, ".snap" extension) unless another output name is given. main1 and
+ * main2 open that snapshot instead of parsing the CSV when it is present and
+ * newer than its source. Files ending in ".txt" are read as the
+ * length-indicated format, everything else as CSV.
+ *
+ * Usage: make_snapshot [inputFile] [snapshotFile]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "PostalSnapshot.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+/**
+ * @brief Converts one input file to a snapshot and checks the result.
+ * @param argc Argument count.
+ * @param argv Optional input file and snapshot file names.
+ * @return 0 if the snapshot was written and reads back intact, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    string inputFile = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    string snapshotFile = (argc > 2) ? argv[2] : PostalSnapshot::nameFor(inputFile);
+    bool lengthIndicated = inputFile.size() >= 4 && inputFile.compare(inputFile.size() - 4, 4, ".txt") == 0;
+
+    PostalList list;
+    int rejected = lengthIndicated ? inputLengthIndicatedToList(list, inputFile)
+                                   : inputCSVtoList(list, inputFile);
+    if (list.size() == 0)
+    {
+        cerr << "Error: no records read from " << inputFile << endl;
+        return 1;
+    }
+
+    if (!list.saveSnapshot(snapshotFile, inputFile))
+    {
+        cerr << "Error: unable to write " << snapshotFile << endl;
+        return 1;
+    }
+
+    PostalSnapshot snapshot;
+    if (!snapshot.open(snapshotFile) || !snapshot.verify() || snapshot.size() != static_cast<size_t>(list.size()))
+    {
+        cerr << "Error: " << snapshotFile << " did not read back correctly" << endl;
+        return 1;
+    }
+
+    cout << "Wrote " << snapshotFile << ": " << snapshot.size() << " records from " << inputFile;
+    if (rejected > 0)
+    {
+        cout << " (" << rejected << " malformed lines skipped)";
+    }
+    cout << endl;
+    return 0;
+}
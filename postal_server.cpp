@@ -0,0 +1,226 @@
+/**
+ * @file postal_server.cpp
+ * @brief Long-running query server: loads the postal data once and answers queries over a Unix socket.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Loads the input (from its snapshot when that is up to date, see
+ * make_snapshot), builds the indexes once, then serves the line protocol
+ * described in QueryService.h until SIGINT or SIGTERM.
+ *
+ * The data is reloaded without a restart on SIGHUP, or when the input file's
+ * size or modification time changes (checked every reloadSeconds; 0 turns
+ * the check off). A background thread loads and indexes the new file while
+ * queries keep running on the old data, then swaps it in (see LiveDataset.h).
+ * With "-" as the
+ * socket it reads requests from stdin and writes responses to stdout
+ * instead, which is handy for testing:
+ *
+ *   printf 'ZIP 55455\nNEAREST 44.97 -93.23 3\n' | ./postal_server us_postal_codes.csv -
+ *
+ * Usage: postal_server [inputFile] [socketPath|-] [threads] [reloadSeconds]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include <chrono>
+#include <csignal>
+#include <thread>
+#include <atomic>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "PostalSnapshot.h"
+#include "LiveDataset.h"
+#include "MappedFile.h"
+#include "FieldScanner.h"
+#include "QueryServer.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+QueryServer *activeServer = nullptr;   /**< The server SIGINT/SIGTERM stop */
+volatile sig_atomic_t reloadRequested; /**< Set by SIGHUP */
+
+/**
+ * @brief Stop the server on SIGINT or SIGTERM.
+ * @param signal The signal number (unused).
+ */
+void stopServer(int signal)
+{
+    (void)signal;
+    if (activeServer)
+    {
+        activeServer->stop();
+    }
+}
+
+/**
+ * @brief Ask for a reload on SIGHUP.
+ * @param signal The signal number (unused).
+ */
+void requestReload(int signal)
+{
+    (void)signal;
+    reloadRequested = 1;
+}
+
+/**
+ * @brief Load a CSV or length-indicated file, through its snapshot when that is up to date and intact.
+ * @param inputFile The file.
+ * @param list      Receives the records.
+ */
+void loadList(const string &inputFile, PostalList &list)
+{
+    bool lengthIndicated = inputFile.size() >= 4 && inputFile.compare(inputFile.size() - 4, 4, ".txt") == 0;
+    PostalSnapshot snapshot;
+    if (snapshot.open(PostalSnapshot::nameFor(inputFile)) && !snapshot.isStale(inputFile) && snapshot.verify())
+    {
+        list.addSnapshot(snapshot);
+    }
+    else if (lengthIndicated)
+    {
+        inputLengthIndicatedToList(list, inputFile);
+    }
+    else
+    {
+        inputCSVtoList(list, inputFile);
+    }
+}
+
+/**
+ * @brief Reload the data on SIGHUP or when the input file changes, until @p done is set.
+ * @param inputFile     The file to watch.
+ * @param live          Where new data is published.
+ * @param reloadSeconds How often to check the file (0 = only on SIGHUP).
+ * @param done          Set when the server stops.
+ */
+void watchInput(const string &inputFile, LiveDataset &live, unsigned reloadSeconds, const atomic<bool> &done)
+{
+    // Loading runs at the lowest priority so query threads keep their CPU time
+    // (on Linux the nice value of a single thread can be set through its id)
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+
+    uint64_t size = 0;
+    int64_t modified = 0;
+    fileStamp(inputFile, size, modified);
+    auto lastCheck = chrono::steady_clock::now();
+
+    while (!done)
+    {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        bool reload = reloadRequested != 0;
+        if (reloadSeconds > 0 && chrono::steady_clock::now() - lastCheck >= chrono::seconds(reloadSeconds))
+        {
+            lastCheck = chrono::steady_clock::now();
+            uint64_t newSize = 0;
+            int64_t newModified = 0;
+            if (fileStamp(inputFile, newSize, newModified) && (newSize != size || newModified != modified))
+            {
+                reload = true;
+            }
+        }
+        if (!reload)
+        {
+            live.reclaim();
+            continue;
+        }
+        reloadRequested = 0;
+        fileStamp(inputFile, size, modified);
+
+        auto start = chrono::steady_clock::now();
+        PostalList next;
+        loadList(inputFile, next);
+        if (next.size() == 0)
+        {
+            cerr << "Reload of " << inputFile << " read no records; keeping the current data" << endl;
+            continue;
+        }
+        int records = next.size();
+        uint64_t version = live.publish(move(next));
+        chrono::duration<double, milli> took = chrono::steady_clock::now() - start;
+        cerr << "Reloaded " << records << " records from " << inputFile << " as version " << version << " in "
+             << took.count() << " ms" << endl;
+    }
+}
+
+/**
+ * @brief Loads the data and serves queries until stopped.
+ * @param argc Argument count.
+ * @param argv Optional input file, socket path ("-" for stdin/stdout), worker thread count and reload check interval.
+ * @return 0 after a clean shutdown, 1 for bad arguments or if the data or the socket cannot be set up.
+ */
+int main(int argc, char *argv[])
+{
+    string inputFile = (argc > 1) ? argv[1] : "us_postal_codes.csv";
+    string socketPath = (argc > 2) ? argv[2] : "/tmp/postal_server.sock";
+    int threads = 0;
+    int reloadSeconds = 10;
+    if ((argc > 3 && (!parseInteger(argv[3], threads) || threads < 0 ||
+                      threads > static_cast<int>(LiveDataset::MAX_READER_THREADS))) ||
+        (argc > 4 && (!parseInteger(argv[4], reloadSeconds) || reloadSeconds < 0)))
+    {
+        cerr << "Usage: postal_server [inputFile] [socketPath|-] [threads] [reloadSeconds]" << endl;
+        cerr << "threads: 0 (one per hardware thread) to " << LiveDataset::MAX_READER_THREADS
+             << "; reloadSeconds: 0 (no check) or more" << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    PostalList list;
+    loadList(inputFile, list);
+    if (list.size() == 0)
+    {
+        cerr << "Error: no records read from " << inputFile << endl;
+        return 1;
+    }
+    int records = list.size();
+    LiveDataset live(move(list));
+    QueryServer server(live, threads);
+    chrono::duration<double, milli> loaded = chrono::steady_clock::now() - start;
+
+    // A client that goes away must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    if (socketPath == "-")
+    {
+        server.serve(0, 1);
+        return 0;
+    }
+
+    if (!server.listen(socketPath))
+    {
+        cerr << "Error: unable to listen on " << socketPath << endl;
+        return 1;
+    }
+    activeServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+    signal(SIGHUP, requestReload);
+    cerr << "Serving " << records << " records from " << inputFile << " on " << socketPath << " (ready in "
+         << loaded.count() << " ms)" << endl;
+
+    atomic<bool> done(false);
+    thread watcher(watchInput, inputFile, ref(live), reloadSeconds, cref(done));
+    server.run();
+    done = true;
+    watcher.join();
+    activeServer = nullptr;
+    cerr << "Stopped" << endl;
+    return 0;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file query_client.cpp
+ * @brief Load generator for postal_server: sends a mix of queries and reports throughput and latency.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Opens several connections to the server's socket. Each connection keeps up
+ * to "depth" requests in flight (pipelining): it sends until the window is
+ * full, then reads responses, and times each request from the moment it was
+ * written to the moment its whole response arrived. The mix is 40% ZIP
+ * lookups, 20% small ZIP ranges, 15% STATE with a limit of 25 and 25%
+ * NEAREST with k = 5, all with random arguments. At the end it prints the
+ * queries per second and the p50, p99 and p99.9 latency.
+ *
+ * Usage: query_client [socketPath] [connections] [requestsPerConnection] [depth]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+const char *STATES[] = {"AL", "AK", "AZ", "AR", "CA", "CO", "CT", "DE", "FL", "GA", "HI", "ID", "IL", "IN",
+                        "IA", "KS", "KY", "LA", "ME", "MD", "MA", "MI", "MN", "MS", "MO", "MT", "NE", "NV",
+                        "NH", "NJ", "NM", "NY", "NC", "ND", "OH", "OK", "OR", "PA", "RI", "SC", "SD", "TN",
+                        "TX", "UT", "VT", "VA", "WA", "WV", "WI", "WY"};
+
+/**
+ * @brief Results of one connection.
+ */
+struct ConnectionResult
+{
+    vector<double> micros; /**< Latency of each request */
+    size_t errors = 0;     /**< ERR responses */
+    bool failed = false;   /**< The connection broke */
+};
+
+/**
+ * @brief Connect to the server's socket.
+ * @param path The socket file.
+ * @return The socket, or -1.
+ */
+int connectTo(const string &path)
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Make one random request line.
+ * @param random The generator.
+ * @return The request, ending with '\n'.
+ */
+string makeRequest(mt19937 &random)
+{
+    uniform_int_distribution<int> kind(0, 99);
+    uniform_int_distribution<int> zip(501, 99950);
+    uniform_real_distribution<double> lat(25.0, 49.0);
+    uniform_real_distribution<double> lon(-124.0, -67.0);
+    int pick = kind(random);
+    if (pick < 40)
+    {
+        return "ZIP " + to_string(zip(random)) + "\n";
+    }
+    if (pick < 60)
+    {
+        int low = zip(random);
+        return "RANGE " + to_string(low) + " " + to_string(low + 50) + "\n";
+    }
+    if (pick < 75)
+    {
+        return string("STATE ") + STATES[random() % (sizeof(STATES) / sizeof(STATES[0]))] + " 25\n";
+    }
+    return "NEAREST " + to_string(lat(random)) + " " + to_string(lon(random)) + " 5\n";
+}
+
+/**
+ * @brief Run one connection's share of the load.
+ * @param path     The socket file.
+ * @param requests How many requests to send.
+ * @param depth    The most requests in flight.
+ * @param seed     Seed for the request mix.
+ * @param result   Receives the latencies.
+ */
+void runConnection(const string &path, size_t requests, size_t depth, unsigned seed, ConnectionResult &result)
+{
+    int fd = connectTo(path);
+    if (fd < 0)
+    {
+        result.failed = true;
+        return;
+    }
+    mt19937 random(seed);
+    deque<chrono::steady_clock::time_point> inFlight;
+    string buffer;
+    size_t scanned = 0;  // bytes of buffer already split into lines
+    size_t expected = 0; // record lines still owed by the current response (0 = next line is a status)
+    bool inResponse = false;
+    size_t sent = 0;
+    char block[1 << 16];
+    result.micros.reserve(requests);
+
+    while (result.micros.size() < requests)
+    {
+        // Fill the window with one write
+        string out;
+        while (sent < requests && inFlight.size() < depth)
+        {
+            out += makeRequest(random);
+            inFlight.push_back(chrono::steady_clock::now());
+            sent++;
+        }
+        if (!out.empty() && write(fd, out.data(), out.size()) != static_cast<ssize_t>(out.size()))
+        {
+            result.failed = true;
+            break;
+        }
+
+        ssize_t got = read(fd, block, sizeof(block));
+        if (got <= 0)
+        {
+            result.failed = true;
+            break;
+        }
+        buffer.append(block, static_cast<size_t>(got));
+
+        // A response is "OK n" and n records, or one "ERR ..." line
+        for (size_t end = buffer.find('\n', scanned); end != string::npos; end = buffer.find('\n', scanned))
+        {
+            string_view line(buffer.data() + scanned, end - scanned);
+            scanned = end + 1;
+            if (inResponse)
+            {
+                inResponse = --expected > 0;
+            }
+            else if (line.compare(0, 3, "OK ") == 0)
+            {
+                expected = stoul(string(line.substr(3)));
+                inResponse = expected > 0;
+            }
+            else
+            {
+                result.errors++;
+            }
+            if (!inResponse)
+            {
+                chrono::duration<double, micro> elapsed = chrono::steady_clock::now() - inFlight.front();
+                result.micros.push_back(elapsed.count());
+                inFlight.pop_front();
+            }
+        }
+        buffer.erase(0, scanned);
+        scanned = 0;
+    }
+    close(fd);
+}
+
+/**
+ * @brief Runs the load and prints the summary.
+ * @param argc Argument count.
+ * @param argv Optional socket path, connection count, requests per connection and pipeline depth.
+ * @return 0 if every connection finished, 1 otherwise.
+ */
+int main(int argc, char *argv[])
+{
+    string path = (argc > 1) ? argv[1] : "/tmp/postal_server.sock";
+    size_t connections = (argc > 2) ? stoul(argv[2]) : 4;
+    size_t requests = (argc > 3) ? stoul(argv[3]) : 50000;
+    size_t depth = (argc > 4) ? max<size_t>(1, stoul(argv[4])) : 16;
+
+    vector<ConnectionResult> results(connections);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (size_t c = 0; c < connections; c++)
+    {
+        threads.emplace_back(runConnection, path, requests, depth, static_cast<unsigned>(c + 1), ref(results[c]));
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    chrono::duration<double> wall = chrono::steady_clock::now() - start;
+
+    vector<double> micros;
+    size_t errors = 0;
+    size_t failed = 0;
+    for (const ConnectionResult &result : results)
+    {
+        micros.insert(micros.end(), result.micros.begin(), result.micros.end());
+        errors += result.errors;
+        failed += result.failed;
+    }
+    if (micros.empty())
+    {
+        cerr << "Error: no responses from " << path << endl;
+        return 1;
+    }
+    sort(micros.begin(), micros.end());
+    auto percentile = [&](double p)
+    { return micros[min(micros.size() - 1, static_cast<size_t>(p * micros.size()))]; };
+
+    cout << micros.size() << " requests over " << connections << " connections, depth " << depth << ", in "
+         << wall.count() << " s" << endl;
+    cout << "  " << static_cast<long long>(micros.size() / wall.count()) << " queries/s" << endl;
+    cout << "  latency p50 " << percentile(0.50) << " us, p99 " << percentile(0.99) << " us, p99.9 "
+         << percentile(0.999) << " us, max " << micros.back() << " us" << endl;
+    if (errors > 0 || failed > 0)
+    {
+        cout << "  " << errors << " error responses, " << failed << " connections failed" << endl;
+    }
+    return failed > 0 ? 1 : 0;
+}
@@ -8,6 +8,8 @@
  * @details
  * This file defines functions that read U.S. postal code data stored in a CSV file
  * and populate a PostalList object. Each line of the CSV contains one postal record.
+ * The default loader memory-maps the file and splits each record in place, so
+ * the only strings it builds are the ones stored in the finished items.
  *
  * @authors
  *  - Tran, Minh Quan
@@ -23,18 +25,324 @@
  */
 
 #include <string>
+#include <string_view>
+#include <algorithm>
 #include "PostalCodeItem.h"
 #include "PostalList.h"
+#include "MappedFile.h"
+#include "RecordBoundaries.h"
+#include "ParallelFor.h"
+#include "FieldScanner.h"
+#include "Metrics.h"
 #include <fstream>
 
 using namespace std;
 
+/**
+ * @brief Turn the fields of one CSV record into a PostalCodeItem.
+ *
+ * The item's text fields point straight at @p fields, so nothing is copied
+ * or allocated here: the item is only good while the file stays mapped.
+ * PostalList::addItem() makes the lasting copy of each name.
+ *
+ * @param fields     The record's fields (from RecordTokenizer).
+ * @param fieldCount How many fields the record had.
+ * @param item       Receives the parsed fields.
+ * @return true if the record had six fields and its numbers parsed.
+ */
+bool parseCSVRecord(const string_view fields[], int fieldCount, PostalCodeItem &item)
+{
+    int zip = 0;
+    double latitude = 0;
+    double longitude = 0;
+
+    if (fieldCount != 6 ||
+        !parseInteger(fields[0], zip) ||
+        !parseDecimal(fields[4], latitude) ||
+        !parseDecimal(fields[5], longitude))
+    {
+        return false;
+    }
+
+    item = PostalCodeItem::withSharedStrings(zip, fields[1], fields[2], fields[3], latitude, longitude);
+    return true;
+}
+
+/**
+ * @brief Guess how many lines [begin, size) holds from the line lengths near its start.
+ *
+ * Used to reserve the list before loading, so the item vector and the
+ * columns are allocated once instead of doubling their way up.
+ *
+ * @param data  The file contents.
+ * @param size  The file size.
+ * @param begin Offset of the first data line.
+ * @return The estimated line count, rounded up a little so a slightly longer
+ * sample does not leave the last few rows to a regrow.
+ */
+size_t estimateLineCount(const char *data, size_t size, size_t begin)
+{
+    size_t sampleEnd = min(size, begin + (size_t(1) << 16));
+    size_t lines = count(data + begin, data + sampleEnd, '\n');
+    if (lines == 0 || sampleEnd == begin)
+    {
+        return 0;
+    }
+    size_t estimate = static_cast<size_t>(static_cast<double>(size - begin) * lines / (sampleEnd - begin));
+    return estimate + estimate / 32 + 1;
+}
+
+/**
+ * @brief Parse every CSV line in [begin, end) and hand the items to @p sink.
+ * @param data  The file contents.
+ * @param begin Offset of the first line (must be a line start).
+ * @param end   Offset to stop at (a line start or the file size).
+ * @param sink  Called with each finished PostalCodeItem, in file order; the
+ *              item views into @p data and may be moved from.
+ * @return The number of non-blank lines that did not parse.
+ */
+template <typename Sink>
+int parseCSVLines(const char *data, size_t begin, size_t end, Sink &&sink)
+{
+    RecordTokenizer tokenizer(data, begin, end);
+    string_view fields[6];
+    int fieldCount = 0;
+    PostalCodeItem item;
+    int rejected = 0;
+
+    while (tokenizer.next(fields, 6, fieldCount))
+    {
+        if (parseCSVRecord(fields, fieldCount, item))
+        {
+            sink(item);
+        }
+        else
+        {
+            rejected++;
+        }
+    }
+    return rejected;
+}
+
+/**
+ * @brief Parse every length-indicated line in [begin, end) and hand the items to @p sink.
+ *
+ * Lines are split like CSV lines; the length prefix is then taken off the
+ * front of the first field, which holds the length and the ZIP run together.
+ *
+ * @param data  The file contents.
+ * @param begin Offset of the first line (must be a line start).
+ * @param end   Offset to stop at (a line start or the file size).
+ * @param sink  Called with each finished PostalCodeItem, in file order; the
+ *              item views into @p data and may be moved from.
+ * @return The number of non-blank lines that did not parse.
+ */
+template <typename Sink>
+int parseLengthIndicatedLines(const char *data, size_t begin, size_t end, Sink &&sink)
+{
+    RecordTokenizer tokenizer(data, begin, end);
+    string_view fields[6];
+    int fieldCount = 0;
+    PostalCodeItem item;
+    int rejected = 0;
+
+    while (tokenizer.next(fields, 6, fieldCount))
+    {
+        // The last field ends where the line does
+        int last = min(fieldCount, 6) - 1;
+        const char *lineStart = fields[0].data();
+        size_t lineLength = (fields[last].data() + fields[last].size()) - lineStart;
+        size_t width = (fieldCount == 6) ? lengthPrefixWidth(lineStart, lineLength) : 0;
+
+        if (width > 0 && width < fields[0].size())
+        {
+            fields[0].remove_prefix(width);
+            if (parseCSVRecord(fields, fieldCount, item))
+            {
+                sink(item);
+                continue;
+            }
+        }
+        rejected++;
+    }
+    return rejected;
+}
+
+/**
+ * @brief Shared driver for the parallel loaders.
+ *
+ * Splits the data after the header into chunks on line boundaries and parses
+ * the chunks on a pool of threads. Each worker puts its rows straight into its
+ * own PostalColumns, so the name hashing and copying happens in parallel too.
+ * The chunks are then added to the list in chunk order with
+ * PostalList::addColumns(), which only interns each chunk's distinct names,
+ * so the rows and their ids end up exactly as a serial load would leave them.
+ *
+ * @param inputList       Where we store all the items.
+ * @param fileName        The file we open.
+ * @param threadCount     Worker threads (0 = one per hardware thread).
+ * @param lengthIndicated true for the script.py format, false for plain CSV.
+ * @return The number of data lines that were skipped because they did not parse.
+ */
+int inputFileToListParallel(PostalList &inputList, const string &fileName, unsigned threadCount, bool lengthIndicated)
+{
+    MappedFile file;
+    {
+        PhaseTimer timer(MetricPhase::Read);
+        file.open(fileName);
+    }
+    if (!file.isOpen() || file.size() == 0)
+    {
+        return 0;
+    }
+    Metrics::add(MetricCounter::BytesRead, file.size());
+
+    const char *data = file.data();
+    size_t size = file.size();
+    size_t begin = nextLineStart(data, size, 0); // skip the header
+
+    // A few chunks per thread evens out chunks that happen to parse slower
+    unsigned threads = workerCount(threadCount);
+    size_t chunkCount = (threads == 1) ? 1 : threads * 4;
+    vector<size_t> bounds = splitAtRecordBoundaries(data, size, begin, chunkCount);
+
+    vector<PostalColumns> chunks(chunkCount);
+    vector<int> rejected(chunkCount, 0);
+
+    {
+        PhaseTimer timer(MetricPhase::Parse);
+        parallelFor(chunkCount, threads, [&](size_t chunk)
+                    {
+                        PostalColumns &out = chunks[chunk];
+                        out.reserve(estimateLineCount(data, bounds[chunk + 1], bounds[chunk]));
+                        auto sink = [&out](const PostalCodeItem &item)
+                        {
+                            out.append(item);
+                        };
+                        rejected[chunk] = lengthIndicated
+                                              ? parseLengthIndicatedLines(data, bounds[chunk], bounds[chunk + 1], sink)
+                                              : parseCSVLines(data, bounds[chunk], bounds[chunk + 1], sink);
+                    });
+    }
+
+    PhaseTimer timer(MetricPhase::Insert);
+    size_t before = inputList.size();
+    size_t parsed = 0;
+    for (const PostalColumns &chunk : chunks)
+    {
+        parsed += chunk.size();
+    }
+    inputList.reserve(before + parsed);
+    int totalRejected = 0;
+    for (size_t chunk = 0; chunk < chunkCount; chunk++)
+    {
+        inputList.addColumns(chunks[chunk]);
+        // Free each chunk as soon as it is merged to keep the peak memory down
+        chunks[chunk] = PostalColumns();
+        totalRejected += rejected[chunk];
+    }
+    Metrics::add(MetricCounter::RowsLoaded, inputList.size() - before);
+    Metrics::add(MetricCounter::RowsRejected, totalRejected);
+    return totalRejected;
+}
+
 /**
  * @brief Reads the CSV and adds each row to the list.
  *
  * The file has a header, then each line has 6 pieces:
  * ZIP, Place, State, County, Latitude, Longitude
  *
+ * The file is memory-mapped and split in place by RecordTokenizer, which
+ * finds all commas and newlines with SIMD compares. The parsed item views its
+ * text fields in the mapping, and the list copies only names it has not seen
+ * before into its string pool, so most rows allocate nothing.
+ *
+ * @param inputList Where we store all the items.
+ * @param fileName  The CSV file we open.
+ * @return The number of data lines that were skipped because they did not parse.
+ *
+ * @pre
+ *  - Lines are simple comma-separated (no quotes/commas inside fields).
+ * @post
+ *  - Every good line becomes a PostalCodeItem in @p inputList, in file order.
+ *  - The mapping is released before we leave.
+ *
+ * @note A file that cannot be opened adds nothing, like the stream loader.
+ *       Windows (\r\n) line endings and blank lines are accepted.
+ */
+int inputCSVtoList(PostalList &inputList, string fileName)
+{
+    MappedFile file;
+    {
+        PhaseTimer timer(MetricPhase::Read);
+        file.open(fileName);
+    }
+    if (!file.isOpen() || file.size() == 0)
+    {
+        return 0;
+    }
+    Metrics::add(MetricCounter::BytesRead, file.size());
+
+    // Skip the header: "zip,place,state,county,latitude,longitude"
+    size_t begin = nextLineStart(file.data(), file.size(), 0);
+
+    // Rows are added as they are parsed, so the insert time is part of the parse phase here
+    PhaseTimer timer(MetricPhase::Parse);
+    size_t before = inputList.size();
+    inputList.reserve(before + estimateLineCount(file.data(), file.size(), begin));
+    int rejected = parseCSVLines(file.data(), begin, file.size(), [&inputList](const PostalCodeItem &item)
+                                 {
+                                     // Add it to our list
+                                     inputList.addItem(item);
+                                 });
+    Metrics::add(MetricCounter::RowsLoaded, inputList.size() - before);
+    Metrics::add(MetricCounter::RowsRejected, rejected);
+    return rejected;
+}
+
+/**
+ * @brief Reads the CSV on several threads and adds each row to the list.
+ *
+ * Same input, result and row order as inputCSVtoList(), but the file is cut
+ * into chunks on line boundaries that are parsed in parallel.
+ *
+ * @param inputList   Where we store all the items.
+ * @param fileName    The CSV file we open.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ * @return The number of data lines that were skipped because they did not parse.
+ */
+int inputCSVtoListParallel(PostalList &inputList, string fileName, unsigned threadCount = 0)
+{
+    return inputFileToListParallel(inputList, fileName, threadCount, false);
+}
+
+/**
+ * @brief Reads a length-indicated file (written by script.py) and adds each row to the list.
+ *
+ * Every line is the record length followed by the CSV record, and the first
+ * line is the header. The file is parsed on several threads like
+ * inputCSVtoListParallel(), and rows keep their file order.
+ *
+ * @param inputList   Where we store all the items.
+ * @param fileName    The length-indicated file we open.
+ * @param threadCount Worker threads (0 = one per hardware thread).
+ * @return The number of data lines that were skipped because they did not parse.
+ */
+int inputLengthIndicatedToList(PostalList &inputList, string fileName, unsigned threadCount = 0)
+{
+    return inputFileToListParallel(inputList, fileName, threadCount, true);
+}
+
+/**
+ * @brief Reads the CSV line by line with getline and adds each row to the list.
+ *
+ * This is the original stream loader. It is kept as a reference for the
+ * mapped loader above (the benchmark compares the two) and for callers that
+ * need to read from something that cannot be memory-mapped.
+ *
+ * The file has a header, then each line has 6 pieces:
+ * ZIP, Place, State, County, Latitude, Longitude
+ *
  * @param inputList Where we store all the items.
  * @param fileName  The CSV file we open.
  *
@@ -49,7 +357,7 @@ using namespace std;
  *       this version won’t handle it.
  */
 
-void inputCSVtoList(PostalList &inputList, string fileName)
+void inputCSVtoListStream(PostalList &inputList, string fileName)
 {
     PostalCodeItem item;
     string line = "";
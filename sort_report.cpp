@@ -0,0 +1,112 @@
+/**
+ * @file sort_report.cpp
+ * @brief Prints the postal table in any column order, or only its first rows.
+ *
+ * @course CSCI 331 - Software Systems — Fall 2025
+ * @project Zip Code Group Project 1.0
+ *
+ * @details
+ * Loads a CSV or length-indicated file and prints it sorted by an ORDER BY
+ * list such as "county, place, lat desc" (see parseOrderBy()). With a limit
+ * only the first rows are sorted and printed. Files ending in ".txt" are
+ * read as the length-indicated format, everything else as CSV.
+ *
+ * Usage: sort_report "<order by>" [limit] [inputFile] [--stats[=json|prometheus]]
+ *
+ * @authors
+ *  - Tran, Minh Quan
+ *  - Asfaw, Abel
+ *  - Kariniemi, Carson
+ *  - Rogers, Mitchell
+ *  - Farah, Mahad
+ *
+ *
+ * @date Oct 16th 2025
+ * @version 1.0
+ * @bug None that we know of right now.
+ */
+
+#include <string>
+#include <vector>
+#include "PostalCodeItem.h"
+#include "PostalList.h"
+#include "OrderBy.h"
+#include "Metrics.h"
+#include "FieldScanner.h"
+#include "readCSV.cpp"
+
+using namespace std;
+
+/**
+ * @brief Loads the input and prints it in the requested order.
+ * @param argc Argument count.
+ * @param argv The ORDER BY list, then an optional row limit (0 = all rows)
+ * and input file; --stats anywhere writes timings to standard error.
+ * @return 0 on success, 1 for bad arguments or an empty input.
+ */
+int main(int argc, char *argv[])
+{
+    bool stats = false;
+    MetricsFormat statsFormat = MetricsFormat::JSON;
+    vector<string> args;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!parseStatsFlag(argv[i], statsFormat))
+        {
+            args.push_back(argv[i]);
+        }
+        else
+        {
+            stats = true;
+        }
+    }
+
+    vector<SortField> fields;
+    int limit = 0;
+    if (args.empty() || !parseOrderBy(args[0], fields) ||
+        (args.size() > 1 && (!parseInteger(args[1], limit) || limit < 0)))
+    {
+        cerr << "Usage: sort_report \"<column> [asc|desc], ...\" [limit] [inputFile] [--stats]" << endl;
+        cerr << "Columns: zip, place, state, county, lat, lon; limit: 0 (all rows) or more" << endl;
+        return 1;
+    }
+    string inputFile = (args.size() > 2) ? args[2] : "us_postal_codes.csv";
+    bool lengthIndicated = inputFile.size() >= 4 && inputFile.compare(inputFile.size() - 4, 4, ".txt") == 0;
+
+    PostalList list;
+    if (lengthIndicated)
+    {
+        inputLengthIndicatedToList(list, inputFile);
+    }
+    else
+    {
+        inputCSVtoList(list, inputFile);
+    }
+    if (list.size() == 0)
+    {
+        cerr << "Error: no records read from " << inputFile << endl;
+        return 1;
+    }
+
+    vector<uint32_t> rows;
+    ItemRange sorted = list.sortedBy(fields, rows, static_cast<size_t>(limit));
+
+    TableFormatter formatter(cout);
+    formatter.writeText("A table of the postal codes ordered by " + args[0] + ":\n\n");
+    formatter.writeHeader();
+    {
+        PhaseTimer timer(MetricPhase::Output);
+        for (const PostalCodeItem &item : sorted)
+        {
+            item.printInfo(formatter);
+            formatter.writeSeparator();
+        }
+    }
+    formatter.flush();
+
+    if (stats)
+    {
+        Metrics::write(cerr, statsFormat);
+    }
+    return 0;
+}